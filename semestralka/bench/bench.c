@@ -0,0 +1,540 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module bench.c
+
+    Benchmark harness of the parser, the evaluator and the PostScript
+    generator, built and run by "make bench".
+
+    Measured Stages:
+    - validate:   validate_expression(), ns per call
+    - compile:    compile_expression() and free_program(), ns per call
+    - evaluate:   evaluate_expression_range() on one thread, ns per
+                  sample, with the bytecode interpreter and native code
+    - postscript: generate_postscript_graph() of the evaluated samples,
+                  ns per file and output MB/s
+
+    Implementation Details:
+    - Times are taken with CLOCK_MONOTONIC
+    - Every measurement is preceded by warm-up runs, which also decide
+      how many calls one run makes so that short stages are not below
+      the clock resolution
+    - The median and the 99th percentile (nearest rank) of all runs are
+      reported, the p99 is the slow tail
+    - Results are written to stdout as one JSON document, errors to stderr
+
+    Options:
+    --repeat=N     - Timed runs per measurement (default 31)
+    --warmup=N     - Untimed runs before each measurement (default 3)
+    --samples=N,.. - Sample counts of evaluate and postscript
+                     (default 1000,10000,100000)
+    --expr=EXPR    - Benchmark EXPR instead of the built-in corpus, may
+                     be given several times
+    --output=FILE  - Scratch PostScript file (default bench.ps), removed
+                     at the end
+
+    Dialect: ANSI C with POSIX clocks
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#define _POSIX_C_SOURCE 199309L  /* clock_gettime() */
+
+#include <time.h>         /* Monotonic clock */
+#include "parser.h"       /* Validation and compilation */
+#include "evaluator.h"    /* Range evaluation */
+#include "jit.h"          /* Native code */
+#include "postscript.h"   /* Graph generation */
+
+/* Limits of the command line */
+#define BENCH_MAX_EXPRS   32
+#define BENCH_MAX_SIZES   16
+#define BENCH_MAX_REPEAT  10001
+
+/* Shortest timed run in nanoseconds, shorter stages are batched */
+#define BENCH_MIN_RUN_NS  200000.0
+
+/* Plotted range of x */
+#define BENCH_MIN_X -10.0
+#define BENCH_MAX_X 10.0
+
+/* Representative expressions: trivial, polynomial, transcendental,
+   with poles and with undefined parts */
+static const char *const default_corpus[] = {
+    "x",
+    "x^3-2*x^2+x-1",
+    "((((x-1)*x+2)*x-3)*x+4)*x-5",
+    "sin(x)",
+    "sin(x)*cos(x)+exp(-x^2/10)",
+    "sin(x)^2+cos(x)^2+sinh(x/10)*cosh(x/10)",
+    "tan(x)",
+    "log(abs(x))+atan(x)",
+    "ln(x)*asin(x/10)"
+};
+
+/* Default sample counts */
+static const int default_sizes[] = { 1000, 10000, 100000 };
+
+/*
+  Benchmark state
+  Everything the stages need, a stage is one call of the measured code.
+*/
+typedef struct {
+    const char *expr;        /* Expression */
+    Program program;         /* Compiled expression */
+    int num_points;          /* Samples of evaluate and postscript */
+    double *values;          /* Evaluated samples */
+    char *defined;           /* Definition flags of the samples */
+    const char *output;      /* Scratch PostScript file */
+    int failed;              /* Nonzero after a failed call */
+} BenchState;
+
+/* One call of measured code */
+typedef void (*BenchStage)(BenchState *state);
+
+/*
+  Measurement
+  Statistics of all timed runs of one stage, per call.
+*/
+typedef struct {
+    double median;           /* Median time in ns */
+    double p99;              /* 99th percentile time in ns */
+    long batch;              /* Calls per timed run */
+} BenchTiming;
+
+/* Internal function prototypes */
+static double now_ns(void);
+static int compare_doubles(const void *a, const void *b);
+static int measure(BenchStage stage, BenchState *state, int warmup,
+                   int repeat, BenchTiming *timing);
+static void stage_validate(BenchState *state);
+static void stage_compile(BenchState *state);
+static void stage_evaluate(BenchState *state);
+static void stage_postscript(BenchState *state);
+static long file_size(const char *path);
+static void print_string(const char *text);
+static void print_result(int *first, const char *expr, const char *stage,
+                         const char *backend, int num_points,
+                         const char *unit, double scale,
+                         const BenchTiming *timing, int repeat);
+static int parse_sizes(const char *text, int *sizes, int *num_sizes);
+static int parse_count(const char *text, int min, int max, int *value);
+
+/* ____________________________________________________________________________
+
+    MAIN PROGRAM
+   ____________________________________________________________________________
+*/
+
+int main(int argc, char *argv[]) {
+    const char *exprs[BENCH_MAX_EXPRS];
+    int sizes[BENCH_MAX_SIZES];
+    int num_exprs = 0, num_sizes = 0, max_size = 0;
+    int repeat = 31, warmup = 3;
+    int first = 1, result = 0;
+    BenchState state;
+    BenchTiming timing;
+    int e, s, k;
+
+    memset(&state, 0, sizeof(state));
+    state.output = "bench.ps";
+
+    for (k = 1; k < argc; k++) {
+        if (strncmp(argv[k], "--repeat=", 9) == 0) {
+            if (!parse_count(argv[k] + 9, 1, BENCH_MAX_REPEAT, &repeat)) {
+                fprintf(stderr, "Error: Invalid number of runs (1 to %d)\n",
+                        BENCH_MAX_REPEAT);
+                return 1;
+            }
+        } else if (strncmp(argv[k], "--warmup=", 9) == 0) {
+            if (!parse_count(argv[k] + 9, 1, BENCH_MAX_REPEAT, &warmup)) {
+                fprintf(stderr, "Error: Invalid number of warm-up runs (1 to %d)\n",
+                        BENCH_MAX_REPEAT);
+                return 1;
+            }
+        } else if (strncmp(argv[k], "--samples=", 10) == 0) {
+            if (!parse_sizes(argv[k] + 10, sizes, &num_sizes)) {
+                fprintf(stderr, "Error: Invalid sample counts '%s'\n", argv[k] + 10);
+                return 1;
+            }
+        } else if (strncmp(argv[k], "--expr=", 7) == 0) {
+            if (num_exprs == BENCH_MAX_EXPRS) {
+                fprintf(stderr, "Error: Too many expressions (at most %d)\n",
+                        BENCH_MAX_EXPRS);
+                return 1;
+            }
+            exprs[num_exprs++] = argv[k] + 7;
+        } else if (strncmp(argv[k], "--output=", 9) == 0 && argv[k][9] != '\0') {
+            state.output = argv[k] + 9;
+        } else {
+            fprintf(stderr, "Usage: %s [--repeat=N] [--warmup=N] [--samples=N,...] [--expr=EXPR]... [--output=FILE]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (num_exprs == 0) {
+        num_exprs = (int)(sizeof(default_corpus) / sizeof(default_corpus[0]));
+        memcpy(exprs, default_corpus, sizeof(default_corpus));
+    }
+    if (num_sizes == 0) {
+        num_sizes = (int)(sizeof(default_sizes) / sizeof(default_sizes[0]));
+        memcpy(sizes, default_sizes, sizeof(default_sizes));
+    }
+    for (s = 0; s < num_sizes; s++) {
+        if (sizes[s] > max_size) {
+            max_size = sizes[s];
+        }
+    }
+
+    state.values = malloc((size_t)max_size * sizeof(double));
+    state.defined = malloc((size_t)max_size);
+    if (!state.values || !state.defined) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        free(state.values);
+        free(state.defined);
+        return 5;
+    }
+
+    printf("{\n  \"benchmark\": \"semestralka\",\n");
+    printf("  \"clock\": \"CLOCK_MONOTONIC\",\n");
+    printf("  \"repeat\": %d,\n  \"warmup\": %d,\n", repeat, warmup);
+    printf("  \"range\": [%g, %g],\n", BENCH_MIN_X, BENCH_MAX_X);
+    printf("  \"results\": [");
+
+    for (e = 0; e < num_exprs && result == 0; e++) {
+        ParserError error;
+        int native;
+
+        state.expr = exprs[e];
+        state.failed = 0;
+        fprintf(stderr, "Benchmarking %s\n", state.expr);
+
+        error = compile_expression(state.expr, &state.program);
+        if (!validate_expression(state.expr) || error != PARSER_OK) {
+            fprintf(stderr, "Error: Invalid expression '%s'.\n", state.expr);
+            if (error == PARSER_OK) {
+                free_program(&state.program);
+            }
+            result = 2;
+            break;
+        }
+
+        if (measure(stage_validate, &state, warmup, repeat, &timing)) {
+            print_result(&first, state.expr, "validate", NULL, 0,
+                         "ns/call", 1.0, &timing, repeat);
+        }
+        if (measure(stage_compile, &state, warmup, repeat, &timing)) {
+            print_result(&first, state.expr, "compile", NULL, 0,
+                         "ns/call", 1.0, &timing, repeat);
+        }
+
+        /* Bytecode first, then the same program with native code */
+        for (native = 0; native <= 1 && !state.failed; native++) {
+            if (native && !jit_compile(&state.program)) {
+                break;
+            }
+            for (s = 0; s < num_sizes; s++) {
+                state.num_points = sizes[s];
+                if (measure(stage_evaluate, &state, warmup, repeat, &timing)) {
+                    print_result(&first, state.expr, "evaluate",
+                                 native ? "native" : "bytecode", sizes[s],
+                                 "ns/sample", 1.0 / sizes[s], &timing, repeat);
+                }
+            }
+        }
+
+        /* Files of the largest sample counts dominate, one per run */
+        for (s = 0; s < num_sizes && !state.failed; s++) {
+            long bytes;
+
+            state.num_points = sizes[s];
+            stage_evaluate(&state);
+            if (!measure(stage_postscript, &state, warmup, repeat, &timing)) {
+                break;
+            }
+            bytes = file_size(state.output);
+            print_result(&first, state.expr, "postscript", NULL, sizes[s],
+                         "ns/file", 1.0, &timing, repeat);
+            printf(",\n      \"bytes\": %ld,\n      \"mb_per_s\": %.3f\n    }",
+                   bytes, bytes > 0 ? bytes * 1e3 / timing.median : 0.0);
+        }
+
+        free_program(&state.program);
+        if (state.failed) {
+            fprintf(stderr, "Error: Benchmark of '%s' failed.\n", state.expr);
+            result = 6;
+        }
+    }
+
+    printf("\n  ]\n}\n");
+
+    remove(state.output);
+    free(state.values);
+    free(state.defined);
+    return result;
+}
+
+/* ____________________________________________________________________________
+    static double now_ns(void)
+
+    Returns the monotonic clock in nanoseconds.
+   ____________________________________________________________________________
+*/
+static double now_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/* ____________________________________________________________________________
+    static int compare_doubles(const void *a, const void *b)
+
+    Orders doubles ascending for qsort().
+   ____________________________________________________________________________
+*/
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* ____________________________________________________________________________
+    static int measure(BenchStage stage, BenchState *state, int warmup,
+                       int repeat, BenchTiming *timing)
+
+    Times repeat runs of a stage after warmup untimed ones.
+
+    Processing Steps:
+    - Run the stage warmup times and take the mean call time
+    - Batch as many calls per run as fit into BENCH_MIN_RUN_NS
+    - Time every run, sort the per call times and pick the statistics
+
+    Returns:
+    int - 1 on success, 0 if the stage failed or memory ran out
+   ____________________________________________________________________________
+*/
+static int measure(BenchStage stage, BenchState *state, int warmup,
+                   int repeat, BenchTiming *timing) {
+    double *times = malloc((size_t)repeat * sizeof(double));
+    double start, elapsed;
+    long batch, i;
+    int r;
+
+    if (!times) {
+        state->failed = 1;
+        return 0;
+    }
+
+    start = now_ns();
+    for (r = 0; r < warmup; r++) {
+        stage(state);
+    }
+    elapsed = (now_ns() - start) / warmup;
+    batch = (elapsed > 0 && elapsed < BENCH_MIN_RUN_NS) ?
+            (long)(BENCH_MIN_RUN_NS / elapsed) + 1 : 1;
+
+    for (r = 0; r < repeat && !state->failed; r++) {
+        start = now_ns();
+        for (i = 0; i < batch; i++) {
+            stage(state);
+        }
+        times[r] = (now_ns() - start) / batch;
+    }
+    if (state->failed) {
+        free(times);
+        return 0;
+    }
+
+    qsort(times, (size_t)repeat, sizeof(double), compare_doubles);
+    timing->median = (repeat % 2) ? times[repeat / 2] :
+                     (times[repeat / 2 - 1] + times[repeat / 2]) / 2;
+    timing->p99 = times[(99 * repeat + 99) / 100 - 1];
+    timing->batch = batch;
+
+    free(times);
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    Stages
+
+    Each stage performs one call of the measured code and records
+    failures in the state, results are otherwise ignored.
+   ____________________________________________________________________________
+*/
+static void stage_validate(BenchState *state) {
+    if (!validate_expression(state->expr)) {
+        state->failed = 1;
+    }
+}
+
+static void stage_compile(BenchState *state) {
+    Program program;
+
+    if (compile_expression(state->expr, &program) != PARSER_OK) {
+        state->failed = 1;
+        return;
+    }
+    free_program(&program);
+}
+
+static void stage_evaluate(BenchState *state) {
+    if (!evaluate_expression_range(&state->program, BENCH_MIN_X, BENCH_MAX_X,
+                                   state->num_points, state->values,
+                                   state->defined)) {
+        state->failed = 1;
+    }
+}
+
+static void stage_postscript(BenchState *state) {
+    GraphSeries series;
+    GraphParams params;
+
+    memset(&series, 0, sizeof(series));
+    set_default_series_style(&series, 0);
+    series.points = state->values;
+    series.stride = 1;
+
+    memset(&params, 0, sizeof(params));
+    params.min_x = BENCH_MIN_X;
+    params.max_x = BENCH_MAX_X;
+    params.min_y = BENCH_MIN_X;
+    params.max_y = BENCH_MAX_X;
+    params.width = 512;
+    params.height = 512;
+    params.x_divisions = 10;
+    params.y_divisions = 10;
+    params.series = &series;
+    params.num_series = 1;
+    params.num_points = state->num_points;
+    params.tolerance = PS_DEFAULT_TOLERANCE;
+
+    if (generate_postscript_graph(&params, state->output) != 0) {
+        state->failed = 1;
+    }
+}
+
+/* ____________________________________________________________________________
+    static long file_size(const char *path)
+
+    Returns the size of a file in bytes, -1 if it cannot be read.
+   ____________________________________________________________________________
+*/
+static long file_size(const char *path) {
+    FILE *file = fopen(path, "rb");
+    long size = -1;
+
+    if (file) {
+        if (fseek(file, 0, SEEK_END) == 0) {
+            size = ftell(file);
+        }
+        fclose(file);
+    }
+    return size;
+}
+
+/* ____________________________________________________________________________
+    static void print_string(const char *text)
+
+    Writes a JSON string literal.
+   ____________________________________________________________________________
+*/
+static void print_string(const char *text) {
+    putchar('"');
+    for (; *text != '\0'; text++) {
+        if (*text == '"' || *text == '\\') {
+            printf("\\%c", *text);
+        } else if ((unsigned char)*text < 0x20) {
+            printf("\\u%04x", (unsigned char)*text);
+        } else {
+            putchar(*text);
+        }
+    }
+    putchar('"');
+}
+
+/* ____________________________________________________________________________
+    static void print_result(int *first, const char *expr, const char *stage,
+                             const char *backend, int num_points,
+                             const char *unit, double scale,
+                             const BenchTiming *timing, int repeat)
+
+    Writes one result object, times are multiplied by scale. The object
+    is left open, the caller closes it with "\n    }" or adds members.
+   ____________________________________________________________________________
+*/
+static void print_result(int *first, const char *expr, const char *stage,
+                         const char *backend, int num_points,
+                         const char *unit, double scale,
+                         const BenchTiming *timing, int repeat) {
+    printf("%s\n    {\n      \"expression\": ", *first ? "" : ",");
+    print_string(expr);
+    printf(",\n      \"stage\": \"%s\",\n", stage);
+    if (backend) {
+        printf("      \"backend\": \"%s\",\n", backend);
+    }
+    if (num_points > 0) {
+        printf("      \"samples\": %d,\n", num_points);
+    }
+    printf("      \"unit\": \"%s\",\n", unit);
+    printf("      \"median\": %.3f,\n      \"p99\": %.3f,\n",
+           timing->median * scale, timing->p99 * scale);
+    printf("      \"runs\": %d,\n      \"batch\": %ld", repeat, timing->batch);
+    if (strcmp(stage, "postscript") != 0) {
+        printf("\n    }");
+    }
+    *first = 0;
+}
+
+/* ____________________________________________________________________________
+    static int parse_sizes(const char *text, int *sizes, int *num_sizes)
+
+    Parses a comma separated list of sample counts.
+   ____________________________________________________________________________
+*/
+static int parse_sizes(const char *text, int *sizes, int *num_sizes) {
+    *num_sizes = 0;
+
+    for (;;) {
+        char field[32];
+        const char *comma = strchr(text, ',');
+        size_t length = comma ? (size_t)(comma - text) : strlen(text);
+
+        if (length == 0 || length >= sizeof(field) ||
+            *num_sizes == BENCH_MAX_SIZES) {
+            return 0;
+        }
+        memcpy(field, text, length);
+        field[length] = '\0';
+        if (!parse_count(field, 2, 100000000, &sizes[*num_sizes])) {
+            return 0;
+        }
+        (*num_sizes)++;
+
+        if (!comma) {
+            return 1;
+        }
+        text = comma + 1;
+    }
+}
+
+/* ____________________________________________________________________________
+    static int parse_count(const char *text, int min, int max, int *value)
+
+    Parses a whole number from min to max.
+   ____________________________________________________________________________
+*/
+static int parse_count(const char *text, int min, int max, int *value) {
+    char *end;
+    long number = strtol(text, &end, 10);
+
+    if (end == text || *end != '\0' || number < min || number > max) {
+        return 0;
+    }
+    *value = (int)number;
+    return 1;
+}
@@ -0,0 +1,1325 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module ast.c
+
+    Expression tree construction, optimization and bytecode emission.
+
+    Implementation Details:
+    - Nodes are allocated individually and owned by their parent
+    - Optimization is a single bottom-up pass, children are simplified
+      before the rules for their parent are tried
+    - Constant folding uses apply_unary() and apply_binary(), so folded
+      values are identical to the ones computed at run time
+    - Derivatives are built as new trees by the rules of differentiation,
+      they are simplified by the same optimizer as parsed expressions
+    - Shared subexpressions are found by hash-based value numbering
+    - Polynomials in x are collected into coefficient arrays after all
+      other rewrites, when no further rule has to look inside them
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#include "ast.h"
+
+/*
+  Subexpression class
+  All structurally equal subtrees share one class. Classes are keyed by
+  the node content and the classes of the operands (value numbering).
+*/
+typedef struct {
+    OpCode opcode;      /* Node kind */
+    int index;          /* Registry index */
+    double value;       /* Constant value */
+    const double *coefficients; /* Polynomial coefficients, NULL if none */
+    int left, right;    /* Operand classes, -1 if none */
+    int visits;         /* Times the emitter reaches the class */
+    int slot;           /* Slot holding the value, -1 if recomputed */
+    int computed;       /* Nonzero once the value is in its slot */
+} SubexprClass;
+
+/*
+  Emitter context
+  Program being generated, the simulated evaluation stack depth and the
+  subexpression classes of the emitted trees.
+*/
+typedef struct {
+    Program *prog;            /* Program receiving the instructions */
+    int depth;                /* Current evaluation stack depth */
+    ParserError error;        /* First error encountered */
+    SubexprClass *classes;    /* Classes in order of creation */
+    int num_classes;          /* Number of classes */
+    int *table;               /* Hash table of class indices + 1 */
+    unsigned table_size;      /* Size of the table, a power of two */
+} Emitter;
+
+/*
+  Hoisting context
+  Subtrees moved out of the trees by ast_hoist_invariant().
+*/
+typedef struct {
+    unsigned varying;         /* Variables that change between runs */
+    ExprNode **hoisted;       /* Moved subtrees, index = column */
+    int max_hoisted;          /* Capacity of hoisted */
+    int count;                /* Number of moved subtrees */
+} Hoister;
+
+/* Internal function prototypes */
+static ExprNode *new_node(OpCode opcode);
+static int is_constant(const ExprNode *node, double value);
+static ExprNode *replace_by_child(ExprNode *node, ExprNode *child);
+static ExprNode *fold_constant(ExprNode *node);
+static int contains_x(const ExprNode *node);
+static ExprNode *polynomial_node(const double *coefficients, int degree,
+                                 ExprNode *operand);
+static int has_power(const ExprNode *node);
+static int polynomial_terms(const ExprNode *node, double scale,
+                            double *coefficients, int *degree);
+static int monomial(const ExprNode *node, double *factor, int *power);
+static ExprNode *derive(const ExprNode *node, ParserError *error);
+static ExprNode *builtin(OpCode opcode, ExprNode *operand);
+static ExprNode *d_add(ExprNode *a, ExprNode *b);
+static ExprNode *d_sub(ExprNode *a, ExprNode *b);
+static ExprNode *d_mul(ExprNode *a, ExprNode *b);
+static ExprNode *d_div(ExprNode *a, ExprNode *b);
+static ExprNode *d_neg(ExprNode *a);
+static ExprNode *hoist(Hoister *h, ExprNode *node);
+static unsigned variables_read(const ExprNode *node);
+static int same_tree(const ExprNode *a, const ExprNode *b);
+static int count_nodes(const ExprNode *node);
+static int number_node(Emitter *e, ExprNode *node);
+static void count_visits(Emitter *e, const ExprNode *node);
+static void emit_node(Emitter *e, const ExprNode *node);
+static void emit(Emitter *e, OpCode opcode, int operand);
+static int add_constant(Emitter *e, double value);
+static void emit_constant(Emitter *e, double value);
+
+/* ____________________________________________________________________________
+    int opcode_arity(OpCode opcode)
+
+    Classifies opcodes by the number of operands they consume.
+   ____________________________________________________________________________
+*/
+int opcode_arity(OpCode opcode) {
+    switch (opcode) {
+        case OP_CONST:
+        case OP_X:
+        case OP_VAR:
+        case OP_LOAD:
+        case OP_COLUMN:
+            return 0;
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+        case OP_POW:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *new_node(OpCode opcode)
+
+    Allocates a node without operands.
+   ____________________________________________________________________________
+*/
+static ExprNode *new_node(OpCode opcode) {
+    ExprNode *node = malloc(sizeof(ExprNode));
+    if (!node) {
+        return NULL;
+    }
+
+    node->opcode = opcode;
+    node->index = 0;
+    node->value = 0;
+    node->coefficients = NULL;
+    node->left = NULL;
+    node->right = NULL;
+    node->id = -1;
+    return node;
+}
+
+/* ____________________________________________________________________________
+    Node constructors
+
+    Implementation Notes:
+    - Operands are released when the node cannot be completed, so
+      callers can nest constructor calls without checking each one
+   ____________________________________________________________________________
+*/
+ExprNode *ast_constant(double value) {
+    ExprNode *node = new_node(OP_CONST);
+    if (node) {
+        node->value = value;
+    }
+    return node;
+}
+
+ExprNode *ast_variable(void) {
+    return new_node(OP_X);
+}
+
+ExprNode *ast_named_variable(int slot) {
+    ExprNode *node = new_node(OP_VAR);
+    if (node) {
+        node->index = slot;
+    }
+    return node;
+}
+
+ExprNode *ast_unary(OpCode opcode, int index, ExprNode *operand) {
+    ExprNode *node;
+
+    if (!operand) {
+        return NULL;
+    }
+
+    node = new_node(opcode);
+    if (!node) {
+        ast_free(operand);
+        return NULL;
+    }
+
+    node->index = index;
+    node->left = operand;
+    return node;
+}
+
+ExprNode *ast_binary(OpCode opcode, ExprNode *left, ExprNode *right) {
+    ExprNode *node;
+
+    if (!left || !right) {
+        ast_free(left);
+        ast_free(right);
+        return NULL;
+    }
+
+    node = new_node(opcode);
+    if (!node) {
+        ast_free(left);
+        ast_free(right);
+        return NULL;
+    }
+
+    node->left = left;
+    node->right = right;
+    return node;
+}
+
+/* ____________________________________________________________________________
+    ExprNode *ast_copy(const ExprNode *node)
+
+    Duplicates a tree node by node.
+   ____________________________________________________________________________
+*/
+ExprNode *ast_copy(const ExprNode *node) {
+    ExprNode *copy;
+
+    if (!node) {
+        return NULL;
+    }
+
+    copy = new_node(node->opcode);
+    if (!copy) {
+        return NULL;
+    }
+    copy->index = node->index;
+    copy->value = node->value;
+
+    if (node->coefficients) {
+        size_t size = (node->index + 1) * sizeof(double);
+        copy->coefficients = malloc(size);
+        if (!copy->coefficients) {
+            ast_free(copy);
+            return NULL;
+        }
+        memcpy(copy->coefficients, node->coefficients, size);
+    }
+
+    if (node->left) {
+        copy->left = ast_copy(node->left);
+        if (!copy->left) {
+            ast_free(copy);
+            return NULL;
+        }
+    }
+    if (node->right) {
+        copy->right = ast_copy(node->right);
+        if (!copy->right) {
+            ast_free(copy);
+            return NULL;
+        }
+    }
+
+    return copy;
+}
+
+/* ____________________________________________________________________________
+    void ast_free(ExprNode *node)
+
+    Releases a node and both of its subtrees.
+   ____________________________________________________________________________
+*/
+void ast_free(ExprNode *node) {
+    if (!node) {
+        return;
+    }
+
+    ast_free(node->left);
+    ast_free(node->right);
+    free(node->coefficients);
+    free(node);
+}
+
+/* ____________________________________________________________________________
+    static int is_constant(const ExprNode *node, double value)
+
+    Checks whether a node is a constant leaf with the given value.
+   ____________________________________________________________________________
+*/
+static int is_constant(const ExprNode *node, double value) {
+    return node->opcode == OP_CONST && node->value == value;
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *replace_by_child(ExprNode *node, ExprNode *child)
+
+    Detaches one operand of a node, releases the rest of the node and
+    returns the operand in its place.
+   ____________________________________________________________________________
+*/
+static ExprNode *replace_by_child(ExprNode *node, ExprNode *child) {
+    if (node->left == child) {
+        node->left = NULL;
+    } else {
+        node->right = NULL;
+    }
+
+    ast_free(node);
+    return child;
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *fold_constant(ExprNode *node)
+
+    Replaces an operator whose operands are all constants by its value.
+    Undefined results are folded to NaN, exactly what the operator would
+    produce for every sample at run time.
+   ____________________________________________________________________________
+*/
+static ExprNode *fold_constant(ExprNode *node) {
+    double value;
+
+    switch (opcode_arity(node->opcode)) {
+        case 2:
+            value = apply_binary(node->opcode, node->left->value, node->right->value);
+            break;
+        case 1:
+            if (node->opcode == OP_CALL) {
+                value = get_registered_function(node->index)(node->left->value);
+            } else {
+                value = apply_unary(node->opcode, node->left->value);
+            }
+            break;
+        default:
+            return node;
+    }
+
+    ast_free(node->left);
+    ast_free(node->right);
+    node->opcode = OP_CONST;
+    node->index = 0;
+    node->value = value;
+    node->left = NULL;
+    node->right = NULL;
+    return node;
+}
+
+/* ____________________________________________________________________________
+    ExprNode *ast_optimize(ExprNode *node)
+
+    Bottom-up simplification of a tree.
+
+    Optimization Strategy:
+    - Optimize the operands first
+    - Fold the node if all operands became constants
+    - Otherwise try the algebraic rewrites for the node's operator
+   ____________________________________________________________________________
+*/
+ExprNode *ast_optimize(ExprNode *node) {
+    ExprNode *left, *right;
+    int arity;
+
+    if (!node) {
+        return NULL;
+    }
+
+    arity = opcode_arity(node->opcode);
+    if (arity == 0) {
+        return node;
+    }
+
+    node->left = ast_optimize(node->left);
+    if (arity == 2) {
+        node->right = ast_optimize(node->right);
+    }
+    left = node->left;
+    right = node->right;
+
+    /* Constant folding, x-independent subtrees become one constant */
+    if (left->opcode == OP_CONST && (arity == 1 || right->opcode == OP_CONST)) {
+        return fold_constant(node);
+    }
+
+    switch (node->opcode) {
+        case OP_ADD:
+            if (is_constant(right, 0)) return replace_by_child(node, left);
+            if (is_constant(left, 0)) return replace_by_child(node, right);
+            if (right->opcode == OP_NEG) {
+                /* e + (-f) = e - f */
+                node->opcode = OP_SUB;
+                node->right = replace_by_child(right, right->left);
+            }
+            break;
+
+        case OP_SUB:
+            if (is_constant(right, 0)) return replace_by_child(node, left);
+            if (is_constant(left, 0)) {
+                /* 0 - e = -e */
+                ast_free(left);
+                node->opcode = OP_NEG;
+                node->left = right;
+                node->right = NULL;
+                return ast_optimize(node);
+            }
+            if (right->opcode == OP_NEG) {
+                /* e - (-f) = e + f */
+                node->opcode = OP_ADD;
+                node->right = replace_by_child(right, right->left);
+            }
+            break;
+
+        case OP_MUL:
+            if (is_constant(right, 1)) return replace_by_child(node, left);
+            if (is_constant(left, 1)) return replace_by_child(node, right);
+            break;
+
+        case OP_DIV:
+            if (is_constant(right, 1)) return replace_by_child(node, left);
+            break;
+
+        case OP_POW:
+            if (is_constant(right, 1)) return replace_by_child(node, left);
+            if (is_constant(right, 2)) {
+                /* e^2 = e*e, pow() gives the same correctly rounded value */
+                ast_free(right);
+                node->opcode = OP_SQUARE;
+                node->right = NULL;
+            }
+            break;
+
+        case OP_NEG:
+            /* -(-e) = e */
+            if (left->opcode == OP_NEG) {
+                ExprNode *inner = left->left;
+                left->left = NULL;
+                ast_free(node);
+                return inner;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return node;
+}
+
+/* ____________________________________________________________________________
+    ExprNode *ast_polynomials(ExprNode *node)
+
+    Replaces polynomial subtrees, largest first.
+
+    Search Strategy:
+    - Try to collect the whole subtree as a polynomial
+    - Only if that fails, descend into the operands
+   ____________________________________________________________________________
+*/
+ExprNode *ast_polynomials(ExprNode *node) {
+    double coefficients[AST_MAX_DEGREE + 1];
+    int degree = 0;
+    int k;
+
+    if (!node || opcode_arity(node->opcode) == 0) {
+        return node;
+    }
+
+    for (k = 0; k <= AST_MAX_DEGREE; k++) {
+        coefficients[k] = 0;
+    }
+
+    if ((has_power(node) || count_nodes(node) > 3) &&
+        polynomial_terms(node, 1, coefficients, &degree)) {
+        /* Terms that cancel out do not raise the degree */
+        while (degree > 0 && coefficients[degree] == 0) {
+            degree--;
+        }
+
+        if (degree >= 1) {
+            double highest_first[AST_MAX_DEGREE + 1];
+            ExprNode *polynomial;
+
+            for (k = 0; k <= degree; k++) {
+                highest_first[k] = coefficients[degree - k];
+            }
+            polynomial = polynomial_node(highest_first, degree, ast_variable());
+            if (polynomial) {
+                ast_free(node);
+                return polynomial;
+            }
+        }
+    }
+
+    node->left = ast_polynomials(node->left);
+    if (node->right) {
+        node->right = ast_polynomials(node->right);
+    }
+    return node;
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *polynomial_node(const double *coefficients, int degree,
+                                     ExprNode *operand)
+
+    Creates an OP_POLY node with a copy of the coefficients, highest
+    power first. Takes ownership of the operand like ast_unary().
+   ____________________________________________________________________________
+*/
+static ExprNode *polynomial_node(const double *coefficients, int degree,
+                                 ExprNode *operand) {
+    ExprNode *node = ast_unary(OP_POLY, degree, operand);
+
+    if (!node) {
+        return NULL;
+    }
+
+    node->coefficients = malloc((degree + 1) * sizeof(double));
+    if (!node->coefficients) {
+        ast_free(node);
+        return NULL;
+    }
+    memcpy(node->coefficients, coefficients, (degree + 1) * sizeof(double));
+    return node;
+}
+
+/* ____________________________________________________________________________
+    static int has_power(const ExprNode *node)
+
+    Checks whether a tree contains a power operator.
+   ____________________________________________________________________________
+*/
+static int has_power(const ExprNode *node) {
+    if (!node) {
+        return 0;
+    }
+    if (node->opcode == OP_POW) {
+        return 1;
+    }
+
+    return has_power(node->left) || has_power(node->right);
+}
+
+/* ____________________________________________________________________________
+    static int polynomial_terms(const ExprNode *node, double scale,
+                                double *coefficients, int *degree)
+
+    Adds scale times the terms of a sum of monomials to the coefficients,
+    lowest power first, and raises the degree to the highest power seen.
+    Returns 0 if the tree is not such a sum.
+   ____________________________________________________________________________
+*/
+static int polynomial_terms(const ExprNode *node, double scale,
+                            double *coefficients, int *degree) {
+    double factor;
+    int power;
+
+    switch (node->opcode) {
+        case OP_ADD:
+            return polynomial_terms(node->left, scale, coefficients, degree) &&
+                   polynomial_terms(node->right, scale, coefficients, degree);
+        case OP_SUB:
+            return polynomial_terms(node->left, scale, coefficients, degree) &&
+                   polynomial_terms(node->right, -scale, coefficients, degree);
+        case OP_NEG:
+            return polynomial_terms(node->left, -scale, coefficients, degree);
+        default:
+            if (!monomial(node, &factor, &power)) {
+                return 0;
+            }
+            coefficients[power] += scale * factor;
+            if (power > *degree) {
+                *degree = power;
+            }
+            return 1;
+    }
+}
+
+/* ____________________________________________________________________________
+    static int monomial(const ExprNode *node, double *factor, int *power)
+
+    Recognizes factor * x^power, returns 0 for other trees, exponents
+    that are not integers and powers above AST_MAX_DEGREE.
+   ____________________________________________________________________________
+*/
+static int monomial(const ExprNode *node, double *factor, int *power) {
+    double other_factor, exponent;
+    int other_power;
+
+    switch (node->opcode) {
+        case OP_CONST:
+            if (node->value != node->value || fabs(node->value) == HUGE_VAL) {
+                return 0;
+            }
+            *factor = node->value;
+            *power = 0;
+            return 1;
+        case OP_X:
+            *factor = 1;
+            *power = 1;
+            return 1;
+        case OP_NEG:
+            if (!monomial(node->left, factor, power)) {
+                return 0;
+            }
+            *factor = -*factor;
+            return 1;
+        case OP_SQUARE:
+            if (!monomial(node->left, factor, power) ||
+                *power * 2 > AST_MAX_DEGREE) {
+                return 0;
+            }
+            *factor *= *factor;
+            *power *= 2;
+            return 1;
+        case OP_POW:
+            exponent = node->right->opcode == OP_CONST ? node->right->value : -1;
+            if (exponent < 0 || exponent > AST_MAX_DEGREE ||
+                exponent != floor(exponent) ||
+                !monomial(node->left, factor, power) ||
+                *power * (int)exponent > AST_MAX_DEGREE) {
+                return 0;
+            }
+            *factor = pow(*factor, exponent);
+            *power *= (int)exponent;
+            return 1;
+        case OP_MUL:
+            if (!monomial(node->left, factor, power) ||
+                !monomial(node->right, &other_factor, &other_power) ||
+                *power + other_power > AST_MAX_DEGREE) {
+                return 0;
+            }
+            *factor *= other_factor;
+            *power += other_power;
+            return 1;
+        case OP_DIV:
+            if (node->right->opcode != OP_CONST || node->right->value == 0 ||
+                !monomial(node->left, factor, power) ||
+                !monomial(node->right, &other_factor, &other_power)) {
+                return 0;
+            }
+            *factor /= other_factor;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* ____________________________________________________________________________
+    ParserError ast_derivative(const ExprNode *node, ExprNode **result)
+
+    Builds the derivative of a tree with respect to x.
+   ____________________________________________________________________________
+*/
+ParserError ast_derivative(const ExprNode *node, ExprNode **result) {
+    ParserError error = PARSER_OK;
+
+    if (!node || !result) {
+        return PARSER_ERROR_INVALID_INPUT;
+    }
+
+    *result = derive(node, &error);
+    if (!*result) {
+        return (error != PARSER_OK) ? error : PARSER_ERROR_MEMORY;
+    }
+
+    *result = ast_optimize(*result);
+    return PARSER_OK;
+}
+
+/* ____________________________________________________________________________
+    static int contains_x(const ExprNode *node)
+
+    Checks whether a tree depends on x.
+   ____________________________________________________________________________
+*/
+static int contains_x(const ExprNode *node) {
+    if (!node) {
+        return 0;
+    }
+    if (node->opcode == OP_X) {
+        return 1;
+    }
+
+    return contains_x(node->left) || contains_x(node->right);
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *derive(const ExprNode *node, ParserError *error)
+
+    Returns a new tree with the derivative of a node, NULL on failure.
+
+    Differentiation Rules:
+    - Subtrees without x have derivative 0, x has derivative 1; other
+      variables are held constant, giving the partial derivative in x
+    - Sum, product and quotient rules for the arithmetic operators
+    - u^c with constant c gives c*u^(c-1)*u', a^v with constant a gives
+      a^v*ln(a)*v', other powers u^v*(v'*ln(u) + v*u'/u)
+    - Chain rule for all built-in functions
+
+    Implementation Notes:
+    - Derivatives of ln and log are defined for negative arguments,
+      0*f is added so they stay undefined where f itself is
+    - Registered functions have no known derivative, error is set to
+      PARSER_ERROR_NOT_DIFFERENTIABLE
+   ____________________________________________________________________________
+*/
+static ExprNode *derive(const ExprNode *node, ParserError *error) {
+    const ExprNode *u = node->left;
+    const ExprNode *v = node->right;
+
+    if (!contains_x(node)) {
+        return ast_constant(0);
+    }
+
+    switch (node->opcode) {
+        case OP_X:
+            return ast_constant(1);
+        case OP_ADD:
+            return d_add(derive(u, error), derive(v, error));
+        case OP_SUB:
+            return d_sub(derive(u, error), derive(v, error));
+        case OP_MUL:
+            return d_add(d_mul(derive(u, error), ast_copy(v)),
+                         d_mul(ast_copy(u), derive(v, error)));
+        case OP_DIV:
+            return d_div(d_sub(d_mul(derive(u, error), ast_copy(v)),
+                               d_mul(ast_copy(u), derive(v, error))),
+                         ast_unary(OP_SQUARE, 0, ast_copy(v)));
+        case OP_POW:
+            if (v->opcode == OP_CONST) {
+                return d_mul(d_mul(ast_constant(v->value),
+                                   ast_binary(OP_POW, ast_copy(u),
+                                              ast_constant(v->value - 1))),
+                             derive(u, error));
+            }
+            if (!contains_x(u)) {
+                return d_mul(d_mul(ast_copy(node), builtin(OP_LN, ast_copy(u))),
+                             derive(v, error));
+            }
+            return d_mul(ast_copy(node),
+                         d_add(d_mul(derive(v, error),
+                                     builtin(OP_LN, ast_copy(u))),
+                               d_div(d_mul(ast_copy(v), derive(u, error)),
+                                     ast_copy(u))));
+        case OP_NEG:
+            return d_neg(derive(u, error));
+        case OP_SQUARE:
+            return d_mul(d_mul(ast_constant(2), ast_copy(u)), derive(u, error));
+        case OP_POLY: {
+            /* Coefficients of the derivative, highest power first */
+            double coefficients[AST_MAX_DEGREE + 1];
+            int k;
+            for (k = 0; k < node->index; k++) {
+                coefficients[k] = (node->index - k) * node->coefficients[k];
+            }
+            if (node->index == 1) {
+                return d_mul(ast_constant(coefficients[0]), derive(u, error));
+            }
+            return d_mul(polynomial_node(coefficients, node->index - 1,
+                                         ast_copy(u)),
+                         derive(u, error));
+        }
+        case OP_ABS:
+            return d_mul(d_div(ast_copy(u), ast_copy(node)), derive(u, error));
+        case OP_EXP:
+            return d_mul(ast_copy(node), derive(u, error));
+        case OP_LN:
+            return ast_binary(OP_ADD, d_div(derive(u, error), ast_copy(u)),
+                              ast_binary(OP_MUL, ast_constant(0),
+                                         ast_copy(node)));
+        case OP_LOG:
+            return ast_binary(OP_ADD,
+                              d_div(derive(u, error),
+                                    d_mul(ast_copy(u), ast_constant(log(10.0)))),
+                              ast_binary(OP_MUL, ast_constant(0),
+                                         ast_copy(node)));
+        case OP_SIN:
+            return d_mul(builtin(OP_COS, ast_copy(u)), derive(u, error));
+        case OP_COS:
+            return d_neg(d_mul(builtin(OP_SIN, ast_copy(u)), derive(u, error)));
+        case OP_TAN:
+            return d_div(derive(u, error),
+                         ast_unary(OP_SQUARE, 0, builtin(OP_COS, ast_copy(u))));
+        case OP_ASIN:
+        case OP_ACOS: {
+            /* 1/sqrt(1 - u^2), the power is undefined outside [-1, 1] */
+            ExprNode *d = d_div(derive(u, error),
+                                ast_binary(OP_POW,
+                                           d_sub(ast_constant(1),
+                                                 ast_unary(OP_SQUARE, 0,
+                                                           ast_copy(u))),
+                                           ast_constant(0.5)));
+            return node->opcode == OP_ASIN ? d : d_neg(d);
+        }
+        case OP_ATAN:
+            return d_div(derive(u, error),
+                         d_add(ast_constant(1), ast_unary(OP_SQUARE, 0, ast_copy(u))));
+        case OP_SINH:
+            return d_mul(builtin(OP_COSH, ast_copy(u)), derive(u, error));
+        case OP_COSH:
+            return d_mul(builtin(OP_SINH, ast_copy(u)), derive(u, error));
+        case OP_TANH:
+            return d_div(derive(u, error),
+                         ast_unary(OP_SQUARE, 0, builtin(OP_COSH, ast_copy(u))));
+        default:
+            *error = PARSER_ERROR_NOT_DIFFERENTIABLE;
+            return NULL;
+    }
+}
+
+/* ____________________________________________________________________________
+    Derivative constructors
+
+    Implementation Notes:
+    - Same ownership rules as ast_binary() and ast_unary()
+    - Built-in functions get the registry index the parser gives them,
+      so equal subtrees of a function and its derivative are shared
+    - Terms with a constant zero derivative are dropped right away,
+      which keeps the trees of long chains small
+   ____________________________________________________________________________
+*/
+static ExprNode *builtin(OpCode opcode, ExprNode *operand) {
+    return ast_unary(opcode, -1, operand);
+}
+
+static ExprNode *d_add(ExprNode *a, ExprNode *b) {
+    if (a && b && is_constant(b, 0)) {
+        ast_free(b);
+        return a;
+    }
+    if (a && b && is_constant(a, 0)) {
+        ast_free(a);
+        return b;
+    }
+    return ast_binary(OP_ADD, a, b);
+}
+
+static ExprNode *d_sub(ExprNode *a, ExprNode *b) {
+    if (a && b && is_constant(b, 0)) {
+        ast_free(b);
+        return a;
+    }
+    return ast_binary(OP_SUB, a, b);
+}
+
+static ExprNode *d_mul(ExprNode *a, ExprNode *b) {
+    if (a && b && (is_constant(a, 0) || is_constant(b, 0))) {
+        ast_free(a);
+        ast_free(b);
+        return ast_constant(0);
+    }
+    return ast_binary(OP_MUL, a, b);
+}
+
+static ExprNode *d_div(ExprNode *a, ExprNode *b) {
+    if (a && b && is_constant(a, 0)) {
+        ast_free(a);
+        ast_free(b);
+        return ast_constant(0);
+    }
+    return ast_binary(OP_DIV, a, b);
+}
+
+static ExprNode *d_neg(ExprNode *a) {
+    if (a && is_constant(a, 0)) {
+        return a;
+    }
+    return ast_unary(OP_NEG, 0, a);
+}
+
+/* ____________________________________________________________________________
+    int ast_hoist_invariant(ExprNode **trees, int count, unsigned varying,
+                            ExprNode **hoisted, int max_hoisted)
+
+    Moves the subtrees that do not depend on varying variables out of
+    the trees.
+   ____________________________________________________________________________
+*/
+int ast_hoist_invariant(ExprNode **trees, int count, unsigned varying,
+                        ExprNode **hoisted, int max_hoisted) {
+    Hoister h;
+    int i;
+
+    h.varying = varying;
+    h.hoisted = hoisted;
+    h.max_hoisted = max_hoisted;
+    h.count = 0;
+
+    for (i = 0; i < count; i++) {
+        trees[i] = hoist(&h, trees[i]);
+    }
+
+    return h.count;
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *hoist(Hoister *h, ExprNode *node)
+
+    Returns the node itself, or an OP_COLUMN leaf if the node was moved.
+
+    Hoisting Strategy:
+    - The walk is top-down, so the first invariant node on a path is the
+      largest invariant subtree and its operands are not visited
+    - A subtree equal to one moved before reuses its column and is freed
+    - Leaves stay, and so does everything once the columns run out or
+      a leaf cannot be allocated
+   ____________________________________________________________________________
+*/
+static ExprNode *hoist(Hoister *h, ExprNode *node) {
+    ExprNode *column;
+    int k;
+
+    if (opcode_arity(node->opcode) == 0) {
+        return node;
+    }
+
+    if (variables_read(node) & h->varying) {
+        node->left = hoist(h, node->left);
+        if (node->right) {
+            node->right = hoist(h, node->right);
+        }
+        return node;
+    }
+
+    for (k = 0; k < h->count; k++) {
+        if (same_tree(h->hoisted[k], node)) {
+            break;
+        }
+    }
+    if (k == h->max_hoisted) {
+        return node;
+    }
+
+    column = new_node(OP_COLUMN);
+    if (!column) {
+        return node;  /* Still correct, only not hoisted */
+    }
+    column->index = k;
+
+    if (k < h->count) {
+        ast_free(node);
+    } else {
+        h->hoisted[h->count++] = node;
+    }
+    return column;
+}
+
+/* ____________________________________________________________________________
+    static unsigned variables_read(const ExprNode *node)
+
+    Returns the mask of variable slots a tree reads, x included.
+   ____________________________________________________________________________
+*/
+static unsigned variables_read(const ExprNode *node) {
+    if (!node) {
+        return 0;
+    }
+    if (node->opcode == OP_X) {
+        return 1u << VAR_X;
+    }
+    if (node->opcode == OP_VAR) {
+        return 1u << node->index;
+    }
+
+    return variables_read(node->left) | variables_read(node->right);
+}
+
+/* ____________________________________________________________________________
+    static int same_tree(const ExprNode *a, const ExprNode *b)
+
+    Checks whether two trees are structurally equal, constants are
+    compared bit by bit like in number_node().
+   ____________________________________________________________________________
+*/
+static int same_tree(const ExprNode *a, const ExprNode *b) {
+    if (!a || !b) {
+        return a == b;
+    }
+    if (a->opcode != b->opcode || a->index != b->index ||
+        memcmp(&a->value, &b->value, sizeof(double)) != 0) {
+        return 0;
+    }
+    if (a->coefficients &&
+        (!b->coefficients ||
+         memcmp(a->coefficients, b->coefficients,
+                (a->index + 1) * sizeof(double)) != 0)) {
+        return 0;
+    }
+
+    return same_tree(a->left, b->left) && same_tree(a->right, b->right);
+}
+
+/* ____________________________________________________________________________
+    ParserError ast_emit(ExprNode *node, Program *prog)
+
+    Generates bytecode of a single tree.
+   ____________________________________________________________________________
+*/
+ParserError ast_emit(ExprNode *node, Program *prog) {
+    return ast_emit_program(&node, 1, prog);
+}
+
+/* ____________________________________________________________________________
+    ParserError ast_emit_program(ExprNode **trees, int count, Program *prog)
+
+    Generates postfix bytecode by post-order walks of the trees.
+
+    Emission Strategy:
+    - Number all nodes with their subexpression classes
+    - Walk the trees in emission order and count how often every class
+      is reached, shared subtrees are not descended into again
+    - Give slots to operator classes reached more than once
+    - Emit the trees one after another, each leaves its value on the stack
+   ____________________________________________________________________________
+*/
+ParserError ast_emit_program(ExprNode **trees, int count, Program *prog) {
+    Emitter emitter;
+    int total = 0;
+    int i;
+
+    if (!trees || count < 1 || !prog) {
+        return PARSER_ERROR_INVALID_INPUT;
+    }
+    for (i = 0; i < count; i++) {
+        if (!trees[i]) {
+            return PARSER_ERROR_INVALID_INPUT;
+        }
+        total += count_nodes(trees[i]);
+    }
+
+    emitter.prog = prog;
+    emitter.depth = 0;
+    emitter.error = PARSER_OK;
+    emitter.num_classes = 0;
+
+    /* Keep the hash table at most half full */
+    emitter.table_size = 16;
+    while (emitter.table_size < (unsigned)total * 2) {
+        emitter.table_size *= 2;
+    }
+    emitter.classes = malloc(total * sizeof(SubexprClass));
+    emitter.table = calloc(emitter.table_size, sizeof(int));
+    if (!emitter.classes || !emitter.table) {
+        free(emitter.classes);
+        free(emitter.table);
+        return PARSER_ERROR_MEMORY;
+    }
+
+    for (i = 0; i < count; i++) {
+        number_node(&emitter, trees[i]);
+    }
+    for (i = 0; i < count; i++) {
+        count_visits(&emitter, trees[i]);
+    }
+
+    /* Operands are numbered before their operators, so inner shared
+       subexpressions get slots first */
+    for (i = 0; i < emitter.num_classes; i++) {
+        SubexprClass *c = &emitter.classes[i];
+        if (c->visits > 1 && opcode_arity(c->opcode) > 0 &&
+            prog->num_slots < MAX_PROGRAM_SLOTS) {
+            c->slot = prog->num_slots++;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        emit_node(&emitter, trees[i]);
+    }
+    prog->num_outputs = count;
+
+    free(emitter.classes);
+    free(emitter.table);
+
+    if (emitter.error == PARSER_OK && prog->max_stack_depth > MAX_STACK_DEPTH) {
+        emitter.error = PARSER_ERROR_SYNTAX;
+    }
+
+    return emitter.error;
+}
+
+/* ____________________________________________________________________________
+    static int count_nodes(const ExprNode *node)
+
+    Returns the number of nodes of a tree.
+   ____________________________________________________________________________
+*/
+static int count_nodes(const ExprNode *node) {
+    if (!node) {
+        return 0;
+    }
+
+    return 1 + count_nodes(node->left) + count_nodes(node->right);
+}
+
+/* ____________________________________________________________________________
+    static int number_node(Emitter *e, ExprNode *node)
+
+    Assigns subexpression classes to a tree bottom-up and returns the
+    class of its root.
+
+    Implementation Notes:
+    - Constants are compared bit by bit, so -0 and 0 stay distinct
+    - The registry index only matters for OP_CALL, the degree for
+      OP_POLY, the slot for OP_VAR and the column for OP_COLUMN, other
+      nodes may carry different unused indices
+    - Polynomials also hash and compare their coefficients
+    - The hash table stores class indices + 1, 0 marks an empty slot
+   ____________________________________________________________________________
+*/
+static int number_node(Emitter *e, ExprNode *node) {
+    int left = node->left ? number_node(e, node->left) : -1;
+    int right = node->right ? number_node(e, node->right) : -1;
+    const unsigned char *bytes = (const unsigned char *)&node->value;
+    int index = (node->opcode == OP_CALL || node->opcode == OP_POLY ||
+                 node->opcode == OP_VAR || node->opcode == OP_COLUMN) ?
+                node->index : 0;
+    unsigned long hash = 2166136261UL;
+    unsigned position;
+    size_t k;
+
+    /* FNV-1a over the class key */
+    hash = (hash ^ (unsigned long)node->opcode) * 16777619UL;
+    hash = (hash ^ (unsigned long)index) * 16777619UL;
+    hash = (hash ^ (unsigned long)(left + 1)) * 16777619UL;
+    hash = (hash ^ (unsigned long)(right + 1)) * 16777619UL;
+    for (k = 0; k < sizeof(double); k++) {
+        hash = (hash ^ bytes[k]) * 16777619UL;
+    }
+    if (node->coefficients) {
+        const unsigned char *coefficient = (const unsigned char *)node->coefficients;
+        for (k = 0; k < (index + 1) * sizeof(double); k++) {
+            hash = (hash ^ coefficient[k]) * 16777619UL;
+        }
+    }
+
+    position = (unsigned)hash & (e->table_size - 1);
+    while (e->table[position] != 0) {
+        SubexprClass *c = &e->classes[e->table[position] - 1];
+        if (c->opcode == node->opcode && c->index == index &&
+            c->left == left && c->right == right &&
+            memcmp(&c->value, &node->value, sizeof(double)) == 0 &&
+            (!node->coefficients ||
+             memcmp(c->coefficients, node->coefficients,
+                    (index + 1) * sizeof(double)) == 0)) {
+            node->id = e->table[position] - 1;
+            return node->id;
+        }
+        position = (position + 1) & (e->table_size - 1);
+    }
+
+    /* New class */
+    node->id = e->num_classes++;
+    e->table[position] = node->id + 1;
+    e->classes[node->id].opcode = node->opcode;
+    e->classes[node->id].index = index;
+    e->classes[node->id].value = node->value;
+    e->classes[node->id].coefficients = node->coefficients;
+    e->classes[node->id].left = left;
+    e->classes[node->id].right = right;
+    e->classes[node->id].visits = 0;
+    e->classes[node->id].slot = -1;
+    e->classes[node->id].computed = 0;
+    return node->id;
+}
+
+/* ____________________________________________________________________________
+    static void count_visits(Emitter *e, const ExprNode *node)
+
+    Counts how often emission reaches every class. The operands of a
+    class reached before are not visited again, they are not emitted
+    again once the class has a slot.
+   ____________________________________________________________________________
+*/
+static void count_visits(Emitter *e, const ExprNode *node) {
+    if (e->classes[node->id].visits++ > 0) {
+        return;
+    }
+
+    if (node->left) {
+        count_visits(e, node->left);
+    }
+    if (node->right) {
+        count_visits(e, node->right);
+    }
+}
+
+/* ____________________________________________________________________________
+    static void emit_node(Emitter *e, const ExprNode *node)
+
+    Emits the operands of a node followed by the node itself, or a load
+    of its slot if the value has been computed already.
+   ____________________________________________________________________________
+*/
+static void emit_node(Emitter *e, const ExprNode *node) {
+    SubexprClass *c = &e->classes[node->id];
+
+    if (c->slot >= 0 && c->computed) {
+        emit(e, OP_LOAD, c->slot);
+        return;
+    }
+
+    switch (node->opcode) {
+        case OP_CONST:
+            emit_constant(e, node->value);
+            break;
+        case OP_X:
+            emit(e, OP_X, 0);
+            break;
+        case OP_VAR:
+        case OP_COLUMN:
+            emit(e, node->opcode, node->index);
+            break;
+        case OP_POLY: {
+            /* Degree and coefficients are stored next to each other */
+            int start = add_constant(e, node->index);
+            int k;
+            for (k = 0; k <= node->index; k++) {
+                add_constant(e, node->coefficients[k]);
+            }
+            emit_node(e, node->left);
+            emit(e, OP_POLY, start);
+            break;
+        }
+        default:
+            emit_node(e, node->left);
+            if (node->right) {
+                emit_node(e, node->right);
+            }
+            emit(e, node->opcode, node->index);
+            break;
+    }
+
+    if (c->slot >= 0) {
+        emit(e, OP_STORE, c->slot);
+        c->computed = 1;
+    }
+}
+
+/* ____________________________________________________________________________
+    static void emit(Emitter *e, OpCode opcode, int operand)
+
+    Appends an instruction to the program.
+
+    Emission Strategy:
+    - Grow the code array geometrically when it is full
+    - Update the simulated stack depth and remember its maximum
+   ____________________________________________________________________________
+*/
+static void emit(Emitter *e, OpCode opcode, int operand) {
+    Program *prog = e->prog;
+
+    if (e->error != PARSER_OK) {
+        return;
+    }
+
+    /* Grow the instruction array when needed */
+    if (prog->code_length == prog->code_capacity) {
+        int new_capacity = prog->code_capacity ? prog->code_capacity * 2 : 32;
+        Instruction *new_code = realloc(prog->code,
+                                        new_capacity * sizeof(Instruction));
+        if (!new_code) {
+            e->error = PARSER_ERROR_MEMORY;
+            return;
+        }
+        prog->code = new_code;
+        prog->code_capacity = new_capacity;
+    }
+
+    prog->code[prog->code_length].opcode = opcode;
+    prog->code[prog->code_length].operand = operand;
+    prog->code_length++;
+
+    /* Remember which variables the program reads */
+    if (opcode == OP_X || opcode == OP_VAR) {
+        prog->variable_mask |= 1u << operand;
+    }
+
+    /* Operands push a value, binary operators replace two values by one */
+    e->depth += 1 - opcode_arity(opcode);
+
+    if (e->depth > prog->max_stack_depth) {
+        prog->max_stack_depth = e->depth;
+    }
+}
+
+/* ____________________________________________________________________________
+    static int add_constant(Emitter *e, double value)
+
+    Appends a value to the constant pool and returns its index, -1 on
+    failure.
+   ____________________________________________________________________________
+*/
+static int add_constant(Emitter *e, double value) {
+    Program *prog = e->prog;
+
+    if (e->error != PARSER_OK) {
+        return -1;
+    }
+
+    /* Grow the constant pool when needed */
+    if (prog->num_constants == prog->const_capacity) {
+        int new_capacity = prog->const_capacity ? prog->const_capacity * 2 : 8;
+        double *new_constants = realloc(prog->constants,
+                                        new_capacity * sizeof(double));
+        if (!new_constants) {
+            e->error = PARSER_ERROR_MEMORY;
+            return -1;
+        }
+        prog->constants = new_constants;
+        prog->const_capacity = new_capacity;
+    }
+
+    prog->constants[prog->num_constants] = value;
+    return prog->num_constants++;
+}
+
+/* ____________________________________________________________________________
+    static void emit_constant(Emitter *e, double value)
+
+    Stores a value in the constant pool and emits the instruction
+    that pushes it.
+   ____________________________________________________________________________
+*/
+static void emit_constant(Emitter *e, double value) {
+    int index = add_constant(e, value);
+
+    if (index >= 0) {
+        emit(e, OP_CONST, index);
+    }
+}
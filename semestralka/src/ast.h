@@ -0,0 +1,223 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header ast.h
+
+    Expression tree used between parsing and bytecode generation.
+    The compiler first builds a tree of the expression, rewrites it into
+    a cheaper but equivalent form and only then emits postfix bytecode.
+
+    Key Features:
+    - Tree construction and destruction
+    - Constant folding of x-independent subtrees
+    - Algebraic simplification of identities
+    - Strength reduction of squares
+    - Symbolic differentiation
+    - Hoisting of subtrees that do not depend on changing variables
+    - Postfix bytecode emission with common subexpression elimination
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef AST_H
+#define AST_H
+
+#include "parser.h"  /* Opcodes and compiled program representation */
+
+/*
+  Expression tree node
+  The node kind is given by its opcode, which is the same opcode the node
+  is compiled to. This keeps the tree and the bytecode in one vocabulary.
+
+  Members:
+  opcode       - OP_CONST, OP_X, OP_VAR and OP_COLUMN for leaves,
+                 operator opcode otherwise
+  index        - Registry index for OP_CALL, degree for OP_POLY,
+                 variable slot for OP_VAR, column for OP_COLUMN,
+                 unused otherwise
+  value        - Value of OP_CONST leaves
+  coefficients - index + 1 coefficients of OP_POLY from the highest
+                 power down, owned by the node; NULL otherwise
+  left         - Operand of unary nodes, left operand of binary nodes
+  right        - Right operand of binary nodes, NULL otherwise
+  id           - Subexpression class, assigned while emitting bytecode
+*/
+struct ExprNode {
+    OpCode opcode;           /* Node kind */
+    int index;               /* Registry index or degree */
+    double value;            /* Constant value */
+    double *coefficients;    /* Polynomial coefficients */
+    struct ExprNode *left;   /* First operand */
+    struct ExprNode *right;  /* Second operand */
+    int id;                  /* Subexpression class */
+};
+
+/* Highest degree of a polynomial collected by ast_polynomials() */
+#define AST_MAX_DEGREE 32
+
+/*
+  Returns the number of operands taken by an opcode (0, 1 or 2)
+*/
+int opcode_arity(OpCode opcode);
+
+/*
+  Node constructors
+  Allocate a new node with the given content.
+
+  Returns:
+  ExprNode* - New node, NULL on allocation failure
+
+  Memory Management:
+  - ast_unary() and ast_binary() take ownership of their operands and
+    release them if the node cannot be created or an operand is NULL
+*/
+ExprNode *ast_constant(double value);
+ExprNode *ast_variable(void);
+ExprNode *ast_named_variable(int slot);
+ExprNode *ast_unary(OpCode opcode, int index, ExprNode *operand);
+ExprNode *ast_binary(OpCode opcode, ExprNode *left, ExprNode *right);
+
+/*
+  Duplicates a tree
+
+  Returns:
+  ExprNode* - Independent copy, NULL on allocation failure
+*/
+ExprNode *ast_copy(const ExprNode *node);
+
+/*
+  Releases a tree including all its subtrees
+  Safe to call with NULL pointer.
+*/
+void ast_free(ExprNode *node);
+
+/*
+  Rewrites a tree into a cheaper equivalent form
+
+  Parameters:
+  node - Tree to optimize, ownership is transferred to the function
+
+  Returns:
+  ExprNode* - Optimized tree (nodes of the input may be reused or freed)
+
+  Rewrites:
+  - Subtrees without x are folded into a single constant
+    (e.g. sin(3.14159/2)*2), so nothing x-independent is left to be
+    recomputed for every sample
+  - Identities: e+0, 0+e, e-0, e*1, 1*e, e/1, e^1 become e
+  - 0-e becomes -e, e+(-f) becomes e-f, e-(-f) becomes e+f, -(-e) becomes e
+  - e^2 becomes a single multiplication (OP_SQUARE)
+
+  Notes:
+  - Every rewrite gives identical results, including undefined points,
+    so rewrites such as e*0 = 0 or e^0 = 1 are deliberately not done
+*/
+ExprNode *ast_optimize(ExprNode *node);
+
+/*
+  Replaces polynomials in x by single OP_POLY nodes
+
+  Parameters:
+  node - Optimized tree, ownership is transferred to the function
+
+  Returns:
+  ExprNode* - Tree with the largest polynomial subtrees replaced
+
+  Recognized Polynomials:
+  - Sums and differences of monomials; a monomial is a product of
+    constants and powers of x with constant integer exponents from 0 to
+    AST_MAX_DEGREE, optionally negated or divided by a nonzero constant
+    (e.g. 3*x^4 - x^2/2 + 7)
+  - Products of sums such as (x+1)*(x-1) are not expanded, expanding
+    them loses precision by cancellation
+
+  Notes:
+  - Only subtrees with a power or more than three nodes are replaced,
+    smaller ones are as cheap as they are
+  - Horner's scheme rounds differently than the original tree, values
+    may differ in the last bits; like the rest of the arithmetic, huge
+    values overflow to undefined results
+  - Subtrees stay unchanged when memory cannot be allocated
+*/
+ExprNode *ast_polynomials(ExprNode *node);
+
+/*
+  Differentiates a tree with respect to x
+
+  Parameters:
+  node   - Tree to differentiate, it is not modified
+  result - Receives the optimized derivative, a new tree
+
+  Returns:
+  ParserError - PARSER_OK on success
+                PARSER_ERROR_NOT_DIFFERENTIABLE if the tree calls a
+                registered function that depends on x
+                PARSER_ERROR_MEMORY on allocation failure
+
+  Notes:
+  - The derivative is undefined wherever the tree is undefined, and at
+    points where the derivative does not exist (e.g. abs(x) at 0)
+  - Built for optimized trees, their squares (OP_SQUARE) and
+    polynomials (OP_POLY) are handled
+*/
+ParserError ast_derivative(const ExprNode *node, ExprNode **result);
+
+/*
+  Moves subtrees that do not depend on varying variables out of trees
+
+  Parameters:
+  trees       - Array of count trees, rewritten in place
+  count       - Number of trees
+  varying     - Bit k is set for every variable slot k that varies;
+                the bit of x (VAR_X) makes x varying as well
+  hoisted     - Receives the moved subtrees, owned by the caller
+  max_hoisted - Capacity of hoisted
+
+  Returns:
+  int - Number of subtrees moved to hoisted
+
+  Notes:
+  - Every largest subtree with an operator and without a varying
+    variable is replaced by an OP_COLUMN leaf whose index is the
+    position of the subtree in hoisted
+  - Structurally equal subtrees share one entry
+  - A subtree whose leaf cannot be allocated simply stays in its tree
+  - Meant for optimized trees, after ast_polynomials()
+*/
+int ast_hoist_invariant(ExprNode **trees, int count, unsigned varying,
+                        ExprNode **hoisted, int max_hoisted);
+
+/*
+  Emits postfix bytecode for a tree
+  Same as ast_emit_program() with a single tree.
+*/
+ParserError ast_emit(ExprNode *node, Program *prog);
+
+/*
+  Emits postfix bytecode computing several trees
+
+  Parameters:
+  trees - Array of count trees, their id members are overwritten
+  count - Number of trees, becomes the number of program outputs
+  prog  - Program receiving the code, must be empty (zero-initialized)
+
+  Returns:
+  ParserError - PARSER_OK on success
+                PARSER_ERROR_MEMORY on allocation failure
+                PARSER_ERROR_SYNTAX if the program needs a deeper
+                evaluation stack than MAX_STACK_DEPTH
+
+  Common Subexpressions:
+  - Structurally equal subtrees are numbered with the same class by
+    value numbering (opcode, operand and the classes of the operands)
+  - A class reached again while emitting is stored into a slot when
+    first computed and loaded afterwards, up to MAX_PROGRAM_SLOTS
+    slots; leaves are never stored
+*/
+ParserError ast_emit_program(ExprNode **trees, int count, Program *prog);
+
+#endif /* AST_H */
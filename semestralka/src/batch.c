@@ -0,0 +1,342 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module batch.c
+
+    Batch plotting mode.
+
+    Implementation Details:
+    - The manifest is read completely and every entry becomes a plot job
+    - Workers take the next job from a shared counter guarded by a mutex,
+      so long plots do not hold up the rest of a static partition; every
+      job is restored from the cache or compiled and rendered by the
+      worker that takes it
+    - Every job has its own status, the exit code is decided afterwards
+    - All jobs share one cache, so repeated and equivalent entries are
+      written only once; a repeated entry taken after the earlier one
+      was written is copied without compilation
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#include <pthread.h>     /* Worker threads */
+#include "batch.h"
+#include "evaluator.h"   /* Evaluation thread limits */
+
+/*
+  Batch context
+  Jobs of the manifest and the state shared by the workers.
+*/
+typedef struct {
+    PlotJob *jobs;             /* Jobs in manifest order */
+    int *status;               /* Exit code of every job */
+    int num_jobs;              /* Number of jobs */
+    int capacity;              /* Allocated length of jobs and status */
+    int next_job;              /* Next job to be rendered */
+    int job_threads;           /* Evaluation threads per job */
+    PlotCache *cache;          /* Graphs of all jobs, NULL if none */
+    pthread_mutex_t lock;      /* Guards next_job */
+} Batch;
+
+/* Internal function prototypes */
+static int read_manifest(Batch *batch, FILE *input);
+static int parse_manifest_line(PlotJob *job, char *line);
+static char *next_field(char **cursor);
+static void *batch_worker(void *arg);
+
+/* ____________________________________________________________________________
+    int run_batch(const char *manifest, int num_threads,
+                  const char *cache_dir)
+
+    Plots all entries of a manifest.
+
+    Processing Steps:
+    - Read and parse all manifest lines
+    - Restore stored graphs, compile and render all other valid entries
+      in a worker pool
+    - Report the first failure in manifest order
+   ____________________________________________________________________________
+*/
+int run_batch(const char *manifest, int num_threads, const char *cache_dir) {
+    pthread_t threads[EVAL_MAX_THREADS];
+    Batch batch;
+    FILE *input;
+    int num_workers, started, i;
+    int result = 0, failed = 0;
+
+    if (strcmp(manifest, "-") == 0) {
+        input = stdin;
+    } else {
+        input = fopen(manifest, "r");
+        if (!input) {
+            fprintf(stderr, "Error: Cannot open manifest file '%s'.\n", manifest);
+            return 1;
+        }
+    }
+
+    memset(&batch, 0, sizeof(batch));
+    if (!read_manifest(&batch, input)) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        result = 5;
+    } else if (ferror(input)) {
+        fprintf(stderr, "Error: Cannot read manifest file '%s'.\n", manifest);
+        result = 1;
+    } else if (batch.num_jobs == 0) {
+        fprintf(stderr, "Error: Manifest contains no plots.\n");
+        result = 1;
+    }
+    if (input != stdin) {
+        fclose(input);
+    }
+
+    if (result != 0) {
+        for (i = 0; i < batch.num_jobs; i++) {
+            free_plot(&batch.jobs[i]);
+        }
+        free(batch.jobs);
+        free(batch.status);
+        return result;
+    }
+
+    /* Without memory for the cache every entry is rendered */
+    batch.cache = cache_create(CACHE_DEFAULT_MEMORY, cache_dir);
+
+    for (i = 0; i < batch.num_jobs; i++) {
+        batch.jobs[i].cache = batch.cache;
+    }
+
+    /* Spare threads go to the evaluation of the individual plots */
+    num_workers = (num_threads < batch.num_jobs) ? num_threads : batch.num_jobs;
+    if (num_workers < 1) {
+        num_workers = 1;
+    }
+    batch.job_threads = num_threads / num_workers;
+    if (batch.job_threads < 1) {
+        batch.job_threads = 1;
+    }
+
+    pthread_mutex_init(&batch.lock, NULL);
+    for (started = 0; started < num_workers - 1; started++) {
+        if (pthread_create(&threads[started], NULL, batch_worker, &batch) != 0) {
+            break;
+        }
+    }
+    batch_worker(&batch);  /* The main thread works as well */
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&batch.lock);
+
+    /* Exit code of the first failure in manifest order */
+    for (i = 0; i < batch.num_jobs; i++) {
+        if (batch.status[i] != 0) {
+            if (result == 0) {
+                result = batch.status[i];
+            }
+            failed++;
+        }
+        free_plot(&batch.jobs[i]);
+    }
+
+    if (failed > 0) {
+        fprintf(stderr, "Error: %d of %d plots failed.\n", failed, batch.num_jobs);
+    }
+
+    cache_destroy(batch.cache);
+    free(batch.jobs);
+    free(batch.status);
+    return result;
+}
+
+/* ____________________________________________________________________________
+    static int read_manifest(Batch *batch, FILE *input)
+
+    Reads all lines of the manifest into jobs. Invalid lines become jobs
+    with a nonzero status, so they are reported in the final exit code.
+
+    Returns:
+    int - 1 on success, 0 on memory allocation failure
+   ____________________________________________________________________________
+*/
+static int read_manifest(Batch *batch, FILE *input) {
+    char line[BATCH_MAX_LINE];
+    int line_number = 0;
+
+    while (fgets(line, sizeof(line), input)) {
+        PlotJob *job;
+        size_t length = strlen(line);
+        int too_long = 0;
+        char *start = line;
+
+        line_number++;
+
+        /* Skip the rest of an overlong line */
+        if (length > 0 && line[length - 1] != '\n' && !feof(input)) {
+            int c;
+            while ((c = fgetc(input)) != EOF && c != '\n') {
+                /* Discard */
+            }
+            too_long = 1;
+        }
+
+        while (isspace((unsigned char)*start)) {
+            start++;
+        }
+        if (*start == '\0' || *start == '#') {
+            continue;
+        }
+
+        /* Grow the job arrays when needed */
+        if (batch->num_jobs == batch->capacity) {
+            int new_capacity = batch->capacity ? batch->capacity * 2 : 16;
+            PlotJob *new_jobs = realloc(batch->jobs, new_capacity * sizeof(PlotJob));
+            int *new_status;
+            if (!new_jobs) {
+                return 0;
+            }
+            batch->jobs = new_jobs;
+            new_status = realloc(batch->status, new_capacity * sizeof(int));
+            if (!new_status) {
+                return 0;
+            }
+            batch->status = new_status;
+            batch->capacity = new_capacity;
+        }
+
+        job = &batch->jobs[batch->num_jobs];
+        memset(job, 0, sizeof(*job));
+        job->line = line_number;
+
+        if (too_long) {
+            plot_message(job, "Error: Line too long\n");
+            batch->status[batch->num_jobs] = 1;
+        } else {
+            batch->status[batch->num_jobs] = parse_manifest_line(job, start);
+        }
+        batch->num_jobs++;
+    }
+
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    static int parse_manifest_line(PlotJob *job, char *line)
+
+    Fills a job from the fields of one manifest line.
+
+    Returns:
+    int - 0 on success, 1 on invalid fields
+   ____________________________________________________________________________
+*/
+static int parse_manifest_line(PlotJob *job, char *line) {
+    char *cursor = line;
+    char *function = next_field(&cursor);
+    char *output = next_field(&cursor);
+    char *range = next_field(&cursor);
+
+    if (!function || !output) {
+        plot_message(job, "Error: Expected <function> <output_file> [xmin:xmax:ymin:ymax]\n");
+        return 1;
+    }
+    if (next_field(&cursor)) {
+        plot_message(job, "Error: Too many fields\n");
+        return 1;
+    }
+
+    /* Set default plotting range values */
+    job->xmin = PLOT_DEFAULT_MIN;
+    job->xmax = PLOT_DEFAULT_MAX;
+    job->ymin = PLOT_DEFAULT_MIN;
+    job->ymax = PLOT_DEFAULT_MAX;
+
+    if (set_plot_function(job, function) != 0 ||
+        set_plot_output(job, output) != 0 ||
+        (range && set_plot_range(job, range) != 0)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    static char *next_field(char **cursor)
+
+    Splits the next whitespace separated field off a line in place.
+    A field starting with a double quote extends to the closing quote.
+
+    Returns:
+    char* - The field, NULL at the end of the line
+   ____________________________________________________________________________
+*/
+static char *next_field(char **cursor) {
+    char *p = *cursor;
+    char *field;
+
+    while (isspace((unsigned char)*p)) {
+        p++;
+    }
+    if (*p == '\0') {
+        *cursor = p;
+        return NULL;
+    }
+
+    if (*p == '"') {
+        field = ++p;
+        while (*p != '\0' && *p != '"') {
+            p++;
+        }
+    } else {
+        field = p;
+        while (*p != '\0' && !isspace((unsigned char)*p)) {
+            p++;
+        }
+    }
+
+    if (*p != '\0') {
+        *p++ = '\0';
+    }
+    *cursor = p;
+    return field;
+}
+
+/* ____________________________________________________________________________
+    static void *batch_worker(void *arg)
+
+    Restores or compiles and renders jobs until none are left.
+   ____________________________________________________________________________
+*/
+static void *batch_worker(void *arg) {
+    Batch *batch = arg;
+
+    for (;;) {
+        int index;
+
+        pthread_mutex_lock(&batch->lock);
+        index = batch->next_job++;
+        pthread_mutex_unlock(&batch->lock);
+
+        if (index >= batch->num_jobs) {
+            break;
+        }
+
+        /* Entries that failed to parse are skipped */
+        if (batch->status[index] == 0) {
+            PlotJob *job = &batch->jobs[index];
+            int status = restore_plot(job);
+
+            if (status < 0) {
+                status = compile_plot(job);
+                if (status == 0) {
+                    status = render_plot(job, batch->job_threads);
+                }
+            }
+            batch->status[index] = status;
+        }
+    }
+
+    return NULL;
+}
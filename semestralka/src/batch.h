@@ -0,0 +1,59 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header batch.h
+
+    Batch plotting mode. Many plots are produced by one process from
+    a manifest instead of starting the program once per plot.
+
+    Manifest Format:
+    - One plot per line: <function> <output_file> [xmin:xmax:ymin:ymax]
+    - Fields are separated by whitespace, a field containing whitespace
+      is enclosed in double quotes
+    - Empty lines and lines starting with '#' are ignored
+
+    Key Features:
+    - Plots are compiled and rendered by a pool of worker threads
+    - Every file is written as soon as its plot is rendered
+    - Entries equal to an earlier one, also after compilation, are
+      copied from a shared cache instead of being rendered again;
+      with a cache directory this holds across runs as well
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "plot.h"  /* Plot jobs */
+
+/* Maximum length of a manifest line including the line break */
+#define BATCH_MAX_LINE (MAX_EXPR_LEN + PLOT_MAX_PATH + 256)
+
+/*
+  Plots all entries of a manifest
+
+  Parameters:
+  manifest    - Path of the manifest file, "-" reads standard input
+  num_threads - Number of worker threads; when there are fewer plots
+                than threads, the remaining threads evaluate samples
+                of the plots
+  cache_dir   - Directory of the disk cache shared with other runs,
+                NULL to keep graphs in memory for this run only
+
+  Returns:
+  int - 0 if all plots were written
+        1 if the manifest cannot be read or contains no plots
+        otherwise the exit code of the first failed entry (see plot.h)
+
+  Notes:
+  - A failed entry does not stop the other ones
+  - Diagnostics are prefixed with the manifest line number
+*/
+int run_batch(const char *manifest, int num_threads, const char *cache_dir);
+
+#endif /* BATCH_H */
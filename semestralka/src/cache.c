@@ -0,0 +1,662 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module cache.c
+
+    Content-addressed cache of rendered graphs.
+
+    Implementation Details:
+    - Entries are chained in CACHE_BUCKETS hash buckets and in one list
+      ordered by last use, evictions take the oldest entry
+    - Results are reference counted, an entry holds one reference and
+      so does every caller between cache_get() and cache_release(), so
+      an evicted result stays valid for its readers
+    - The memory tier counts the data of all live results and the keys
+      of all entries
+    - Disk files are named by two 32-bit FNV-1a hashes of the key and
+      start with a header and the key itself
+    - The lock is never held during file operations
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#include <pthread.h>  /* Cache lock */
+#include <unistd.h>   /* Process id of temporary file names */
+#include "cache.h"
+
+/* Number of hash buckets of the memory tier */
+#define CACHE_BUCKETS 1024
+
+/* First line of every disk file */
+#define CACHE_MAGIC "PLOTCACHE 1\n"
+
+/*
+  Cache entry
+  One key of the memory tier and the result it refers to.
+*/
+typedef struct CacheEntry {
+    unsigned long hash;         /* Hash of the key */
+    unsigned char *key;         /* Key content */
+    size_t key_length;          /* Key size */
+    CacheBlob *blob;            /* Stored result */
+    struct CacheEntry *newer;   /* Next more recently used entry */
+    struct CacheEntry *older;   /* Next less recently used entry */
+    struct CacheEntry *chain;   /* Next entry of the bucket */
+} CacheEntry;
+
+/*
+  Cache
+  Both tiers and the lock guarding the memory tier.
+*/
+struct PlotCache {
+    CacheEntry *buckets[CACHE_BUCKETS];  /* Hash chains */
+    CacheEntry *newest;                  /* Most recently used entry */
+    CacheEntry *oldest;                  /* Least recently used entry */
+    size_t memory;                       /* Bytes held */
+    size_t max_memory;                   /* Byte limit */
+    char *directory;                     /* Disk tier, NULL if none */
+    unsigned long next_temp;             /* Counter of temporary files */
+    pthread_mutex_t lock;                /* Guards all of the above */
+};
+
+/* Internal function prototypes */
+static void key_append(CacheKey *key, const void *data, size_t length);
+static unsigned long key_hash(const unsigned char *bytes, size_t length,
+                              unsigned long basis);
+static CacheEntry *find_entry(PlotCache *cache, const CacheKey *key,
+                              unsigned long hash);
+static int insert_entry(PlotCache *cache, const CacheKey *key,
+                        unsigned long hash, CacheBlob *blob);
+static void touch_entry(PlotCache *cache, CacheEntry *entry);
+static void remove_entry(PlotCache *cache, CacheEntry *entry);
+static void release_locked(PlotCache *cache, CacheBlob *blob);
+static void evict(PlotCache *cache);
+static char *file_path(const PlotCache *cache, const CacheKey *key,
+                       const char *suffix);
+static CacheBlob *read_file(PlotCache *cache, const CacheKey *key);
+static void write_file(PlotCache *cache, const CacheKey *key,
+                       const CacheBlob *blob);
+
+/* ____________________________________________________________________________
+    void cache_key_init(CacheKey *key)
+
+    Prepares an empty key.
+   ____________________________________________________________________________
+*/
+void cache_key_init(CacheKey *key) {
+    key->bytes = NULL;
+    key->length = 0;
+    key->capacity = 0;
+    key->failed = 0;
+}
+
+/* ____________________________________________________________________________
+    Field appenders
+
+    Integers and doubles are stored in their native representation,
+    strings with their length in front.
+   ____________________________________________________________________________
+*/
+void cache_key_int(CacheKey *key, long value) {
+    key_append(key, &value, sizeof(value));
+}
+
+void cache_key_double(CacheKey *key, double value) {
+    key_append(key, &value, sizeof(value));
+}
+
+void cache_key_string(CacheKey *key, const char *text) {
+    size_t length = strlen(text);
+
+    cache_key_int(key, (long)length);
+    key_append(key, text, length);
+}
+
+/* ____________________________________________________________________________
+    void cache_key_free(CacheKey *key)
+
+    Releases the content of a key, the key is empty afterwards.
+   ____________________________________________________________________________
+*/
+void cache_key_free(CacheKey *key) {
+    free(key->bytes);
+    cache_key_init(key);
+}
+
+/* ____________________________________________________________________________
+    int cache_key_program(CacheKey *key, const Program *prog)
+
+    Appends the instructions, constants and read variables of a program.
+   ____________________________________________________________________________
+*/
+int cache_key_program(CacheKey *key, const Program *prog) {
+    int i;
+
+    for (i = 0; i < prog->code_length; i++) {
+        if (prog->code[i].opcode == OP_CALL) {
+            return 0;
+        }
+    }
+
+    cache_key_int(key, prog->num_outputs);
+    cache_key_int(key, prog->num_inputs);
+    cache_key_int(key, prog->code_length);
+    for (i = 0; i < prog->code_length; i++) {
+        cache_key_int(key, prog->code[i].opcode);
+        cache_key_int(key, prog->code[i].operand);
+    }
+    cache_key_int(key, prog->num_constants);
+    for (i = 0; i < prog->num_constants; i++) {
+        cache_key_double(key, prog->constants[i]);
+    }
+
+    /* Slots are numbered per process, names are not */
+    for (i = 0; i < MAX_VARIABLES; i++) {
+        if (i != VAR_X && (prog->variable_mask & (1u << i))) {
+            cache_key_string(key, variable_name(i));
+            cache_key_double(key, prog->variables[i]);
+        }
+    }
+
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    PlotCache *cache_create(size_t max_memory, const char *directory)
+
+    Allocates an empty cache.
+   ____________________________________________________________________________
+*/
+PlotCache *cache_create(size_t max_memory, const char *directory) {
+    PlotCache *cache = calloc(1, sizeof(PlotCache));
+
+    if (!cache) {
+        return NULL;
+    }
+    if (directory) {
+        cache->directory = malloc(strlen(directory) + 1);
+        if (!cache->directory) {
+            free(cache);
+            return NULL;
+        }
+        strcpy(cache->directory, directory);
+    }
+
+    cache->max_memory = max_memory;
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+/* ____________________________________________________________________________
+    void cache_destroy(PlotCache *cache)
+
+    Removes all entries and releases the cache.
+   ____________________________________________________________________________
+*/
+void cache_destroy(PlotCache *cache) {
+    if (!cache) {
+        return;
+    }
+
+    while (cache->oldest) {
+        remove_entry(cache, cache->oldest);
+    }
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->directory);
+    free(cache);
+}
+
+/* ____________________________________________________________________________
+    CacheBlob *cache_get(PlotCache *cache, const CacheKey *key)
+
+    Looks a key up in memory, then on disk.
+   ____________________________________________________________________________
+*/
+CacheBlob *cache_get(PlotCache *cache, const CacheKey *key) {
+    unsigned long hash;
+    CacheEntry *entry;
+    CacheBlob *blob = NULL;
+
+    if (!cache || !key || key->failed) {
+        return NULL;
+    }
+    hash = key_hash(key->bytes, key->length, 2166136261UL);
+
+    pthread_mutex_lock(&cache->lock);
+    entry = find_entry(cache, key, hash);
+    if (entry) {
+        touch_entry(cache, entry);
+        blob = entry->blob;
+        blob->refs++;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    if (blob || !cache->directory) {
+        return blob;
+    }
+
+    blob = read_file(cache, key);
+    if (blob) {
+        pthread_mutex_lock(&cache->lock);
+        cache->memory += blob->length;
+        if (!find_entry(cache, key, hash)) {
+            insert_entry(cache, key, hash, blob);
+            evict(cache);
+        }
+        pthread_mutex_unlock(&cache->lock);
+    }
+
+    return blob;
+}
+
+/* ____________________________________________________________________________
+    CacheBlob *cache_put(PlotCache *cache, const CacheKey *key,
+                         const char *bytes, size_t length, unsigned flags)
+
+    Copies a result into both tiers.
+   ____________________________________________________________________________
+*/
+CacheBlob *cache_put(PlotCache *cache, const CacheKey *key,
+                     const char *bytes, size_t length, unsigned flags) {
+    unsigned long hash;
+    CacheEntry *entry;
+    CacheBlob *blob;
+
+    if (!cache || !key || key->failed) {
+        return NULL;
+    }
+    hash = key_hash(key->bytes, key->length, 2166136261UL);
+
+    blob = malloc(sizeof(CacheBlob));
+    if (!blob) {
+        return NULL;
+    }
+    blob->bytes = malloc(length > 0 ? length : 1);
+    if (!blob->bytes) {
+        free(blob);
+        return NULL;
+    }
+    memcpy(blob->bytes, bytes, length);
+    blob->length = length;
+    blob->flags = flags;
+    blob->refs = 1;
+
+    pthread_mutex_lock(&cache->lock);
+    cache->memory += length;
+    /* A result stored meanwhile by another thread is replaced */
+    entry = find_entry(cache, key, hash);
+    if (entry) {
+        remove_entry(cache, entry);
+    }
+    insert_entry(cache, key, hash, blob);
+    evict(cache);
+    pthread_mutex_unlock(&cache->lock);
+
+    if (cache->directory) {
+        write_file(cache, key, blob);
+    }
+
+    return blob;
+}
+
+/* ____________________________________________________________________________
+    int cache_fits(const PlotCache *cache, size_t length)
+
+    Compares a result size with the memory limit, which never changes.
+   ____________________________________________________________________________
+*/
+int cache_fits(const PlotCache *cache, size_t length) {
+    return cache && length <= cache->max_memory / 4;
+}
+
+/* ____________________________________________________________________________
+    void cache_release(PlotCache *cache, CacheBlob *blob)
+
+    Drops the reference of a caller.
+   ____________________________________________________________________________
+*/
+void cache_release(PlotCache *cache, CacheBlob *blob) {
+    if (!cache || !blob) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    release_locked(cache, blob);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/* ____________________________________________________________________________
+    static void key_append(CacheKey *key, const void *data, size_t length)
+
+    Appends raw bytes, growing the key geometrically.
+   ____________________________________________________________________________
+*/
+static void key_append(CacheKey *key, const void *data, size_t length) {
+    if (key->failed) {
+        return;
+    }
+
+    if (key->length + length > key->capacity) {
+        size_t capacity = key->capacity ? key->capacity : 256;
+        unsigned char *bytes;
+
+        while (capacity < key->length + length) {
+            capacity *= 2;
+        }
+        bytes = realloc(key->bytes, capacity);
+        if (!bytes) {
+            key->failed = 1;
+            return;
+        }
+        key->bytes = bytes;
+        key->capacity = capacity;
+    }
+
+    memcpy(key->bytes + key->length, data, length);
+    key->length += length;
+}
+
+/* ____________________________________________________________________________
+    static unsigned long key_hash(const unsigned char *bytes, size_t length,
+                                  unsigned long basis)
+
+    32-bit FNV-1a over the key, starting from the given offset basis.
+   ____________________________________________________________________________
+*/
+static unsigned long key_hash(const unsigned char *bytes, size_t length,
+                              unsigned long basis) {
+    unsigned long hash = basis;
+    size_t k;
+
+    for (k = 0; k < length; k++) {
+        hash = ((hash ^ bytes[k]) * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    return hash;
+}
+
+/* ____________________________________________________________________________
+    static CacheEntry *find_entry(PlotCache *cache, const CacheKey *key,
+                                  unsigned long hash)
+
+    Returns the memory entry of a key, NULL if there is none. The lock
+    must be held.
+   ____________________________________________________________________________
+*/
+static CacheEntry *find_entry(PlotCache *cache, const CacheKey *key,
+                              unsigned long hash) {
+    CacheEntry *entry = cache->buckets[hash % CACHE_BUCKETS];
+
+    for (; entry; entry = entry->chain) {
+        if (entry->hash == hash && entry->key_length == key->length &&
+            memcmp(entry->key, key->bytes, key->length) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/* ____________________________________________________________________________
+    static int insert_entry(PlotCache *cache, const CacheKey *key,
+                            unsigned long hash, CacheBlob *blob)
+
+    Adds a most recently used entry taking a reference to the result.
+    The lock must be held.
+
+    Returns:
+    int - 1 on success, 0 on allocation failure
+   ____________________________________________________________________________
+*/
+static int insert_entry(PlotCache *cache, const CacheKey *key,
+                        unsigned long hash, CacheBlob *blob) {
+    CacheEntry *entry = malloc(sizeof(CacheEntry));
+    CacheEntry **bucket = &cache->buckets[hash % CACHE_BUCKETS];
+
+    if (!entry) {
+        return 0;
+    }
+    entry->key = malloc(key->length > 0 ? key->length : 1);
+    if (!entry->key) {
+        free(entry);
+        return 0;
+    }
+    memcpy(entry->key, key->bytes, key->length);
+    entry->key_length = key->length;
+    entry->hash = hash;
+    entry->blob = blob;
+    blob->refs++;
+
+    entry->chain = *bucket;
+    *bucket = entry;
+
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    if (cache->newest) {
+        cache->newest->newer = entry;
+    } else {
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+
+    cache->memory += key->length + sizeof(CacheEntry);
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    static void touch_entry(PlotCache *cache, CacheEntry *entry)
+
+    Moves an entry to the front of the use order. The lock must be held.
+   ____________________________________________________________________________
+*/
+static void touch_entry(PlotCache *cache, CacheEntry *entry) {
+    if (cache->newest == entry) {
+        return;
+    }
+
+    /* Unlink, the entry has a newer neighbour */
+    entry->newer->older = entry->older;
+    if (entry->older) {
+        entry->older->newer = entry->newer;
+    } else {
+        cache->oldest = entry->newer;
+    }
+
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    cache->newest->newer = entry;
+    cache->newest = entry;
+}
+
+/* ____________________________________________________________________________
+    static void remove_entry(PlotCache *cache, CacheEntry *entry)
+
+    Unlinks and frees an entry and drops its reference. The lock must
+    be held.
+   ____________________________________________________________________________
+*/
+static void remove_entry(PlotCache *cache, CacheEntry *entry) {
+    CacheEntry **link = &cache->buckets[entry->hash % CACHE_BUCKETS];
+
+    while (*link != entry) {
+        link = &(*link)->chain;
+    }
+    *link = entry->chain;
+
+    if (entry->newer) {
+        entry->newer->older = entry->older;
+    } else {
+        cache->newest = entry->older;
+    }
+    if (entry->older) {
+        entry->older->newer = entry->newer;
+    } else {
+        cache->oldest = entry->newer;
+    }
+
+    cache->memory -= entry->key_length + sizeof(CacheEntry);
+    release_locked(cache, entry->blob);
+    free(entry->key);
+    free(entry);
+}
+
+/* ____________________________________________________________________________
+    static void release_locked(PlotCache *cache, CacheBlob *blob)
+
+    Drops one reference and frees the result with the last one. The
+    lock must be held.
+   ____________________________________________________________________________
+*/
+static void release_locked(PlotCache *cache, CacheBlob *blob) {
+    if (--blob->refs > 0) {
+        return;
+    }
+
+    cache->memory -= blob->length;
+    free(blob->bytes);
+    free(blob);
+}
+
+/* ____________________________________________________________________________
+    static void evict(PlotCache *cache)
+
+    Removes least recently used entries until the memory tier is within
+    its limit. Results still held by callers are freed on release. The
+    lock must be held.
+   ____________________________________________________________________________
+*/
+static void evict(PlotCache *cache) {
+    while (cache->memory > cache->max_memory && cache->oldest) {
+        remove_entry(cache, cache->oldest);
+    }
+}
+
+/* ____________________________________________________________________________
+    static char *file_path(const PlotCache *cache, const CacheKey *key,
+                           const char *suffix)
+
+    Returns the allocated path of the disk file of a key with a suffix,
+    NULL on allocation failure.
+   ____________________________________________________________________________
+*/
+static char *file_path(const PlotCache *cache, const CacheKey *key,
+                       const char *suffix) {
+    char *path = malloc(strlen(cache->directory) + strlen(suffix) + 32);
+
+    if (path) {
+        sprintf(path, "%s/%08lx%08lx%s", cache->directory,
+                key_hash(key->bytes, key->length, 2166136261UL),
+                key_hash(key->bytes, key->length, 0x050C5D1FUL), suffix);
+    }
+    return path;
+}
+
+/* ____________________________________________________________________________
+    static CacheBlob *read_file(PlotCache *cache, const CacheKey *key)
+
+    Loads the result of a key from the disk tier.
+
+    Returns:
+    CacheBlob* - Result with one reference for the caller, NULL if there
+                 is no file, it is damaged or belongs to another key
+   ____________________________________________________________________________
+*/
+static CacheBlob *read_file(PlotCache *cache, const CacheKey *key) {
+    char line[64];
+    unsigned long key_length, length;
+    unsigned flags;
+    unsigned char *stored_key = NULL;
+    CacheBlob *blob = NULL;
+    char *path = file_path(cache, key, ".psc");
+    FILE *file = path ? fopen(path, "rb") : NULL;
+
+    free(path);
+    if (!file) {
+        return NULL;
+    }
+
+    if (!fgets(line, sizeof(line), file) || strcmp(line, CACHE_MAGIC) != 0 ||
+        !fgets(line, sizeof(line), file) ||
+        sscanf(line, "%lu %lu %u", &key_length, &length, &flags) != 3 ||
+        key_length != key->length) {
+        fclose(file);
+        return NULL;
+    }
+
+    stored_key = malloc(key_length > 0 ? key_length : 1);
+    blob = malloc(sizeof(CacheBlob));
+    if (blob) {
+        blob->bytes = malloc(length > 0 ? length : 1);
+    }
+    if (!stored_key || !blob || !blob->bytes ||
+        fread(stored_key, 1, key_length, file) != key_length ||
+        memcmp(stored_key, key->bytes, key_length) != 0 ||
+        fread(blob->bytes, 1, length, file) != length) {
+        if (blob) {
+            free(blob->bytes);
+        }
+        free(blob);
+        free(stored_key);
+        fclose(file);
+        return NULL;
+    }
+
+    blob->length = length;
+    blob->flags = flags;
+    blob->refs = 1;
+    free(stored_key);
+    fclose(file);
+    return blob;
+}
+
+/* ____________________________________________________________________________
+    static void write_file(PlotCache *cache, const CacheKey *key,
+                           const CacheBlob *blob)
+
+    Writes a result to the disk tier. Failures only lose the disk copy.
+
+    Implementation Notes:
+    - The temporary name holds the process id and a per-cache counter,
+      so concurrent writers of the same key do not share a file
+   ____________________________________________________________________________
+*/
+static void write_file(PlotCache *cache, const CacheKey *key,
+                       const CacheBlob *blob) {
+    char suffix[64];
+    unsigned long counter;
+    char *path, *temp;
+    FILE *file;
+    int ok;
+
+    pthread_mutex_lock(&cache->lock);
+    counter = cache->next_temp++;
+    pthread_mutex_unlock(&cache->lock);
+
+    sprintf(suffix, ".%lu.%lu.tmp", (unsigned long)getpid(), counter);
+    path = file_path(cache, key, ".psc");
+    temp = file_path(cache, key, suffix);
+    file = temp ? fopen(temp, "wb") : NULL;
+    if (!path || !file) {
+        free(path);
+        free(temp);
+        return;
+    }
+
+    fputs(CACHE_MAGIC, file);
+    fprintf(file, "%lu %lu %u\n", (unsigned long)key->length,
+            (unsigned long)blob->length, blob->flags);
+    ok = fwrite(key->bytes, 1, key->length, file) == key->length &&
+         fwrite(blob->bytes, 1, blob->length, file) == blob->length;
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok || rename(temp, path) != 0) {
+        remove(temp);
+    }
+
+    free(path);
+    free(temp);
+}
@@ -0,0 +1,171 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header cache.h
+
+    Content-addressed cache of rendered graphs.
+    Results are stored under binary keys that describe everything the
+    output depends on, e.g. the canonical form of a compiled program
+    together with the plotted range. Repeated requests copy the stored
+    bytes instead of sampling and formatting the graph again.
+
+    Key Features:
+    - Memory tier with least recently used eviction under a byte limit
+    - Optional directory tier shared by processes, one file per key
+    - Safe to use from several threads at once
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "parser.h"  /* Compiled program representation */
+
+/* Default byte limit of the memory tier */
+#define CACHE_DEFAULT_MEMORY (64UL * 1024 * 1024)
+
+/*
+  Cache key
+  Growing byte string, filled by the cache_key_* functions.
+
+  Members:
+  bytes    - Key content
+  length   - Number of bytes used
+  capacity - Allocated size of bytes
+  failed   - Nonzero after an allocation failure, the key is then
+             incomplete and must not be used
+*/
+typedef struct {
+    unsigned char *bytes;  /* Key content */
+    size_t length;         /* Bytes used */
+    size_t capacity;       /* Bytes allocated */
+    int failed;            /* Allocation failed */
+} CacheKey;
+
+/*
+  Stored result
+  Handed out by cache_get() and cache_put(), valid until it is passed
+  to cache_release().
+
+  Members:
+  bytes  - Stored data
+  length - Number of bytes
+  flags  - Bits stored together with the data, opaque to the cache
+  refs   - Holders of the result, managed by the cache
+*/
+typedef struct {
+    char *bytes;       /* Stored data */
+    size_t length;     /* Data size */
+    unsigned flags;    /* Caller bits */
+    int refs;          /* Reference count */
+} CacheBlob;
+
+/* Cache of results, defined in cache.c */
+typedef struct PlotCache PlotCache;
+
+/*
+  Key construction
+  cache_key_init() prepares an empty key, the append functions add
+  fields to it and cache_key_free() releases it. Fields are appended
+  with their length, so different field sequences never produce the
+  same key.
+*/
+void cache_key_init(CacheKey *key);
+void cache_key_int(CacheKey *key, long value);
+void cache_key_double(CacheKey *key, double value);
+void cache_key_string(CacheKey *key, const char *text);
+void cache_key_free(CacheKey *key);
+
+/*
+  Appends the canonical form of a compiled program to a key
+
+  Parameters:
+  key  - Key receiving the program
+  prog - Compiled program
+
+  Returns:
+  int - 1 if the program was appended
+        0 if it calls registered functions, their implementations
+          cannot be part of a key
+
+  Notes:
+  - The canonical form is the bytecode, the constant pool and the names
+    and values of the variables the program reads; expressions the
+    compiler reduces to the same program share their key, e.g. "x*1"
+    and "x", or "sin(x)+0" and "sin(x)"
+  - Native code is not part of the key, it computes the same values
+*/
+int cache_key_program(CacheKey *key, const Program *prog);
+
+/*
+  Creates a cache
+
+  Parameters:
+  max_memory - Byte limit of the memory tier
+  directory  - Existing directory of the disk tier, NULL for memory only
+
+  Returns:
+  PlotCache* - New cache, NULL on allocation failure
+*/
+PlotCache *cache_create(size_t max_memory, const char *directory);
+
+/*
+  Releases a cache and all results no longer held by callers
+  Safe to call with NULL pointer.
+*/
+void cache_destroy(PlotCache *cache);
+
+/*
+  Looks a key up
+
+  Returns:
+  CacheBlob* - Stored result, NULL if the key is in neither tier
+
+  Notes:
+  - A result found on disk is added to the memory tier
+  - Files of the disk tier hold their key, a hash collision is a miss
+*/
+CacheBlob *cache_get(PlotCache *cache, const CacheKey *key);
+
+/*
+  Stores a copy of a result
+
+  Parameters:
+  cache  - Cache receiving the result
+  key    - Key of the result
+  bytes  - Data of length bytes
+  length - Number of bytes
+  flags  - Bits returned together with the data
+
+  Returns:
+  CacheBlob* - The stored result, NULL on allocation failure
+
+  Notes:
+  - The result is also written to the disk tier; the file is written
+    under a temporary name and renamed, so concurrent processes never
+    see partial files
+  - Least recently used results are evicted until the memory tier is
+    within its limit again, the new result included
+*/
+CacheBlob *cache_put(PlotCache *cache, const CacheKey *key,
+                     const char *bytes, size_t length, unsigned flags);
+
+/*
+  Tells whether a result of length bytes is worth storing
+  Results larger than a quarter of the memory limit would only evict
+  most of the other entries.
+*/
+int cache_fits(const PlotCache *cache, size_t length);
+
+/*
+  Releases a result returned by cache_get() or cache_put()
+  Safe to call with NULL pointer.
+*/
+void cache_release(PlotCache *cache, CacheBlob *blob);
+
+#endif /* CACHE_H */
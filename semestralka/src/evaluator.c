@@ -0,0 +1,878 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module evaluator.c
+
+    Vectorized evaluation of compiled expressions over whole ranges of x.
+    Every instruction of the program is executed on a column of up to
+    EVAL_BLOCK_SIZE samples before the next instruction is dispatched.
+
+    Implementation Details:
+    - The evaluation stack is an array of columns in one scratch buffer
+    - Arithmetic kernels use AVX, SSE2 or plain C depending on the target
+    - Functions call the same scalar routines as execute_program()
+    - Polynomials run Horner's scheme on vectors of samples
+    - Slots of shared subexpressions are columns as well, and so are
+      the input columns of OP_COLUMN, copied in front of the stack
+    - Programs with native code (see jit.h) skip the interpreter
+    - Parallel variants split the samples into per-thread slices, every
+      thread writes only its own part of the output arrays
+    - Grids are split into tiles that threads take one after another,
+      y is passed to the program as a variable fixed for every row
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#include <pthread.h>  /* Worker threads */
+#include "evaluator.h"
+#include "jit.h"      /* Native code of programs */
+
+/*
+  SIMD abstraction layer
+  Maps a small set of vector operations onto the widest instruction set
+  available at compile time. VEC_LANES is left undefined when no vector
+  instructions are available and only the scalar loops are compiled.
+*/
+#if defined(__AVX__)
+#include <immintrin.h>
+typedef __m256d vec_t;
+#define VEC_LANES 4
+#define vec_load(p)      _mm256_loadu_pd(p)
+#define vec_store(p, v)  _mm256_storeu_pd(p, v)
+#define vec_set1(v)      _mm256_set1_pd(v)
+#define vec_add(a, b)    _mm256_add_pd(a, b)
+#define vec_sub(a, b)    _mm256_sub_pd(a, b)
+#define vec_mul(a, b)    _mm256_mul_pd(a, b)
+#define vec_div(a, b)    _mm256_div_pd(a, b)
+#define vec_xor(a, b)    _mm256_xor_pd(a, b)
+#define vec_andnot(a, b) _mm256_andnot_pd(a, b)
+#define vec_and(a, b)    _mm256_and_pd(a, b)
+#define vec_or(a, b)     _mm256_or_pd(a, b)
+#define vec_eq_zero(v)   _mm256_cmp_pd(v, _mm256_setzero_pd(), _CMP_EQ_OQ)
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+typedef __m128d vec_t;
+#define VEC_LANES 2
+#define vec_load(p)      _mm_loadu_pd(p)
+#define vec_store(p, v)  _mm_storeu_pd(p, v)
+#define vec_set1(v)      _mm_set1_pd(v)
+#define vec_add(a, b)    _mm_add_pd(a, b)
+#define vec_sub(a, b)    _mm_sub_pd(a, b)
+#define vec_mul(a, b)    _mm_mul_pd(a, b)
+#define vec_div(a, b)    _mm_div_pd(a, b)
+#define vec_xor(a, b)    _mm_xor_pd(a, b)
+#define vec_andnot(a, b) _mm_andnot_pd(a, b)
+#define vec_and(a, b)    _mm_and_pd(a, b)
+#define vec_or(a, b)     _mm_or_pd(a, b)
+#define vec_eq_zero(v)   _mm_cmpeq_pd(v, _mm_setzero_pd())
+#endif
+
+/*
+  Evaluation task
+  Contiguous slice of samples evaluated by one thread. The samples are
+  either given explicitly or form an evenly spaced range.
+*/
+typedef struct {
+    const Program *prog;   /* Evaluated program */
+    const double *x;       /* Explicit values of x, NULL for a range */
+    double xmin, step;     /* Range start and sample spacing */
+    int first;             /* Index of the first sample of the slice */
+    int count;             /* Number of samples in the slice */
+    const double *inputs;  /* Input columns of all samples, may be NULL */
+    double *out_values;    /* Output values of all samples */
+    char *out_defined;     /* Output flags of all samples, may be NULL */
+    int raw;               /* Store values without normalizing them */
+    int ok;                /* Result of the slice */
+} EvalTask;
+
+/*
+  Grid evaluation job
+  Shared by all threads evaluating one grid. Only next_tile is written
+  by several threads, the tiles themselves do not overlap.
+*/
+typedef struct {
+    const Program *prog;     /* Evaluated program */
+    double xmin, xstep;      /* Column coordinates */
+    double ymin, ystep;      /* Row coordinates */
+    int columns, rows;       /* Grid size */
+    int tiles_x;             /* Tiles per band of EVAL_TILE_ROWS rows */
+    int num_tiles;           /* Tiles of the grid */
+    int next_tile;           /* First tile not taken yet */
+    double *out_values;      /* Output values of all samples */
+    char *out_defined;       /* Output flags, may be NULL */
+    pthread_mutex_t lock;    /* Guards next_tile */
+} GridJob;
+
+/* Internal function prototypes */
+static int run_points(const Program *prog, const double *x, int n,
+                      const double *inputs, double *out_values,
+                      char *out_defined, int raw, int num_threads);
+static int run_parallel(const EvalTask *task, int num_threads);
+static void *evaluate_worker(void *arg);
+static int evaluate_task(EvalTask *task);
+static void *grid_worker(void *arg);
+static void run_block(const Program *prog, const double *variables,
+                      double *scratch, int len, double *out_values,
+                      char *out_defined, int raw);
+static void column_fill(double *dst, double value, int n);
+static void column_binary(OpCode opcode, double *a, const double *b, int n);
+static void column_unary(OpCode opcode, double *a, int n);
+static void column_call(MathFunction function, double *a, int n);
+static void column_polynomial(const double *coefficients, int degree,
+                              double *a, int n);
+
+/* ____________________________________________________________________________
+    int evaluate_expression_range(const Program *prog, double xmin,
+                                  double xmax, int n, double *out_values,
+                                  char *out_defined)
+    
+    Evaluates a compiled program for n evenly spaced values of x.
+   ____________________________________________________________________________
+*/
+int evaluate_expression_range(const Program *prog, double xmin, double xmax,
+                              int n, double *out_values, char *out_defined) {
+    return evaluate_expression_range_parallel(prog, xmin, xmax, n,
+                                              out_values, out_defined, 1);
+}
+
+/* ____________________________________________________________________________
+    int evaluate_expression_points(const Program *prog, const double *x,
+                                   int n, double *out_values,
+                                   char *out_defined)
+    
+    Evaluates a compiled program for n arbitrary values of x.
+   ____________________________________________________________________________
+*/
+int evaluate_expression_points(const Program *prog, const double *x, int n,
+                               double *out_values, char *out_defined) {
+    return evaluate_expression_points_parallel(prog, x, n, out_values,
+                                               out_defined, 1);
+}
+
+/* ____________________________________________________________________________
+    int evaluate_expression_range_parallel(const Program *prog, double xmin,
+                                           double xmax, int n,
+                                           double *out_values,
+                                           char *out_defined,
+                                           int num_threads)
+    
+    Evaluates n evenly spaced samples, split across worker threads.
+   ____________________________________________________________________________
+*/
+int evaluate_expression_range_parallel(const Program *prog, double xmin,
+                                       double xmax, int n, double *out_values,
+                                       char *out_defined, int num_threads) {
+    EvalTask task;
+
+    if (!prog || !prog->code || n <= 0 || !out_values ||
+        prog->max_stack_depth < 1 || prog->num_inputs > 0) {
+        return 0;
+    }
+
+    task.prog = prog;
+    task.x = NULL;
+    task.xmin = xmin;
+    /* Same sampling formula as the single sample loop in main.c */
+    task.step = (n > 1) ? (xmax - xmin) / (n - 1) : 0;
+    task.first = 0;
+    task.count = n;
+    task.inputs = NULL;
+    task.out_values = out_values;
+    task.out_defined = out_defined;
+    task.raw = 0;
+
+    return run_parallel(&task, num_threads);
+}
+
+/* ____________________________________________________________________________
+    int evaluate_expression_points_parallel(const Program *prog,
+                                            const double *x, int n,
+                                            double *out_values,
+                                            char *out_defined,
+                                            int num_threads)
+    
+    Evaluates n arbitrary samples, split across worker threads.
+   ____________________________________________________________________________
+*/
+int evaluate_expression_points_parallel(const Program *prog, const double *x,
+                                        int n, double *out_values,
+                                        char *out_defined, int num_threads) {
+    if (prog && prog->num_inputs > 0) {
+        return 0;
+    }
+
+    return run_points(prog, x, n, NULL, out_values, out_defined, 0,
+                      num_threads);
+}
+
+/* ____________________________________________________________________________
+    int evaluate_expression_points_raw(const Program *prog, const double *x,
+                                       int n, double *out_values,
+                                       int num_threads)
+    
+    Evaluates n arbitrary samples, values are stored as computed.
+   ____________________________________________________________________________
+*/
+int evaluate_expression_points_raw(const Program *prog, const double *x,
+                                   int n, double *out_values,
+                                   int num_threads) {
+    if (prog && prog->num_inputs > 0) {
+        return 0;
+    }
+
+    return run_points(prog, x, n, NULL, out_values, NULL, 1, num_threads);
+}
+
+/* ____________________________________________________________________________
+    int evaluate_expression_points_inputs(const Program *prog,
+                                          const double *x, int n,
+                                          const double *inputs,
+                                          double *out_values,
+                                          char *out_defined,
+                                          int num_threads)
+    
+    Evaluates n arbitrary samples of a program with input columns.
+   ____________________________________________________________________________
+*/
+int evaluate_expression_points_inputs(const Program *prog, const double *x,
+                                      int n, const double *inputs,
+                                      double *out_values, char *out_defined,
+                                      int num_threads) {
+    if (prog && prog->num_inputs > 0 && !inputs) {
+        return 0;
+    }
+
+    return run_points(prog, x, n, inputs, out_values, out_defined, 0,
+                      num_threads);
+}
+
+/* ____________________________________________________________________________
+    static int run_points(const Program *prog, const double *x, int n,
+                          const double *inputs, double *out_values,
+                          char *out_defined, int raw, int num_threads)
+    
+    Common part of the point evaluators, checks the parameters and sets
+    up the task.
+   ____________________________________________________________________________
+*/
+static int run_points(const Program *prog, const double *x, int n,
+                      const double *inputs, double *out_values,
+                      char *out_defined, int raw, int num_threads) {
+    EvalTask task;
+
+    if (!prog || !prog->code || n <= 0 || !x || !out_values ||
+        prog->max_stack_depth < 1 ||
+        prog->num_inputs < 0 || prog->num_inputs > MAX_PROGRAM_INPUTS) {
+        return 0;
+    }
+
+    task.prog = prog;
+    task.x = x;
+    task.xmin = 0;
+    task.step = 0;
+    task.first = 0;
+    task.count = n;
+    task.inputs = inputs;
+    task.out_values = out_values;
+    task.out_defined = out_defined;
+    task.raw = raw;
+
+    return run_parallel(&task, num_threads);
+}
+
+/* ____________________________________________________________________________
+    static int run_parallel(const EvalTask *task, int num_threads)
+    
+    Splits a task into contiguous slices and evaluates them concurrently.
+    
+    Scheduling Strategy:
+    - Slices are whole multiples of EVAL_BLOCK_SIZE, so every thread
+      processes full blocks except for the last one
+    - No more threads than blocks are used, small tasks stay serial
+    - The calling thread evaluates the first slice itself
+    - A slice whose thread cannot be started is evaluated by the caller
+   ____________________________________________________________________________
+*/
+static int run_parallel(const EvalTask *task, int num_threads) {
+    EvalTask slices[EVAL_MAX_THREADS];
+    pthread_t threads[EVAL_MAX_THREADS];
+    char started[EVAL_MAX_THREADS];
+    int num_blocks = (task->count + EVAL_BLOCK_SIZE - 1) / EVAL_BLOCK_SIZE;
+    int slice_length;
+    int t, ok = 1;
+
+    if (num_threads > EVAL_MAX_THREADS) {
+        num_threads = EVAL_MAX_THREADS;
+    }
+    if (num_threads > num_blocks) {
+        num_threads = num_blocks;
+    }
+    if (num_threads <= 1) {
+        EvalTask serial = *task;
+        return evaluate_task(&serial);
+    }
+
+    slice_length = (num_blocks + num_threads - 1) / num_threads * EVAL_BLOCK_SIZE;
+
+    for (t = 0; t < num_threads; t++) {
+        int first = t * slice_length;
+        int count = task->count - first;
+
+        slices[t] = *task;
+        slices[t].first = first;
+        slices[t].count = (count < slice_length) ? count : slice_length;
+        slices[t].ok = 1;
+        started[t] = 0;
+
+        /* Rounding of slice_length can leave trailing threads idle */
+        if (slices[t].count <= 0 || t == 0) {
+            continue;
+        }
+        started[t] = (char)(pthread_create(&threads[t], NULL, evaluate_worker,
+                                           &slices[t]) == 0);
+    }
+
+    slices[0].ok = evaluate_task(&slices[0]);
+
+    for (t = 1; t < num_threads; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        } else if (slices[t].count > 0) {
+            slices[t].ok = evaluate_task(&slices[t]);
+        }
+        ok = ok && slices[t].ok;
+    }
+
+    return ok && slices[0].ok;
+}
+
+/* ____________________________________________________________________________
+    static void *evaluate_worker(void *arg)
+    
+    Thread entry point, evaluates one slice.
+   ____________________________________________________________________________
+*/
+static void *evaluate_worker(void *arg) {
+    EvalTask *task = arg;
+
+    task->ok = evaluate_task(task);
+    return NULL;
+}
+
+/* ____________________________________________________________________________
+    static int evaluate_task(EvalTask *task)
+    
+    Evaluates one slice of samples in the calling thread.
+    
+    Evaluation Strategy:
+    - Split the slice into blocks of EVAL_BLOCK_SIZE samples
+    - Generate or copy the x column of every block, gather the input
+      columns of the block and run the program
+   ____________________________________________________________________________
+*/
+static int evaluate_task(EvalTask *task) {
+    const Program *prog = task->prog;
+    int outputs = prog->num_outputs > 0 ? prog->num_outputs : 1;
+    int inputs = prog->num_inputs;
+    double *scratch;   /* x column, input columns, stack and slot columns */
+    int base;
+
+    scratch = malloc((size_t)(prog->max_stack_depth + prog->num_slots +
+                              inputs + 1) *
+                     EVAL_BLOCK_SIZE * sizeof(double));
+    if (!scratch) {
+        return 0;
+    }
+
+    for (base = 0; base < task->count; base += EVAL_BLOCK_SIZE) {
+        int len = (task->count - base < EVAL_BLOCK_SIZE) ?
+                  task->count - base : EVAL_BLOCK_SIZE;
+        int first = task->first + base;
+        int i, k;
+
+        if (task->x) {
+            memcpy(scratch, task->x + first, len * sizeof(double));
+        } else {
+            for (i = 0; i < len; i++) {
+                scratch[i] = task->xmin + (first + i) * task->step;
+            }
+        }
+
+        /* Inputs are interleaved like outputs, the columns are not */
+        for (k = 0; k < inputs; k++) {
+            const double *input = task->inputs + (size_t)first * inputs + k;
+            double *column = scratch + (size_t)(k + 1) * EVAL_BLOCK_SIZE;
+
+            for (i = 0; i < len; i++) {
+                column[i] = input[(size_t)i * inputs];
+            }
+        }
+
+        run_block(prog, prog->variables, scratch, len,
+                  task->out_values + (size_t)first * outputs,
+                  task->out_defined ?
+                  task->out_defined + (size_t)first * outputs : NULL,
+                  task->raw);
+    }
+
+    free(scratch);
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    int evaluate_grid(const Program *prog, double xmin, double xmax,
+                      int columns, double ymin, double ymax, int rows,
+                      double *out_values, char *out_defined)
+    
+    Evaluates a compiled program over a grid in the calling thread.
+   ____________________________________________________________________________
+*/
+int evaluate_grid(const Program *prog, double xmin, double xmax, int columns,
+                  double ymin, double ymax, int rows, double *out_values,
+                  char *out_defined) {
+    return evaluate_grid_parallel(prog, xmin, xmax, columns, ymin, ymax, rows,
+                                  out_values, out_defined, 1);
+}
+
+/* ____________________________________________________________________________
+    int evaluate_grid_parallel(const Program *prog, double xmin, double xmax,
+                               int columns, double ymin, double ymax,
+                               int rows, double *out_values,
+                               char *out_defined, int num_threads)
+    
+    Evaluates a compiled program over a grid, split into tiles.
+    
+    Scheduling Strategy:
+    - No more threads than tiles are used
+    - Every thread, the calling one included, runs grid_worker() until
+      all tiles are taken
+    - A thread that cannot be started leaves its tiles to the others
+   ____________________________________________________________________________
+*/
+int evaluate_grid_parallel(const Program *prog, double xmin, double xmax,
+                           int columns, double ymin, double ymax, int rows,
+                           double *out_values, char *out_defined,
+                           int num_threads) {
+    pthread_t threads[EVAL_MAX_THREADS];
+    char started[EVAL_MAX_THREADS];
+    GridJob job;
+    int t;
+
+    if (!prog || !prog->code || columns <= 0 || rows <= 0 || !out_values ||
+        prog->max_stack_depth < 1 || prog->num_inputs > 0) {
+        return 0;
+    }
+
+    job.prog = prog;
+    job.xmin = xmin;
+    job.xstep = (columns > 1) ? (xmax - xmin) / (columns - 1) : 0;
+    job.ymin = ymin;
+    job.ystep = (rows > 1) ? (ymax - ymin) / (rows - 1) : 0;
+    job.columns = columns;
+    job.rows = rows;
+    job.tiles_x = (columns + EVAL_BLOCK_SIZE - 1) / EVAL_BLOCK_SIZE;
+    job.num_tiles = job.tiles_x * ((rows + EVAL_TILE_ROWS - 1) / EVAL_TILE_ROWS);
+    job.next_tile = 0;
+    job.out_values = out_values;
+    job.out_defined = out_defined;
+    pthread_mutex_init(&job.lock, NULL);
+
+    if (num_threads > EVAL_MAX_THREADS) {
+        num_threads = EVAL_MAX_THREADS;
+    }
+    if (num_threads > job.num_tiles) {
+        num_threads = job.num_tiles;
+    }
+
+    for (t = 1; t < num_threads; t++) {
+        started[t] = (char)(pthread_create(&threads[t], NULL, grid_worker,
+                                           &job) == 0);
+    }
+    grid_worker(&job);
+    for (t = 1; t < num_threads; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+
+    pthread_mutex_destroy(&job.lock);
+
+    /* Tiles are only taken by threads that can evaluate them */
+    return job.next_tile == job.num_tiles;
+}
+
+/* ____________________________________________________________________________
+    static void *grid_worker(void *arg)
+    
+    Thread entry point, evaluates tiles of a grid until none is left.
+    
+    Evaluation Strategy:
+    - Take the next tile under the lock, evaluate it without the lock
+    - Every row of a tile is one block, y is set in a private copy of
+      the program variables before the block is run
+   ____________________________________________________________________________
+*/
+static void *grid_worker(void *arg) {
+    GridJob *job = arg;
+    const Program *prog = job->prog;
+    int outputs = prog->num_outputs > 0 ? prog->num_outputs : 1;
+    double variables[MAX_VARIABLES];
+    double *scratch;   /* x column, column stack and slot columns */
+
+    scratch = malloc((size_t)(prog->max_stack_depth + prog->num_slots + 1) *
+                     EVAL_BLOCK_SIZE * sizeof(double));
+    if (!scratch) {
+        return NULL;
+    }
+    memcpy(variables, prog->variables, sizeof(variables));
+
+    for (;;) {
+        int tile, first_column, first_row, last_row, len, row, i;
+
+        pthread_mutex_lock(&job->lock);
+        tile = job->next_tile;
+        if (tile < job->num_tiles) {
+            job->next_tile++;
+        }
+        pthread_mutex_unlock(&job->lock);
+        if (tile >= job->num_tiles) {
+            break;
+        }
+
+        first_column = (tile % job->tiles_x) * EVAL_BLOCK_SIZE;
+        first_row = (tile / job->tiles_x) * EVAL_TILE_ROWS;
+        last_row = first_row + EVAL_TILE_ROWS;
+        if (last_row > job->rows) {
+            last_row = job->rows;
+        }
+        len = job->columns - first_column;
+        if (len > EVAL_BLOCK_SIZE) {
+            len = EVAL_BLOCK_SIZE;
+        }
+
+        /* The rows of a tile share their x column */
+        for (i = 0; i < len; i++) {
+            scratch[i] = job->xmin + (first_column + i) * job->xstep;
+        }
+
+        for (row = first_row; row < last_row; row++) {
+            size_t first = (size_t)row * job->columns + first_column;
+
+            variables[VAR_Y] = job->ymin + row * job->ystep;
+
+            run_block(prog, variables, scratch, len,
+                      job->out_values + first * outputs,
+                      job->out_defined ? job->out_defined + first * outputs : NULL,
+                      0);
+        }
+    }
+
+    free(scratch);
+    return NULL;
+}
+
+/* ____________________________________________________________________________
+    static void run_block(const Program *prog, const double *variables,
+                          double *scratch, int len, double *out_values,
+                          char *out_defined, int raw)
+    
+    Runs the program on one block of samples.
+    
+    Scratch Layout:
+    - The first EVAL_BLOCK_SIZE values hold the x column, filled by caller
+    - Input columns of OP_COLUMN follow, num_inputs of them, also filled
+      by the caller
+    - Columns of the evaluation stack follow, max_stack_depth of them
+    - Slot columns come last, num_slots of them
+    
+    Evaluation Strategy:
+    - Run the native code of the program if it has any; it works on
+      pairs of samples, an odd block repeats its last x
+    - Otherwise run each instruction of the program over the whole block
+    - Copy the remaining columns, one per output, into the interleaved
+      output arrays; undefined values become NaN unless raw is set
+   ____________________________________________________________________________
+*/
+static void run_block(const Program *prog, const double *variables,
+                      double *scratch, int len, double *out_values,
+                      char *out_defined, int raw) {
+    double *x_column = scratch;
+    double *columns = scratch + (size_t)(prog->num_inputs + 1) * EVAL_BLOCK_SIZE;
+    double *slots = columns + (size_t)prog->max_stack_depth * EVAL_BLOCK_SIZE;
+    int outputs = prog->num_outputs > 0 ? prog->num_outputs : 1;
+    int sp = 0;  /* Number of columns on the stack */
+    int i, k;
+
+    if (prog->native) {
+        if (len % 2) {
+            for (k = 0; k <= prog->num_inputs; k++) {
+                double *column = x_column + (size_t)k * EVAL_BLOCK_SIZE;
+                column[len] = column[len - 1];
+            }
+        }
+        jit_run(prog->native, x_column, columns, (len + 1) / 2, variables);
+    } else {
+        for (i = 0; i < prog->code_length; i++) {
+            const Instruction *ins = &prog->code[i];
+            /* x_column precedes the stack, so top is valid even when empty */
+            double *top = columns + (size_t)(sp - 1) * EVAL_BLOCK_SIZE;
+
+            switch (ins->opcode) {
+                case OP_CONST:
+                    column_fill(top + EVAL_BLOCK_SIZE,
+                                prog->constants[ins->operand], len);
+                    sp++;
+                    break;
+                case OP_X:
+                    memcpy(top + EVAL_BLOCK_SIZE, x_column, len * sizeof(double));
+                    sp++;
+                    break;
+                case OP_VAR:
+                    column_fill(top + EVAL_BLOCK_SIZE, variables[ins->operand],
+                                len);
+                    sp++;
+                    break;
+                case OP_COLUMN:
+                    memcpy(top + EVAL_BLOCK_SIZE,
+                           x_column + (size_t)(ins->operand + 1) * EVAL_BLOCK_SIZE,
+                           len * sizeof(double));
+                    sp++;
+                    break;
+                case OP_STORE:
+                    memcpy(slots + (size_t)ins->operand * EVAL_BLOCK_SIZE, top,
+                           len * sizeof(double));
+                    break;
+                case OP_LOAD:
+                    memcpy(top + EVAL_BLOCK_SIZE,
+                           slots + (size_t)ins->operand * EVAL_BLOCK_SIZE,
+                           len * sizeof(double));
+                    sp++;
+                    break;
+                case OP_CALL:
+                    column_call(get_registered_function(ins->operand), top, len);
+                    break;
+                case OP_POLY:
+                    column_polynomial(prog->constants + ins->operand + 1,
+                                      (int)prog->constants[ins->operand],
+                                      top, len);
+                    break;
+                case OP_ADD:
+                case OP_SUB:
+                case OP_MUL:
+                case OP_DIV:
+                case OP_POW:
+                    column_binary(ins->opcode, top - EVAL_BLOCK_SIZE, top, len);
+                    sp--;
+                    break;
+                default:
+                    column_unary(ins->opcode, top, len);
+                    break;
+            }
+        }
+    }
+
+    /* Undefined samples are NaN or infinite, see execute_program() */
+    for (k = 0; k < outputs; k++) {
+        const double *column = columns + (size_t)k * EVAL_BLOCK_SIZE;
+
+        for (i = 0; i < len; i++) {
+            double value = column[i];
+            int defined = !(value != value ||
+                            value == HUGE_VAL || value == -HUGE_VAL);
+
+            out_values[i * outputs + k] = (defined || raw) ? value : 0.0 / 0.0;
+            if (out_defined) {
+                out_defined[i * outputs + k] = (char)defined;
+            }
+        }
+    }
+}
+
+/* ____________________________________________________________________________
+    static void column_fill(double *dst, double value, int n)
+
+    Broadcasts a constant into a column.
+   ____________________________________________________________________________
+*/
+static void column_fill(double *dst, double value, int n) {
+    int i = 0;
+
+#ifdef VEC_LANES
+    vec_t v = vec_set1(value);
+    for (; i + VEC_LANES <= n; i += VEC_LANES) {
+        vec_store(dst + i, v);
+    }
+#endif
+
+    for (; i < n; i++) {
+        dst[i] = value;
+    }
+}
+
+/* ____________________________________________________________________________
+    static void column_binary(OpCode opcode, double *a, const double *b, int n)
+
+    Applies a binary operator element-wise, the result replaces column a.
+
+    Kernel Selection:
+    - Addition, subtraction, multiplication and division are vectorized
+    - Division by zero is masked to NaN without leaving the vector loop
+    - Exponentiation falls back to apply_binary() per sample
+   ____________________________________________________________________________
+*/
+static void column_binary(OpCode opcode, double *a, const double *b, int n) {
+    int i = 0;
+
+    switch (opcode) {
+        case OP_ADD:
+#ifdef VEC_LANES
+            for (; i + VEC_LANES <= n; i += VEC_LANES) {
+                vec_store(a + i, vec_add(vec_load(a + i), vec_load(b + i)));
+            }
+#endif
+            for (; i < n; i++) a[i] += b[i];
+            break;
+        case OP_SUB:
+#ifdef VEC_LANES
+            for (; i + VEC_LANES <= n; i += VEC_LANES) {
+                vec_store(a + i, vec_sub(vec_load(a + i), vec_load(b + i)));
+            }
+#endif
+            for (; i < n; i++) a[i] -= b[i];
+            break;
+        case OP_MUL:
+#ifdef VEC_LANES
+            for (; i + VEC_LANES <= n; i += VEC_LANES) {
+                vec_store(a + i, vec_mul(vec_load(a + i), vec_load(b + i)));
+            }
+#endif
+            for (; i < n; i++) a[i] *= b[i];
+            break;
+        case OP_DIV:
+#ifdef VEC_LANES
+            {
+                vec_t nan = vec_set1(0.0 / 0.0);
+                for (; i + VEC_LANES <= n; i += VEC_LANES) {
+                    vec_t divisor = vec_load(b + i);
+                    vec_t zero_mask = vec_eq_zero(divisor);
+                    vec_t quotient = vec_div(vec_load(a + i), divisor);
+                    /* Select NaN in lanes where the divisor is zero */
+                    vec_store(a + i, vec_or(vec_andnot(zero_mask, quotient),
+                                            vec_and(zero_mask, nan)));
+                }
+            }
+#endif
+            for (; i < n; i++) a[i] = apply_binary(OP_DIV, a[i], b[i]);
+            break;
+        default:
+            for (; i < n; i++) a[i] = apply_binary(opcode, a[i], b[i]);
+            break;
+    }
+}
+
+/* ____________________________________________________________________________
+    static void column_unary(OpCode opcode, double *a, int n)
+
+    Applies a unary operator element-wise in place.
+
+    Kernel Selection:
+    - Negation and absolute value are sign bit operations
+    - Squares are vectorized multiplications
+    - Other functions use apply_unary() per sample
+   ____________________________________________________________________________
+*/
+static void column_unary(OpCode opcode, double *a, int n) {
+    int i = 0;
+#ifdef VEC_LANES
+    vec_t sign_mask = vec_set1(-0.0);
+#endif
+
+    switch (opcode) {
+        case OP_NEG:
+#ifdef VEC_LANES
+            for (; i + VEC_LANES <= n; i += VEC_LANES) {
+                vec_store(a + i, vec_xor(vec_load(a + i), sign_mask));
+            }
+#endif
+            for (; i < n; i++) a[i] = -a[i];
+            break;
+        case OP_ABS:
+#ifdef VEC_LANES
+            for (; i + VEC_LANES <= n; i += VEC_LANES) {
+                vec_store(a + i, vec_andnot(sign_mask, vec_load(a + i)));
+            }
+#endif
+            for (; i < n; i++) a[i] = fabs(a[i]);
+            break;
+        case OP_SQUARE:
+#ifdef VEC_LANES
+            for (; i + VEC_LANES <= n; i += VEC_LANES) {
+                vec_t v = vec_load(a + i);
+                vec_store(a + i, vec_mul(v, v));
+            }
+#endif
+            for (; i < n; i++) a[i] *= a[i];
+            break;
+        default:
+            for (; i < n; i++) a[i] = apply_unary(opcode, a[i]);
+            break;
+    }
+}
+
+/* ____________________________________________________________________________
+    static void column_call(MathFunction function, double *a, int n)
+
+    Applies a registered function element-wise in place.
+   ____________________________________________________________________________
+*/
+static void column_call(MathFunction function, double *a, int n) {
+    int i;
+
+    for (i = 0; i < n; i++) {
+        a[i] = function(a[i]);
+    }
+}
+
+/* ____________________________________________________________________________
+    static void column_polynomial(const double *coefficients, int degree,
+                                  double *a, int n)
+
+    Evaluates a polynomial element-wise in place.
+
+    Kernel Notes:
+    - Horner's scheme in the order of execute_program(), the lanes of a
+      vector hold different samples, so results are identical
+    - Two vectors are processed at once to hide the latency of the
+      dependent multiply-add chain
+   ____________________________________________________________________________
+*/
+static void column_polynomial(const double *coefficients, int degree,
+                              double *a, int n) {
+    int i = 0, k;
+
+#ifdef VEC_LANES
+    for (; i + 2 * VEC_LANES <= n; i += 2 * VEC_LANES) {
+        vec_t t0 = vec_load(a + i), t1 = vec_load(a + i + VEC_LANES);
+        vec_t v0 = vec_set1(coefficients[0]), v1 = v0;
+        for (k = 1; k <= degree; k++) {
+            vec_t c = vec_set1(coefficients[k]);
+            v0 = vec_add(vec_mul(v0, t0), c);
+            v1 = vec_add(vec_mul(v1, t1), c);
+        }
+        vec_store(a + i, v0);
+        vec_store(a + i + VEC_LANES, v1);
+    }
+#endif
+
+    for (; i < n; i++) {
+        double t = a[i], value = coefficients[0];
+        for (k = 1; k <= degree; k++) {
+            value = value * t + coefficients[k];
+        }
+        a[i] = value;
+    }
+}
@@ -0,0 +1,215 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header evaluator.h
+
+    Vectorized evaluation of compiled expressions over whole ranges of x.
+    Instead of running the complete program once per sample, every
+    instruction is applied to a block of samples at a time ("column at
+    a time"). The evaluation stack therefore holds columns of values and
+    the arithmetic inner loops use SIMD instructions where available.
+
+    Key Features:
+    - Block-wise evaluation of programs from compile_expression()
+    - Evenly spaced ranges or arbitrary sets of x values
+    - SSE2 and AVX kernels for arithmetic operators
+    - Portable scalar fallback for other targets
+    - Optional multi-threaded evaluation of large ranges
+    - Tiled evaluation of two-dimensional grids over x and y
+    - Precomputed input columns for programs of compile_sweep()
+    - Per-sample undefined point detection
+
+    Build Notes:
+    - SSE2 is used automatically on x86-64
+    - AVX kernels are used when compiled with -mavx2 (or -mavx)
+    - Requires POSIX threads (-pthread)
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "parser.h"  /* Compiled program representation */
+
+/*
+  Number of samples processed by one instruction at a time.
+  Large enough to amortize the instruction dispatch, small enough for
+  the whole column stack of a typical expression to stay in L1/L2 cache.
+*/
+#define EVAL_BLOCK_SIZE 512
+
+/* Upper limit of worker threads used by one parallel evaluation */
+#define EVAL_MAX_THREADS 256
+
+/*
+  Number of grid rows in one tile of evaluate_grid().
+  A tile is EVAL_BLOCK_SIZE columns wide, so every row of a tile is one
+  block and a tile is the unit of work handed to a thread.
+*/
+#define EVAL_TILE_ROWS 16
+
+/*
+  Evaluates a compiled expression over an evenly spaced range of x
+  Samples the interval [xmin, xmax] in n points (both ends included) and
+  stores the value and the definition status of every sample.
+
+  Parameters:
+  prog        - Pointer to program produced by compile_expression()
+  xmin, xmax  - Range of the variable x
+  n           - Number of samples, must be positive
+  out_values  - Output array of n * prog->num_outputs values, the
+                results of one sample are stored next to each other
+                Undefined samples are set to NaN
+  out_defined - Output array of n * prog->num_outputs flags, may be NULL
+                1 for defined samples, 0 for undefined ones
+
+  Returns:
+  int - 1 if the range was evaluated
+        0 on invalid parameters or memory allocation failure
+
+  Notes:
+  - Results are identical to calling execute_program() for every sample
+  - Programs of compile_expressions() yield one value per expression,
+    the value of expression k of sample i is out_values[i * num_outputs + k]
+  - Allocates one scratch buffer per call
+
+  Thread Safety:
+  - Function is reentrant, the program is only read
+*/
+int evaluate_expression_range(const Program *prog, double xmin, double xmax,
+                              int n, double *out_values, char *out_defined);
+
+/*
+  Evaluates a compiled expression for an arbitrary set of x values
+  Same as evaluate_expression_range() but the samples are given
+  explicitly, e.g. by an adaptive sampler refining parts of a range.
+
+  Parameters:
+  prog        - Pointer to program produced by compile_expression()
+  x           - Array of n values of x, in any order
+  n           - Number of samples, must be positive
+  out_values  - Output array of n * prog->num_outputs values, NaN for
+                undefined samples
+  out_defined - Output array of n * prog->num_outputs flags, may be NULL
+
+  Returns:
+  int - 1 if the samples were evaluated
+        0 on invalid parameters or memory allocation failure
+*/
+int evaluate_expression_points(const Program *prog, const double *x, int n,
+                               double *out_values, char *out_defined);
+
+/*
+  Parallel variants of the range evaluators
+  Split the samples into contiguous slices evaluated by up to num_threads
+  threads. Every thread writes into its own slice of the output arrays.
+
+  Parameters:
+  num_threads - Maximum number of threads, including the calling one
+                Values below 2 evaluate serially in the calling thread
+
+  Returns:
+  int - 1 if all samples were evaluated
+        0 on invalid parameters or memory allocation failure
+
+  Notes:
+  - Results are identical to the serial functions
+  - At most one thread per EVAL_BLOCK_SIZE samples is started, and at
+    most EVAL_MAX_THREADS threads in total
+  - Slices whose thread cannot be started are evaluated by the caller
+  - Registered functions (see register_function()) are called from
+    several threads at once and must not modify shared state
+*/
+int evaluate_expression_range_parallel(const Program *prog, double xmin,
+                                       double xmax, int n, double *out_values,
+                                       char *out_defined, int num_threads);
+int evaluate_expression_points_parallel(const Program *prog, const double *x,
+                                        int n, double *out_values,
+                                        char *out_defined, int num_threads);
+
+/*
+  Evaluates samples without normalizing undefined values
+  Same as evaluate_expression_points_parallel(), but every value is
+  stored exactly as computed, infinities included, and no flags are
+  produced. Used for the invariant program of compile_sweep(), whose
+  outputs become the input columns of the frame program.
+
+  Returns:
+  int - 1 if the samples were evaluated
+        0 on invalid parameters or memory allocation failure
+*/
+int evaluate_expression_points_raw(const Program *prog, const double *x,
+                                   int n, double *out_values,
+                                   int num_threads);
+
+/*
+  Evaluates samples of a program that reads input columns
+  Same as evaluate_expression_points_parallel() for the frame program of
+  compile_sweep().
+
+  Parameters:
+  inputs - Array of n * prog->num_inputs values, input k of sample i is
+           inputs[i * num_inputs + k]; the layout produced by
+           evaluate_expression_points_raw() for the same x; may be NULL
+           if the program has no inputs
+
+  Returns:
+  int - 1 if the samples were evaluated
+        0 on invalid parameters or memory allocation failure
+
+  Notes:
+  - The other evaluators reject programs with input columns, and so
+    does execute_program()
+*/
+int evaluate_expression_points_inputs(const Program *prog, const double *x,
+                                      int n, const double *inputs,
+                                      double *out_values, char *out_defined,
+                                      int num_threads);
+
+/*
+  Evaluates a compiled expression over a grid of x and y values
+  Samples [xmin, xmax] in columns points and [ymin, ymax] in rows points
+  (both ends included). The variable y (slot VAR_Y) takes the value of
+  the row, all other variables keep their values in prog->variables.
+
+  Parameters:
+  prog         - Pointer to program produced by compile_expression()
+  xmin, xmax   - Range of the variable x
+  columns      - Number of samples along x, must be positive
+  ymin, ymax   - Range of the variable y
+  rows         - Number of samples along y, must be positive
+  out_values   - Output array of rows * columns * prog->num_outputs
+                 values, row by row starting at ymin; the value of
+                 expression k at column i of row j is
+                 out_values[(j * columns + i) * num_outputs + k]
+                 Undefined samples are set to NaN
+  out_defined  - Output array of flags laid out like out_values, may
+                 be NULL
+  num_threads  - Maximum number of threads, including the calling one
+
+  Returns:
+  int - 1 if the grid was evaluated
+        0 on invalid parameters or memory allocation failure
+
+  Notes:
+  - The grid is split into tiles of EVAL_TILE_ROWS rows and
+    EVAL_BLOCK_SIZE columns, threads take the next free tile until none
+    is left, so tiles that are expensive to evaluate do not hold up
+    threads that got cheap ones
+  - Results are identical to the serial function and, for every sample,
+    to execute_program() with prog->variables[VAR_Y] set to its y
+*/
+int evaluate_grid(const Program *prog, double xmin, double xmax, int columns,
+                  double ymin, double ymax, int rows, double *out_values,
+                  char *out_defined);
+int evaluate_grid_parallel(const Program *prog, double xmin, double xmax,
+                           int columns, double ymin, double ymax, int rows,
+                           double *out_values, char *out_defined,
+                           int num_threads);
+
+#endif /* EVALUATOR_H */
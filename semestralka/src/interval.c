@@ -0,0 +1,573 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module interval.c
+
+    Interval arithmetic evaluation of compiled expressions.
+
+    Implementation Details:
+    - The program is interpreted like in execute_program(), with an
+      enclosure instead of a value on every stack position
+    - Monotonic functions map the bounds, the others also check the
+      points where they turn or have a pole
+    - Unbounded results use infinite bounds, an infinite bound may mean
+      an overflow, so such results are never marked continuous
+    - Every computed bound is moved outwards by a few units in the last
+      place, enough for the rounding of the C library functions
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#include "interval.h"
+
+/* Pi with more digits than a double holds */
+#define INTERVAL_PI 3.14159265358979323846
+
+/* Relative widening of computed bounds */
+#define INTERVAL_SLACK (8 * DBL_EPSILON)
+
+/* Magnitude beyond which periodic functions are not analysed, the
+   spacing of doubles there exceeds the precision of the turning points */
+#define INTERVAL_PERIODIC_LIMIT 1e15
+
+/* Internal function prototypes */
+static Interval make_interval(double lo, double hi, int continuous);
+static Interval empty_interval(void);
+static Interval unbounded_interval(void);
+static Interval clamp_interval(Interval r, double lo, double hi);
+static double widen_down(double value);
+static double widen_up(double value);
+static double product(double a, double b);
+static int contains_point(double lo, double hi, double offset, double period);
+static Interval interval_mul(Interval a, Interval b);
+static Interval interval_div(Interval a, Interval b);
+static Interval interval_pow(Interval a, Interval b);
+static Interval interval_periodic(OpCode opcode, Interval a);
+static Interval interval_binary(OpCode opcode, Interval a, Interval b);
+static Interval interval_unary(OpCode opcode, Interval a);
+static Interval interval_polynomial(const double *coefficients, int degree,
+                                    Interval a);
+
+/* ____________________________________________________________________________
+    int evaluate_interval(const Program *prog, double a, double b,
+                          Interval *out)
+
+    Interprets compiled bytecode for the whole range [a, b].
+   ____________________________________________________________________________
+*/
+int evaluate_interval(const Program *prog, double a, double b, Interval *out) {
+    Interval stack[MAX_STACK_DEPTH];
+    Interval slots[MAX_PROGRAM_SLOTS];
+    int outputs;
+    int sp = 0;  /* Number of enclosures on the stack */
+    int i;
+
+    if (!prog || !prog->code || !out || !(a <= b) ||
+        prog->max_stack_depth > MAX_STACK_DEPTH ||
+        prog->num_slots > MAX_PROGRAM_SLOTS) {
+        return 0;
+    }
+    outputs = prog->num_outputs > 0 ? prog->num_outputs : 1;
+
+    for (i = 0; i < prog->code_length; i++) {
+        const Instruction *ins = &prog->code[i];
+
+        switch (ins->opcode) {
+            case OP_CONST:
+            case OP_VAR: {
+                /* Constants and fixed variables are point intervals */
+                double value = ins->opcode == OP_CONST ?
+                               prog->constants[ins->operand] :
+                               prog->variables[ins->operand];
+                if (value != value || value == HUGE_VAL || value == -HUGE_VAL) {
+                    stack[sp++] = empty_interval();
+                } else {
+                    stack[sp].lo = value;
+                    stack[sp].hi = value;
+                    stack[sp].empty = 0;
+                    stack[sp].continuous = 1;
+                    sp++;
+                }
+                break;
+            }
+            case OP_X:
+                stack[sp].lo = a;
+                stack[sp].hi = b;
+                stack[sp].empty = 0;
+                stack[sp].continuous = 1;
+                sp++;
+                break;
+            case OP_STORE:
+                slots[ins->operand] = stack[sp - 1];
+                break;
+            case OP_LOAD:
+                stack[sp++] = slots[ins->operand];
+                break;
+            case OP_COLUMN:
+                /* Precomputed values are not known to the analysis */
+                stack[sp++] = unbounded_interval();
+                break;
+            case OP_CALL:
+                /* Registered functions are not known to the analysis */
+                stack[sp - 1] = unbounded_interval();
+                break;
+            case OP_POLY:
+                stack[sp - 1] = interval_polynomial(
+                    prog->constants + ins->operand + 1,
+                    (int)prog->constants[ins->operand], stack[sp - 1]);
+                break;
+            case OP_ADD:
+            case OP_SUB:
+            case OP_MUL:
+            case OP_DIV:
+            case OP_POW:
+                sp--;
+                stack[sp - 1] = interval_binary(ins->opcode, stack[sp - 1], stack[sp]);
+                break;
+            default:
+                stack[sp - 1] = interval_unary(ins->opcode, stack[sp - 1]);
+                break;
+        }
+    }
+
+    for (i = 0; i < outputs; i++) {
+        out[i] = stack[i];
+    }
+
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    static Interval make_interval(double lo, double hi, int continuous)
+
+    Builds the enclosure of computed bounds.
+
+    Implementation Notes:
+    - NaN bounds come from inf - inf or similar, they become unbounded
+    - Bounds that overflowed to the same side mean no value is finite,
+      i.e. the expression is undefined everywhere
+   ____________________________________________________________________________
+*/
+static Interval make_interval(double lo, double hi, int continuous) {
+    Interval r;
+
+    if (lo != lo) {
+        lo = -HUGE_VAL;
+    }
+    if (hi != hi) {
+        hi = HUGE_VAL;
+    }
+    if (lo == HUGE_VAL || hi == -HUGE_VAL) {
+        return empty_interval();
+    }
+
+    r.lo = widen_down(lo);
+    r.hi = widen_up(hi);
+    r.empty = 0;
+    r.continuous = continuous && lo != -HUGE_VAL && hi != HUGE_VAL;
+    return r;
+}
+
+/* ____________________________________________________________________________
+    static Interval empty_interval(void)
+
+    Returns the enclosure of an expression undefined everywhere.
+   ____________________________________________________________________________
+*/
+static Interval empty_interval(void) {
+    Interval r;
+
+    r.lo = HUGE_VAL;
+    r.hi = -HUGE_VAL;
+    r.empty = 1;
+    r.continuous = 0;
+    return r;
+}
+
+/* ____________________________________________________________________________
+    static Interval unbounded_interval(void)
+
+    Returns the enclosure of an expression nothing is known about.
+   ____________________________________________________________________________
+*/
+static Interval unbounded_interval(void) {
+    Interval r;
+
+    r.lo = -HUGE_VAL;
+    r.hi = HUGE_VAL;
+    r.empty = 0;
+    r.continuous = 0;
+    return r;
+}
+
+/* ____________________________________________________________________________
+    static Interval clamp_interval(Interval r, double lo, double hi)
+
+    Limits widened bounds to the range of a bounded function.
+   ____________________________________________________________________________
+*/
+static Interval clamp_interval(Interval r, double lo, double hi) {
+    if (!r.empty) {
+        if (r.lo < lo) r.lo = lo;
+        if (r.hi > hi) r.hi = hi;
+    }
+    return r;
+}
+
+/* ____________________________________________________________________________
+    static double widen_down(double value)
+    static double widen_up(double value)
+
+    Move a bound outwards by INTERVAL_SLACK relative to its magnitude,
+    the smallest normal number keeps bounds near zero safe.
+   ____________________________________________________________________________
+*/
+static double widen_down(double value) {
+    if (value == HUGE_VAL || value == -HUGE_VAL) {
+        return value;
+    }
+    return value - (fabs(value) * INTERVAL_SLACK + DBL_MIN);
+}
+
+static double widen_up(double value) {
+    if (value == HUGE_VAL || value == -HUGE_VAL) {
+        return value;
+    }
+    return value + (fabs(value) * INTERVAL_SLACK + DBL_MIN);
+}
+
+/* ____________________________________________________________________________
+    static double product(double a, double b)
+
+    Multiplies two bounds, a zero bound gives zero even against an
+    infinite one, since all actual values are finite.
+   ____________________________________________________________________________
+*/
+static double product(double a, double b) {
+    return (a == 0 || b == 0) ? 0 : a * b;
+}
+
+/* ____________________________________________________________________________
+    static int contains_point(double lo, double hi, double offset,
+                              double period)
+
+    Checks whether offset + k * period lies in [lo, hi] for some integer k.
+   ____________________________________________________________________________
+*/
+static int contains_point(double lo, double hi, double offset, double period) {
+    double k = ceil((lo - offset) / period);
+
+    return offset + k * period <= hi;
+}
+
+/* ____________________________________________________________________________
+    static Interval interval_mul(Interval a, Interval b)
+
+    Multiplication, the extremes are products of the bounds.
+   ____________________________________________________________________________
+*/
+static Interval interval_mul(Interval a, Interval b) {
+    double p1 = product(a.lo, b.lo), p2 = product(a.lo, b.hi);
+    double p3 = product(a.hi, b.lo), p4 = product(a.hi, b.hi);
+    double lo = p1, hi = p1;
+
+    if (p2 < lo) lo = p2;
+    if (p3 < lo) lo = p3;
+    if (p4 < lo) lo = p4;
+    if (p2 > hi) hi = p2;
+    if (p3 > hi) hi = p3;
+    if (p4 > hi) hi = p4;
+
+    return make_interval(lo, hi, a.continuous && b.continuous);
+}
+
+/* ____________________________________________________________________________
+    static Interval interval_div(Interval a, Interval b)
+
+    Division as multiplication by the reciprocal of the divisor.
+
+    Pole Handling:
+    - A divisor of exactly zero is undefined everywhere
+    - A divisor touching zero from one side has a one-sided unbounded
+      reciprocal, one containing zero an unbounded one
+    - Both make the quotient possibly discontinuous
+   ____________________________________________________________________________
+*/
+static Interval interval_div(Interval a, Interval b) {
+    Interval reciprocal;
+
+    if (b.lo > 0 || b.hi < 0) {
+        reciprocal = make_interval(1 / b.hi, 1 / b.lo, b.continuous);
+        return interval_mul(a, reciprocal);
+    }
+
+    if (b.lo == 0 && b.hi == 0) {
+        return empty_interval();
+    }
+
+    reciprocal.lo = (b.lo == 0) ? widen_down(1 / b.hi) : -HUGE_VAL;
+    reciprocal.hi = (b.hi == 0) ? widen_up(1 / b.lo) : HUGE_VAL;
+    reciprocal.empty = 0;
+    reciprocal.continuous = 0;
+    return interval_mul(a, reciprocal);
+}
+
+/* ____________________________________________________________________________
+    static Interval interval_pow(Interval a, Interval b)
+
+    Exponentiation with the domain rules of pow().
+
+    Cases:
+    - Constant integer exponent: monotonic on both sides of zero, even
+      positive powers have their minimum at zero, negative powers have
+      a pole at zero
+    - Constant fractional exponent: defined for nonnegative bases only,
+      negative exponents have a pole at zero
+    - Variable exponent and positive base: exp(b * ln(a))
+    - Anything else is not analysed
+   ____________________________________________________________________________
+*/
+static Interval interval_pow(Interval a, Interval b) {
+    int continuous = a.continuous && b.continuous;
+
+    if (b.lo == b.hi) {
+        double c = b.lo;
+        double at_lo, at_hi, lo, hi;
+
+        if (c == 0) {
+            return make_interval(1, 1, a.continuous);
+        }
+
+        if (c == floor(c)) {
+            int contains_zero = a.lo <= 0 && a.hi >= 0;
+
+            if (c < 0 && contains_zero) {
+                if (a.lo == 0 && a.hi == 0) {
+                    return empty_interval();
+                }
+                return unbounded_interval();
+            }
+
+            at_lo = pow(a.lo, c);
+            at_hi = pow(a.hi, c);
+            lo = (at_lo < at_hi) ? at_lo : at_hi;
+            hi = (at_lo < at_hi) ? at_hi : at_lo;
+
+            /* Even powers turn at zero */
+            if (contains_zero && fmod(c, 2) == 0) {
+                lo = 0;
+            }
+            return make_interval(lo, hi, continuous);
+        }
+
+        /* Fractional exponents need a nonnegative base */
+        if (a.hi < 0) {
+            return empty_interval();
+        }
+        if (a.lo < 0) {
+            a.lo = 0;
+            continuous = 0;
+        }
+        if (c < 0) {
+            if (a.hi == 0) {
+                return empty_interval();
+            }
+            if (a.lo == 0) {
+                return make_interval(pow(a.hi, c), HUGE_VAL, 0);
+            }
+            return make_interval(pow(a.hi, c), pow(a.lo, c), continuous);
+        }
+        return make_interval(pow(a.lo, c), pow(a.hi, c), continuous);
+    }
+
+    if (a.lo > 0) {
+        return interval_unary(OP_EXP, interval_mul(b, interval_unary(OP_LN, a)));
+    }
+
+    return unbounded_interval();
+}
+
+/* ____________________________________________________________________________
+    static Interval interval_periodic(OpCode opcode, Interval a)
+
+    Sine and cosine, the bounds are the values at the ends unless a
+    maximum or minimum of the function lies inside.
+   ____________________________________________________________________________
+*/
+static Interval interval_periodic(OpCode opcode, Interval a) {
+    double max_at = (opcode == OP_SIN) ? INTERVAL_PI / 2 : 0;
+    double min_at = max_at + INTERVAL_PI;
+    double at_lo, at_hi, lo, hi;
+
+    if (a.hi - a.lo >= 2 * INTERVAL_PI ||
+        fabs(a.lo) > INTERVAL_PERIODIC_LIMIT ||
+        fabs(a.hi) > INTERVAL_PERIODIC_LIMIT) {
+        return clamp_interval(make_interval(-1, 1, a.continuous), -1, 1);
+    }
+
+    at_lo = (opcode == OP_SIN) ? sin(a.lo) : cos(a.lo);
+    at_hi = (opcode == OP_SIN) ? sin(a.hi) : cos(a.hi);
+    lo = (at_lo < at_hi) ? at_lo : at_hi;
+    hi = (at_lo < at_hi) ? at_hi : at_lo;
+
+    if (contains_point(a.lo, a.hi, max_at, 2 * INTERVAL_PI)) {
+        hi = 1;
+    }
+    if (contains_point(a.lo, a.hi, min_at, 2 * INTERVAL_PI)) {
+        lo = -1;
+    }
+
+    return clamp_interval(make_interval(lo, hi, a.continuous), -1, 1);
+}
+
+/* ____________________________________________________________________________
+    static Interval interval_binary(OpCode opcode, Interval a, Interval b)
+
+    Applies a binary operator to two enclosures.
+   ____________________________________________________________________________
+*/
+static Interval interval_binary(OpCode opcode, Interval a, Interval b) {
+    int continuous = a.continuous && b.continuous;
+
+    /* Undefined operands make every result undefined, see apply_binary() */
+    if (a.empty || b.empty) {
+        return empty_interval();
+    }
+
+    switch (opcode) {
+        case OP_ADD: return make_interval(a.lo + b.lo, a.hi + b.hi, continuous);
+        case OP_SUB: return make_interval(a.lo - b.hi, a.hi - b.lo, continuous);
+        case OP_MUL: return interval_mul(a, b);
+        case OP_DIV: return interval_div(a, b);
+        case OP_POW: return interval_pow(a, b);
+        default:     return unbounded_interval();
+    }
+}
+
+/* ____________________________________________________________________________
+    static Interval interval_polynomial(const double *coefficients,
+                                        int degree, Interval a)
+
+    Encloses a polynomial by running Horner's scheme on enclosures, every
+    step is widened like the operators it consists of.
+   ____________________________________________________________________________
+*/
+static Interval interval_polynomial(const double *coefficients, int degree,
+                                    Interval a) {
+    Interval r, c;
+    int k;
+
+    r.lo = r.hi = coefficients[0];
+    r.empty = 0;
+    r.continuous = 1;
+    c = r;
+
+    for (k = 1; k <= degree; k++) {
+        c.lo = c.hi = coefficients[k];
+        r = interval_binary(OP_ADD, interval_binary(OP_MUL, r, a), c);
+    }
+
+    return r;
+}
+
+/* ____________________________________________________________________________
+    static Interval interval_unary(OpCode opcode, Interval a)
+
+    Applies a unary operator or built-in function to an enclosure.
+
+    Domain Handling:
+    - ln and log: the part at or below zero is cut off, touching zero
+      makes the result unbounded below and possibly discontinuous
+    - tan: a pole inside the range makes the result unbounded
+    - asin and acos: the part outside [-1, 1] is cut off
+    - A range completely outside the domain is undefined everywhere
+   ____________________________________________________________________________
+*/
+static Interval interval_unary(OpCode opcode, Interval a) {
+    int c = a.continuous;
+
+    if (a.empty) {
+        return a;
+    }
+
+    switch (opcode) {
+        case OP_NEG:
+            return make_interval(-a.hi, -a.lo, c);
+        case OP_ABS:
+            if (a.lo >= 0) return make_interval(a.lo, a.hi, c);
+            if (a.hi <= 0) return make_interval(-a.hi, -a.lo, c);
+            return make_interval(0, (-a.lo > a.hi) ? -a.lo : a.hi, c);
+        case OP_SQUARE: {
+            Interval two;
+            two.lo = two.hi = 2;
+            two.empty = 0;
+            two.continuous = 1;
+            return interval_pow(a, two);
+        }
+        case OP_EXP:
+            return make_interval(exp(a.lo), exp(a.hi), c);
+        case OP_LN:
+        case OP_LOG: {
+            double (*logarithm)(double) = (opcode == OP_LN) ? log : log10;
+            if (a.hi <= 0) {
+                return empty_interval();
+            }
+            if (a.lo <= 0) {
+                return make_interval(-HUGE_VAL, logarithm(a.hi), 0);
+            }
+            return make_interval(logarithm(a.lo), logarithm(a.hi), c);
+        }
+        case OP_SIN:
+        case OP_COS:
+            return interval_periodic(opcode, a);
+        case OP_TAN: {
+            double at_lo, at_hi;
+            if (a.hi - a.lo >= INTERVAL_PI ||
+                fabs(a.lo) > INTERVAL_PERIODIC_LIMIT ||
+                fabs(a.hi) > INTERVAL_PERIODIC_LIMIT ||
+                contains_point(a.lo, a.hi, INTERVAL_PI / 2, INTERVAL_PI)) {
+                return unbounded_interval();
+            }
+            at_lo = tan(a.lo);
+            at_hi = tan(a.hi);
+            /* A pole missed by rounding shows as a decreasing pair */
+            if (at_lo > at_hi) {
+                return unbounded_interval();
+            }
+            return make_interval(at_lo, at_hi, c);
+        }
+        case OP_ASIN:
+        case OP_ACOS: {
+            double lo = a.lo, hi = a.hi;
+            if (hi < -1 || lo > 1) {
+                return empty_interval();
+            }
+            if (lo < -1) { lo = -1; c = 0; }
+            if (hi > 1) { hi = 1; c = 0; }
+            if (opcode == OP_ASIN) {
+                return make_interval(asin(lo), asin(hi), c);
+            }
+            return make_interval(acos(hi), acos(lo), c);
+        }
+        case OP_ATAN:
+            return make_interval(atan(a.lo), atan(a.hi), c);
+        case OP_SINH:
+            return make_interval(sinh(a.lo), sinh(a.hi), c);
+        case OP_COSH: {
+            double at_lo = cosh(a.lo), at_hi = cosh(a.hi);
+            double hi = (at_lo > at_hi) ? at_lo : at_hi;
+            if (a.lo <= 0 && a.hi >= 0) {
+                return make_interval(1, hi, c);
+            }
+            return make_interval((at_lo < at_hi) ? at_lo : at_hi, hi, c);
+        }
+        case OP_TANH:
+            return clamp_interval(make_interval(tanh(a.lo), tanh(a.hi), c), -1, 1);
+        default:
+            return unbounded_interval();
+    }
+}
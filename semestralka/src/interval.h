@@ -0,0 +1,79 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header interval.h
+
+    Interval arithmetic evaluation of compiled expressions.
+    Instead of a value for one x, the program is run on the whole range
+    [a, b] and yields an enclosure of all values the expression takes
+    there, together with a guarantee whether it is continuous.
+
+    Key Features:
+    - Enclosures for all operators and KNOWN_FUNCTIONS entries
+    - Poles of division, tan, ln and log detected inside the range
+    - Bounds widened after every operation to cover rounding errors
+    - Programs of several expressions and shared subexpressions
+
+    Typical Usage:
+    - Skip parts of the plot whose values are all outside the window
+    - Tell steep but continuous parts of a curve from real jumps
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+#include "parser.h"  /* Compiled program representation */
+
+/*
+  Enclosure of an expression over a range of x
+
+  Members:
+  lo, hi     - Every defined value lies in [lo, hi], the bounds may be
+               infinite when the values are not bounded
+  empty      - Nonzero if the expression is undefined for all x
+  continuous - Nonzero if the expression is defined and continuous for
+               all x of the range, so its curve needs no break there
+
+  Notes:
+  - lo and hi are meaningless for empty enclosures
+  - continuous = 0 does not mean there is a break, only that the
+    arithmetic could not exclude one
+*/
+typedef struct {
+    double lo, hi;     /* Bounds of the defined values */
+    int empty;         /* Undefined everywhere */
+    int continuous;    /* Defined and continuous everywhere */
+} Interval;
+
+/*
+  Evaluates a compiled program over a range of x
+
+  Parameters:
+  prog - Pointer to program produced by compile_expression() or
+         compile_expressions()
+  a, b - Range of x, a <= b; a == b encloses a single sample
+  out  - Output array of prog->num_outputs enclosures, one per
+         compiled expression
+
+  Returns:
+  int - 1 if the program was evaluated
+        0 on invalid parameters
+
+  Notes:
+  - Registered functions (OP_CALL) are not analysed, their results
+    are unbounded and possibly discontinuous
+  - Sample values of execute_program() for x in [a, b] always lie in
+    the enclosure of a defined expression
+
+  Thread Safety:
+  - Function is reentrant, the program is only read
+*/
+int evaluate_interval(const Program *prog, double a, double b, Interval *out);
+
+#endif /* INTERVAL_H */
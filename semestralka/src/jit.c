@@ -0,0 +1,647 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module jit.c
+
+    Translation of compiled expressions into native x86-64 machine code.
+
+    Implementation Details:
+    - Stack position p of the program is kept in register xmm<p>, two
+      samples per register; xmm14 and xmm15 are scratch registers
+    - Polynomials are unrolled into multiply-add chains
+    - Calls clobber all XMM registers, the live stack positions are
+      spilled to the frame before and reloaded after every call
+    - Slots of shared subexpressions live in the stack frame
+    - Masks and constants are stored as pairs in front of the code, the
+      code addresses them through r13
+    - Variables other than x are read through r12 and broadcast into
+      both lanes, so one compiled function serves every row of a grid
+    - Input columns of OP_COLUMN follow the x column in the scratch
+      buffer of the evaluator, they are read relative to rbx
+
+    Generated Function:
+    - void f(const double *x, double *columns, long pairs,
+             const double *table, const double *variables),
+      System V calling convention
+    - rbx walks through x, r14 through the columns, r15 counts pairs
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#if defined(__x86_64__) && !defined(PLOT_NO_JIT) && \
+    (defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__))
+#define JIT_SUPPORTED
+#define _DEFAULT_SOURCE  /* MAP_ANONYMOUS */
+#include <sys/mman.h>    /* Executable memory */
+#endif
+
+#include "jit.h"
+#include "evaluator.h"   /* Column layout of the evaluator */
+
+/* Code generation switch, see jit_set_enabled() */
+static int jit_enabled = 1;
+
+#ifdef JIT_SUPPORTED
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+/* Signature of the generated function */
+typedef void (*NativeEntry)(const double *x, double *columns, long pairs,
+                            const double *table, const double *variables);
+
+/*
+  Native code
+  One anonymous mapping holding the constant table followed by the code.
+*/
+struct NativeCode {
+    void *memory;          /* Start of the mapping, the table */
+    size_t size;           /* Length of the mapping */
+    NativeEntry entry;     /* First instruction of the code */
+};
+
+/* Registers */
+#define REG_RAX  0
+#define REG_RCX  1
+#define REG_RDX  2
+#define REG_RBX  3
+#define REG_RSP  4
+#define REG_RSI  6
+#define REG_RDI  7
+#define REG_R8   8
+#define REG_R12 12
+#define REG_R13 13
+#define REG_R14 14
+#define REG_R15 15
+
+/* Scratch XMM registers */
+#define XMM_T0  14
+#define XMM_T1  15
+
+/* SSE2 opcodes, the byte following 0x0F */
+#define SSE_MOVU_LOAD   0x10
+#define SSE_MOVU_STORE  0x11
+#define SSE_UNPCKL      0x14
+#define SSE_MOVA_LOAD   0x28
+#define SSE_MOVA_STORE  0x29
+#define SSE_AND         0x54
+#define SSE_ANDN        0x55
+#define SSE_OR          0x56
+#define SSE_XOR         0x57
+#define SSE_ADD         0x58
+#define SSE_MUL         0x59
+#define SSE_SUB         0x5C
+#define SSE_DIV         0x5E
+#define SSE_CMP         0xC2
+
+/* Mandatory prefixes: packed double and scalar double */
+#define PREFIX_PD  0x66
+#define PREFIX_SD  0xF2
+
+/* Constant table: sign mask, NaN, then the constant pool */
+#define TABLE_SIGN      0
+#define TABLE_NAN       16
+#define TABLE_CONSTANTS 32
+
+/* Stack frame: spilled registers, two argument pairs, slots */
+#define FRAME_SPILL  0
+#define FRAME_ARG0   (JIT_MAX_DEPTH * 16)
+#define FRAME_ARG1   (FRAME_ARG0 + 16)
+#define FRAME_SLOTS  (FRAME_ARG1 + 16)
+
+/*
+  Code buffer
+  Growing array of generated bytes.
+*/
+typedef struct {
+    unsigned char *bytes;  /* Generated code */
+    size_t length;         /* Number of bytes */
+    size_t capacity;       /* Allocated bytes */
+    int error;             /* Nonzero after an allocation failure */
+} CodeBuffer;
+
+/* Internal function prototypes */
+static void emit_byte(CodeBuffer *c, unsigned value);
+static void emit_u32(CodeBuffer *c, unsigned long value);
+static void emit_pointer(CodeBuffer *c, const void *pointer);
+static void emit_sse_rr(CodeBuffer *c, unsigned prefix, unsigned opcode,
+                        int dst, int src);
+static void emit_sse_rm(CodeBuffer *c, unsigned prefix, unsigned opcode,
+                        int reg, int base, long disp);
+static void emit_mov_rr(CodeBuffer *c, int dst, int src);
+static void emit_push(CodeBuffer *c, int reg);
+static void emit_pop(CodeBuffer *c, int reg);
+static void emit_call(CodeBuffer *c, const void *function, int opcode,
+                      int binary);
+static void emit_lane_calls(CodeBuffer *c, const void *function, int opcode,
+                            int binary, int live);
+static const void *libm_function(OpCode opcode);
+static int generate(CodeBuffer *c, const Program *prog);
+
+/* ____________________________________________________________________________
+    int jit_compile(Program *prog)
+
+    Generates native code for a program and attaches it.
+
+    Compilation Steps:
+    - Generate the code into a heap buffer
+    - Map anonymous writable memory, copy the table and the code
+    - Make the mapping read-only and executable
+   ____________________________________________________________________________
+*/
+int jit_compile(Program *prog) {
+    NativeCode *code;
+    CodeBuffer buffer;
+    size_t table_size;
+    unsigned char *memory;
+    int i;
+
+    if (!jit_enabled || !prog || !prog->code || prog->native ||
+        prog->max_stack_depth > JIT_MAX_DEPTH ||
+        prog->num_slots > MAX_PROGRAM_SLOTS) {
+        return 0;
+    }
+
+    memset(&buffer, 0, sizeof(buffer));
+    if (!generate(&buffer, prog)) {
+        free(buffer.bytes);
+        return 0;
+    }
+
+    code = malloc(sizeof(NativeCode));
+    if (!code) {
+        free(buffer.bytes);
+        return 0;
+    }
+
+    table_size = TABLE_CONSTANTS + (size_t)prog->num_constants * 16;
+    code->size = table_size + buffer.length;
+    code->memory = mmap(NULL, code->size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code->memory == MAP_FAILED) {
+        free(code);
+        free(buffer.bytes);
+        return 0;
+    }
+
+    /* Table of 16-byte pairs, the mapping is page aligned */
+    memory = code->memory;
+    {
+        double *table = code->memory;
+        table[0] = table[1] = -0.0;
+        table[2] = table[3] = 0.0 / 0.0;
+        for (i = 0; i < prog->num_constants; i++) {
+            table[4 + 2 * i] = table[5 + 2 * i] = prog->constants[i];
+        }
+    }
+    memcpy(memory + table_size, buffer.bytes, buffer.length);
+    free(buffer.bytes);
+
+    if (mprotect(code->memory, code->size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(code->memory, code->size);
+        free(code);
+        return 0;
+    }
+
+    /* Object to function pointer conversion through memcpy, ISO C has
+       no cast between them */
+    {
+        void *start = memory + table_size;
+        memcpy(&code->entry, &start, sizeof(code->entry));
+    }
+
+    prog->native = code;
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    void jit_run(const NativeCode *code, const double *x, double *columns,
+                 int pairs, const double *variables)
+
+    Calls the generated function.
+   ____________________________________________________________________________
+*/
+void jit_run(const NativeCode *code, const double *x, double *columns,
+             int pairs, const double *variables) {
+    code->entry(x, columns, pairs, code->memory, variables);
+}
+
+/* ____________________________________________________________________________
+    void jit_release(NativeCode *code)
+
+    Unmaps the code and releases its descriptor.
+   ____________________________________________________________________________
+*/
+void jit_release(NativeCode *code) {
+    if (!code) {
+        return;
+    }
+
+    munmap(code->memory, code->size);
+    free(code);
+}
+
+/* ____________________________________________________________________________
+    static int generate(CodeBuffer *c, const Program *prog)
+
+    Translates the bytecode instruction by instruction.
+
+    Code Layout:
+    - Prologue: save callee-saved registers, reserve the frame, move
+      the arguments into callee-saved registers
+    - Loop over the pairs: the program body, then one store per output
+    - Epilogue: release the frame, restore registers
+   ____________________________________________________________________________
+*/
+static int generate(CodeBuffer *c, const Program *prog) {
+    long frame = FRAME_SLOTS + (long)prog->num_slots * 16;
+    int outputs = prog->num_outputs > 0 ? prog->num_outputs : 1;
+    size_t skip_patch, loop_start;
+    long offset;
+    int sp = 0;  /* Number of values on the stack */
+    int i;
+
+    /* Prologue, five pushes keep rsp 16-byte aligned for calls */
+    emit_push(c, REG_RBX);
+    emit_push(c, REG_R12);
+    emit_push(c, REG_R13);
+    emit_push(c, REG_R14);
+    emit_push(c, REG_R15);
+    emit_byte(c, 0x48); emit_byte(c, 0x81); emit_byte(c, 0xEC);  /* sub rsp */
+    emit_u32(c, (unsigned long)frame);
+    emit_mov_rr(c, REG_RBX, REG_RDI);
+    emit_mov_rr(c, REG_R14, REG_RSI);
+    emit_mov_rr(c, REG_R15, REG_RDX);
+    emit_mov_rr(c, REG_R13, REG_RCX);
+    emit_mov_rr(c, REG_R12, REG_R8);
+
+    /* test r15, r15; jz epilogue */
+    emit_byte(c, 0x4D); emit_byte(c, 0x85); emit_byte(c, 0xFF);
+    emit_byte(c, 0x0F); emit_byte(c, 0x84);
+    skip_patch = c->length;
+    emit_u32(c, 0);
+
+    loop_start = c->length;
+    for (i = 0; i < prog->code_length; i++) {
+        const Instruction *ins = &prog->code[i];
+        int top = sp - 1;
+
+        switch (ins->opcode) {
+            case OP_CONST:
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVA_LOAD, sp, REG_R13,
+                            TABLE_CONSTANTS + 16L * ins->operand);
+                sp++;
+                break;
+            case OP_X:
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVU_LOAD, sp, REG_RBX, 0);
+                sp++;
+                break;
+            case OP_VAR:
+                /* movsd, then unpcklpd copies the value to the high lane */
+                emit_sse_rm(c, PREFIX_SD, SSE_MOVU_LOAD, sp, REG_R12,
+                            8L * ins->operand);
+                emit_sse_rr(c, PREFIX_PD, SSE_UNPCKL, sp, sp);
+                sp++;
+                break;
+            case OP_COLUMN:
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVU_LOAD, sp, REG_RBX,
+                            8L * EVAL_BLOCK_SIZE * (ins->operand + 1));
+                sp++;
+                break;
+            case OP_STORE:
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVA_STORE, top, REG_RSP,
+                            FRAME_SLOTS + 16L * ins->operand);
+                break;
+            case OP_LOAD:
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVA_LOAD, sp, REG_RSP,
+                            FRAME_SLOTS + 16L * ins->operand);
+                sp++;
+                break;
+            case OP_ADD:
+                emit_sse_rr(c, PREFIX_PD, SSE_ADD, top - 1, top);
+                sp--;
+                break;
+            case OP_SUB:
+                emit_sse_rr(c, PREFIX_PD, SSE_SUB, top - 1, top);
+                sp--;
+                break;
+            case OP_MUL:
+                emit_sse_rr(c, PREFIX_PD, SSE_MUL, top - 1, top);
+                sp--;
+                break;
+            case OP_DIV:
+                /* Quotient where the divisor is nonzero, NaN elsewhere,
+                   the same as apply_binary() */
+                emit_sse_rr(c, PREFIX_PD, SSE_MOVA_LOAD, XMM_T0, top);
+                emit_sse_rr(c, PREFIX_PD, SSE_XOR, XMM_T1, XMM_T1);
+                emit_sse_rr(c, PREFIX_PD, SSE_CMP, XMM_T0, XMM_T1);
+                emit_byte(c, 0);  /* Predicate: equal */
+                emit_sse_rr(c, PREFIX_PD, SSE_DIV, top - 1, top);
+                emit_sse_rr(c, PREFIX_PD, SSE_MOVA_LOAD, XMM_T1, XMM_T0);
+                emit_sse_rr(c, PREFIX_PD, SSE_ANDN, XMM_T0, top - 1);
+                emit_sse_rm(c, PREFIX_PD, SSE_AND, XMM_T1, REG_R13, TABLE_NAN);
+                emit_sse_rr(c, PREFIX_PD, SSE_OR, XMM_T0, XMM_T1);
+                emit_sse_rr(c, PREFIX_PD, SSE_MOVA_LOAD, top - 1, XMM_T0);
+                sp--;
+                break;
+            case OP_POW:
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVA_STORE, top - 1, REG_RSP, FRAME_ARG0);
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVA_STORE, top, REG_RSP, FRAME_ARG1);
+                emit_lane_calls(c, (const void *)0, OP_POW, 1, top - 1);
+                sp--;
+                break;
+            case OP_NEG:
+                emit_sse_rm(c, PREFIX_PD, SSE_XOR, top, REG_R13, TABLE_SIGN);
+                break;
+            case OP_ABS:
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVA_LOAD, XMM_T0, REG_R13, TABLE_SIGN);
+                emit_sse_rr(c, PREFIX_PD, SSE_ANDN, XMM_T0, top);
+                emit_sse_rr(c, PREFIX_PD, SSE_MOVA_LOAD, top, XMM_T0);
+                break;
+            case OP_SQUARE:
+                emit_sse_rr(c, PREFIX_PD, SSE_MUL, top, top);
+                break;
+            case OP_POLY: {
+                /* Horner's scheme in xmm14, coefficients follow the degree */
+                int degree = (int)prog->constants[ins->operand];
+                int k;
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVA_LOAD, XMM_T0, REG_R13,
+                            TABLE_CONSTANTS + 16L * (ins->operand + 1));
+                for (k = 1; k <= degree; k++) {
+                    emit_sse_rr(c, PREFIX_PD, SSE_MUL, XMM_T0, top);
+                    emit_sse_rm(c, PREFIX_PD, SSE_ADD, XMM_T0, REG_R13,
+                                TABLE_CONSTANTS + 16L * (ins->operand + 1 + k));
+                }
+                emit_sse_rr(c, PREFIX_PD, SSE_MOVA_LOAD, top, XMM_T0);
+                break;
+            }
+            default:
+                emit_sse_rm(c, PREFIX_PD, SSE_MOVA_STORE, top, REG_RSP, FRAME_ARG0);
+                if (ins->opcode == OP_CALL) {
+                    MathFunction function = get_registered_function(ins->operand);
+                    if (!function) {
+                        return 0;
+                    }
+                    emit_lane_calls(c, (const void *)&function, -1, 0, top);
+                } else if (libm_function(ins->opcode)) {
+                    emit_lane_calls(c, libm_function(ins->opcode), -1, 0, top);
+                } else {
+                    emit_lane_calls(c, (const void *)0, ins->opcode, 0, top);
+                }
+                break;
+        }
+    }
+
+    /* Outputs into their columns */
+    for (i = 0; i < outputs; i++) {
+        emit_sse_rm(c, PREFIX_PD, SSE_MOVU_STORE, i, REG_R14,
+                    (long)i * EVAL_BLOCK_SIZE * (long)sizeof(double));
+    }
+
+    /* add rbx, 16; add r14, 16; dec r15; jnz loop */
+    emit_byte(c, 0x48); emit_byte(c, 0x83); emit_byte(c, 0xC3); emit_byte(c, 16);
+    emit_byte(c, 0x49); emit_byte(c, 0x83); emit_byte(c, 0xC6); emit_byte(c, 16);
+    emit_byte(c, 0x49); emit_byte(c, 0xFF); emit_byte(c, 0xCF);
+    emit_byte(c, 0x0F); emit_byte(c, 0x85);
+    offset = (long)loop_start - (long)(c->length + 4);
+    emit_u32(c, (unsigned long)offset);
+
+    /* Epilogue */
+    if (!c->error) {
+        offset = (long)c->length - (long)(skip_patch + 4);
+        c->bytes[skip_patch] = (unsigned char)(offset & 0xFF);
+        c->bytes[skip_patch + 1] = (unsigned char)((offset >> 8) & 0xFF);
+        c->bytes[skip_patch + 2] = (unsigned char)((offset >> 16) & 0xFF);
+        c->bytes[skip_patch + 3] = (unsigned char)((offset >> 24) & 0xFF);
+    }
+    emit_byte(c, 0x48); emit_byte(c, 0x81); emit_byte(c, 0xC4);  /* add rsp */
+    emit_u32(c, (unsigned long)frame);
+    emit_pop(c, REG_R15);
+    emit_pop(c, REG_R14);
+    emit_pop(c, REG_R13);
+    emit_pop(c, REG_R12);
+    emit_pop(c, REG_RBX);
+    emit_byte(c, 0xC3);  /* ret */
+
+    return !c->error;
+}
+
+/* ____________________________________________________________________________
+    static const void *libm_function(OpCode opcode)
+
+    Returns a pointer to a MathFunction variable holding the C library
+    function of a built-in without domain checks, NULL for the others.
+   ____________________________________________________________________________
+*/
+static const void *libm_function(OpCode opcode) {
+    static const MathFunction functions[] = { exp, sin, cos, atan, sinh, cosh, tanh };
+
+    switch (opcode) {
+        case OP_EXP:  return &functions[0];
+        case OP_SIN:  return &functions[1];
+        case OP_COS:  return &functions[2];
+        case OP_ATAN: return &functions[3];
+        case OP_SINH: return &functions[4];
+        case OP_COSH: return &functions[5];
+        case OP_TANH: return &functions[6];
+        default:      return NULL;
+    }
+}
+
+/* ____________________________________________________________________________
+    static void emit_lane_calls(CodeBuffer *c, const void *function,
+                                int opcode, int binary, int live)
+
+    Applies a scalar function to both lanes of the argument pair(s) in the
+    frame and loads the result pair into register xmm<live>.
+
+    Parameters:
+    function - Pointer to a MathFunction variable, NULL to call
+               apply_unary() or apply_binary() with the opcode
+    binary   - Nonzero if a second argument pair is passed
+    live     - Number of stack positions below the result to preserve
+   ____________________________________________________________________________
+*/
+static void emit_lane_calls(CodeBuffer *c, const void *function, int opcode,
+                            int binary, int live) {
+    int lane, i;
+
+    for (i = 0; i < live; i++) {
+        emit_sse_rm(c, PREFIX_PD, SSE_MOVA_STORE, i, REG_RSP, FRAME_SPILL + 16L * i);
+    }
+
+    for (lane = 0; lane < 2; lane++) {
+        emit_sse_rm(c, PREFIX_SD, SSE_MOVU_LOAD, 0, REG_RSP, FRAME_ARG0 + 8L * lane);
+        if (binary) {
+            emit_sse_rm(c, PREFIX_SD, SSE_MOVU_LOAD, 1, REG_RSP, FRAME_ARG1 + 8L * lane);
+        }
+        emit_call(c, function, opcode, binary);
+        emit_sse_rm(c, PREFIX_SD, SSE_MOVU_STORE, 0, REG_RSP, FRAME_ARG0 + 8L * lane);
+    }
+
+    emit_sse_rm(c, PREFIX_PD, SSE_MOVA_LOAD, live, REG_RSP, FRAME_ARG0);
+    for (i = 0; i < live; i++) {
+        emit_sse_rm(c, PREFIX_PD, SSE_MOVA_LOAD, i, REG_RSP, FRAME_SPILL + 16L * i);
+    }
+}
+
+/* ____________________________________________________________________________
+    static void emit_call(CodeBuffer *c, const void *function, int opcode,
+                          int binary)
+
+    Emits an absolute call, the arguments are already in xmm0 and xmm1.
+   ____________________________________________________________________________
+*/
+static void emit_call(CodeBuffer *c, const void *function, int opcode,
+                      int binary) {
+    if (function) {
+        MathFunction target;
+        memcpy(&target, function, sizeof(target));
+        emit_byte(c, 0x48); emit_byte(c, 0xB8);  /* mov rax, imm64 */
+        emit_pointer(c, &target);
+    } else if (binary) {
+        double (*target)(OpCode, double, double) = apply_binary;
+        emit_byte(c, 0xBF);  /* mov edi, imm32 */
+        emit_u32(c, (unsigned long)opcode);
+        emit_byte(c, 0x48); emit_byte(c, 0xB8);
+        emit_pointer(c, &target);
+    } else {
+        double (*target)(OpCode, double) = apply_unary;
+        emit_byte(c, 0xBF);
+        emit_u32(c, (unsigned long)opcode);
+        emit_byte(c, 0x48); emit_byte(c, 0xB8);
+        emit_pointer(c, &target);
+    }
+    emit_byte(c, 0xFF); emit_byte(c, 0xD0);  /* call rax */
+}
+
+/* ____________________________________________________________________________
+    Instruction encoders
+
+    Implementation Notes:
+    - SSE instructions: mandatory prefix, optional REX, 0x0F, opcode,
+      ModRM; memory operands always use a 32-bit displacement
+    - rsp as a base register needs a SIB byte
+    - emit_pointer() copies the bytes of a pointer variable, x86-64 is
+      little endian like the immediate operands
+   ____________________________________________________________________________
+*/
+static void emit_byte(CodeBuffer *c, unsigned value) {
+    if (c->length == c->capacity) {
+        size_t capacity = c->capacity ? c->capacity * 2 : 1024;
+        unsigned char *bytes = realloc(c->bytes, capacity);
+        if (!bytes) {
+            c->error = 1;
+            return;
+        }
+        c->bytes = bytes;
+        c->capacity = capacity;
+    }
+    c->bytes[c->length++] = (unsigned char)value;
+}
+
+static void emit_u32(CodeBuffer *c, unsigned long value) {
+    emit_byte(c, value & 0xFF);
+    emit_byte(c, (value >> 8) & 0xFF);
+    emit_byte(c, (value >> 16) & 0xFF);
+    emit_byte(c, (value >> 24) & 0xFF);
+}
+
+static void emit_pointer(CodeBuffer *c, const void *pointer) {
+    unsigned char bytes[8];
+    int i;
+
+    memcpy(bytes, pointer, sizeof(bytes));
+    for (i = 0; i < 8; i++) {
+        emit_byte(c, bytes[i]);
+    }
+}
+
+static void emit_sse_rr(CodeBuffer *c, unsigned prefix, unsigned opcode,
+                        int dst, int src) {
+    emit_byte(c, prefix);
+    if (dst >= 8 || src >= 8) {
+        emit_byte(c, 0x40 | ((dst >= 8) << 2) | (src >= 8));
+    }
+    emit_byte(c, 0x0F);
+    emit_byte(c, opcode);
+    emit_byte(c, 0xC0 | ((dst & 7) << 3) | (src & 7));
+}
+
+static void emit_sse_rm(CodeBuffer *c, unsigned prefix, unsigned opcode,
+                        int reg, int base, long disp) {
+    emit_byte(c, prefix);
+    if (reg >= 8 || base >= 8) {
+        emit_byte(c, 0x40 | ((reg >= 8) << 2) | (base >= 8));
+    }
+    emit_byte(c, 0x0F);
+    emit_byte(c, opcode);
+    emit_byte(c, 0x80 | ((reg & 7) << 3) | (base & 7));
+    if ((base & 7) == REG_RSP) {
+        emit_byte(c, 0x24);
+    }
+    emit_u32(c, (unsigned long)disp);
+}
+
+static void emit_mov_rr(CodeBuffer *c, int dst, int src) {
+    emit_byte(c, 0x48 | ((src >= 8) << 2) | (dst >= 8));
+    emit_byte(c, 0x89);
+    emit_byte(c, 0xC0 | ((src & 7) << 3) | (dst & 7));
+}
+
+static void emit_push(CodeBuffer *c, int reg) {
+    if (reg >= 8) {
+        emit_byte(c, 0x41);
+    }
+    emit_byte(c, 0x50 | (reg & 7));
+}
+
+static void emit_pop(CodeBuffer *c, int reg) {
+    if (reg >= 8) {
+        emit_byte(c, 0x41);
+    }
+    emit_byte(c, 0x58 | (reg & 7));
+}
+
+#else /* JIT_SUPPORTED */
+
+/* Without a code generator every program stays interpreted */
+struct NativeCode {
+    int unused;  /* Never instantiated */
+};
+
+int jit_compile(Program *prog) {
+    (void)prog;
+    (void)jit_enabled;
+    return 0;
+}
+
+void jit_run(const NativeCode *code, const double *x, double *columns,
+             int pairs, const double *variables) {
+    (void)code;
+    (void)x;
+    (void)columns;
+    (void)pairs;
+    (void)variables;
+}
+
+void jit_release(NativeCode *code) {
+    (void)code;
+}
+
+#endif /* JIT_SUPPORTED */
+
+/* ____________________________________________________________________________
+    void jit_set_enabled(int enabled)
+
+    Switches code generation on or off.
+   ____________________________________________________________________________
+*/
+void jit_set_enabled(int enabled) {
+    jit_enabled = enabled;
+}
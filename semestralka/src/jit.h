@@ -0,0 +1,91 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header jit.h
+
+    Translation of compiled expressions into native x86-64 machine code.
+    The bytecode of a program is turned into a function that evaluates
+    two samples per iteration with SSE2 instructions. Stack positions of
+    the program live in XMM registers, so no instruction is dispatched
+    at run time any more.
+
+    Key Features:
+    - Arithmetic, negation, absolute value and squares inline in SSE2
+    - Built-in functions call the C library, functions with domain
+      checks call apply_unary(), so results match the interpreter
+    - Code is written into an anonymous mapping that is made executable
+      only after it has been written
+
+    Build Notes:
+    - Available on x86-64 POSIX systems (System V calling convention)
+    - Compile with -DPLOT_NO_JIT to leave the code generator out
+    - Elsewhere jit_compile() fails and programs are interpreted
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef JIT_H
+#define JIT_H
+
+#include "parser.h"  /* Compiled program representation */
+
+/* Deepest evaluation stack kept in registers, deeper programs are
+   interpreted */
+#define JIT_MAX_DEPTH 14
+
+/*
+  Translates a program into native code
+  On success the code is attached to prog->native and used by the
+  evaluator (see evaluator.h) instead of the bytecode interpreter.
+
+  Parameters:
+  prog - Program produced by compile_expression() or compile_expressions()
+
+  Returns:
+  int - 1 if native code was attached
+        0 if the program stays interpreted: unsupported platform, code
+          generation disabled, stack deeper than JIT_MAX_DEPTH or
+          memory allocation failure
+
+  Notes:
+  - The code is released together with the program by free_program()
+*/
+int jit_compile(Program *prog);
+
+/*
+  Runs native code on a block of samples
+
+  Parameters:
+  code    - Native code of a program
+  x       - Values of x, 2 * pairs of them; input column k of OP_COLUMN
+            starts at x[(k + 1) * EVAL_BLOCK_SIZE]
+  columns - Output columns, value k of sample i is stored at
+            columns[k * EVAL_BLOCK_SIZE + i]
+  pairs   - Number of sample pairs
+  variables - Values of the variable slots read by OP_VAR, e.g.
+            prog->variables or a copy with y set for one grid row
+
+  Notes:
+  - Results are bit for bit the ones of execute_program()
+  - Undefined values are not normalized, see run_block() in evaluator.c
+*/
+void jit_run(const NativeCode *code, const double *x, double *columns,
+             int pairs, const double *variables);
+
+/*
+  Enables or disables code generation for later jit_compile() calls
+  Code generation is enabled by default where it is supported.
+*/
+void jit_set_enabled(int enabled);
+
+/*
+  Releases native code
+  Safe to call with NULL pointer.
+*/
+void jit_release(NativeCode *code);
+
+#endif /* JIT_H */
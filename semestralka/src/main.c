@@ -20,15 +20,17 @@
 #include <string.h>  /* String manipulation functions */
 #include <stdbool.h> /* Boolean type and constants (true, false) */
 #include <ctype.h>   /* Character type functions */
-#include <errno.h>   /* Error number definitions */
 #include "parser.h"  /* Mathematical expression parser functions */
-#include "postscript.h" /* PostScript graph generation utilities */
+#include "evaluator.h" /* Evaluation thread limits */
+#include "plot.h"    /* Plotting pipeline */
+#include "batch.h"   /* Batch plotting mode */
+#include "jit.h"     /* Native code generation switch */
+#include "postscript.h" /* Contour level limit */
 
 /* Function prototypes */
-int parse_command_args(int argc, char *argv[], 
-                      char *function, char **output_file,
-                      double *xmin, double *xmax, 
-                      double *ymin, double *ymax);
+int parse_command_args(int argc, char *argv[], PlotJob *job,
+                       int *num_threads, const char **batch_file,
+                       const char **cache_dir);
 
 /* ____________________________________________________________________________
  
@@ -37,88 +39,65 @@ int parse_command_args(int argc, char *argv[],
 */
 
 int main(int argc, char *argv[]) {
-    char function[1024];
-    char *output_file;
-    double xmin, xmax, ymin, ymax;
+    PlotJob job;
+    int num_threads;
+    const char *batch_file;
+    const char *cache_dir;
 
     /* Parse command line arguments */
-    int parse_result = parse_command_args(argc, argv, function, &output_file,
-                                        &xmin, &xmax, &ymin, &ymax);
+    int parse_result = parse_command_args(argc, argv, &job, &num_threads,
+                                          &batch_file, &cache_dir);
     if (parse_result != 0) {
         return parse_result;
     }
 
-    /* Validate the provided mathematical expression */
-    if (validate_expression(function) == 0) {
-        fprintf(stderr, "Error: Invalid mathematical expression.\n");
-        return 2;
+    /* Many plots from a manifest */
+    if (batch_file) {
+        return run_batch(batch_file, num_threads, cache_dir);
+    }
+
+    /* A graph written by an earlier run needs no compilation */
+    if (cache_dir) {
+        job.cache = cache_create(CACHE_DEFAULT_MEMORY, cache_dir);
+    }
+    int result = restore_plot(&job);
+    if (result >= 0) {
+        free_plot(&job);
+        cache_destroy(job.cache);
+        return result;
+    }
+
+    /* Validate and compile the expression once, samples are evaluated
+       from bytecode */
+    result = compile_plot(&job);
+    if (result != 0) {
+        cache_destroy(job.cache);
+        return result;
     }
 
     /* Ensure the output file is writable */
-    FILE *file = fopen(output_file, "w");
+    FILE *file = fopen(job.output_file, "w");
     if (!file) {
-        fprintf(stderr, "Error: Cannot create or write to output file '%s'.\n", output_file);
+        fprintf(stderr, "Error: Cannot create or write to output file '%s'.\n", job.output_file);
+        free_plot(&job);
+        cache_destroy(job.cache);
         return 3;
     }
 
     if (fclose(file) != 0) {
         fprintf(stderr, "Error: Failed to close file.\n");
+        free_plot(&job);
+        cache_destroy(job.cache);
         return 3; /* Use an appropriate error code */
     }
 
-    /* Allocate memory for graph points */
-    int num_points = 512;
-    double *points = malloc(num_points * sizeof(double));
-    if (!points) {
-        fprintf(stderr, "Error: Memory allocation failed.\n");
-        return 5;
-    }
-
-    /* Generate graph points by evaluating the function */
-    double step = (xmax - xmin) / (num_points - 1);
-    bool has_undefined_values = false;
-
-    int i;
-    for (i = 0; i < num_points; i++) {
-        double x = xmin + i * step;
-        EvaluationResult eval = evaluate_expression(function, x);
-        if (eval.is_defined != 0) {
-            points[i] = eval.value;
-        } else {
-            has_undefined_values = true;
-            points[i] = 0.f / 0.f; /* NaN for undefined values, 0.f / 0.f for NaN value */
-        }
-    }
-
-    if (has_undefined_values) {
-        fprintf(stderr, "Warning: The function contains undefined values in the given range.\n");
-    }
-
-    /* Configure graph parameters */
-    GraphParams params = {
-        .min_x = xmin,
-        .max_x = xmax,
-        .min_y = ymin,
-        .max_y = ymax,
-        .width = 512,
-        .height = 512,
-        .x_divisions = 10,
-        .y_divisions = 10,
-        .points = points,
-        .num_points = num_points
-    };
-
-    /* Generate PostScript graph */
-    int result = generate_postscript_graph(&params, output_file);
-    if (result != 0) {
-        fprintf(stderr, "Error: Failed to generate PostScript graph. Code: %d\n", result);
-        free(points);
-        return 6;
-    }
+    /* Sample the function and generate the PostScript graph */
+    result = render_plot(&job, num_threads);
 
     /* Free allocated memory and exit */
-    free(points);
-    return 0;
+    free_plot(&job);
+    cache_destroy(job.cache);
+    return result;
 }
 
 /* ____________________________________________________________________________
@@ -128,118 +107,159 @@ int main(int argc, char *argv[]) {
     functions. If the function is unquoted, it must not contain whitespace.
     If it is quoted, whitespace is allowed.
 
+    Options starting with "--" may appear anywhere after the program name:
+        --threads=N    - Evaluate with up to N threads (default 1)
+        --batch=FILE   - Plot all entries of a manifest, "-" for stdin;
+                         no positional arguments are used then
+        --no-jit       - Interpret the bytecode instead of generating
+                         native code
+        --points=N     - Sample N evenly spaced points and stream them
+                         into the graph instead of sampling adaptively
+        --grid=N       - Plot a function of x and y over N x N samples
+        --contours=N   - Draw N contour lines of a grid plot instead
+                         of its heatmap
+        --heatmap      - Draw the heatmap together with the contours
+        --var=NAME=V   - Give the variable NAME (t or a new parameter,
+                         or y of a curve) the value V
+        --sweep=NAME=A:B:K - Write K pages, NAME goes from A to B;
+                         parts not depending on NAME are evaluated once
+        --cache=DIR    - Keep written graphs in the existing directory
+                         DIR and copy them on repeated requests
+
     Parameters:
         argc        - Number of command-line arguments
         argv        - Array of command-line arguments
-        function    - Buffer to store the parsed function
-        output_file - Buffer to store the output file path
-        xmin, xmax, ymin, ymax - Pointers to store the range values
+        job         - Plot job receiving the function, output file and range
+        num_threads - Pointer to store the number of evaluation threads
+        batch_file  - Pointer to store the manifest path, NULL if none
+        cache_dir   - Pointer to store the cache directory, NULL if none
         
     Returns:
         0 on success, error code on failure
    ____________________________________________________________________________
 */
-int parse_command_args(int argc, char *argv[], 
-                      char *function, char **output_file,
-                      double *xmin, double *xmax, 
-                      double *ymin, double *ymax) {
-    /* Verify minimum required arguments (program name, function, output file) */
-    if (argc < 3) {
-        fprintf(stderr, "Usage: %s <function> <output_file> [xmin:xmax:ymin:ymax]\n", argv[0]);
-        fprintf(stderr, "Example: %s \"sin(x^2)\" output.ps\n", argv[0]);
-        fprintf(stderr, "Example with limits: %s \"sin(x^2)\" output.ps -10:10:-1:1\n", argv[0]);
-        fprintf(stderr, "Note: Quotes are optional if function contains no spaces\n");
-        return 1;
-    }
-
-    /* Set default plotting range values */
-    *xmin = -10;
-    *xmax = 10;
-    *ymin = -10;
-    *ymax = 10;
-
-    /* Copy and clean the function string */
-    const char* input_function = argv[1];
-    char temp_function[1024] = { '\0' };
-    size_t j = 0;
-    
-    /* Copy while removing whitespace */
-    size_t i;
-    for (i = 0; input_function[i] != '\0'; i++) {
-        if (!isspace(input_function[i])) {
-            if (j >= sizeof(temp_function) - 1) {
-                fprintf(stderr, "Error: Function too long\n");
+int parse_command_args(int argc, char *argv[], PlotJob *job,
+                       int *num_threads, const char **batch_file,
+                       const char **cache_dir) {
+    char *positional[3];    /* Function, output file and optional range */
+    int num_positional = 0;
+    int k;
+
+    *num_threads = 1;
+    *batch_file = NULL;
+    *cache_dir = NULL;
+    memset(job, 0, sizeof(*job));
+
+    /* Separate options from positional arguments */
+    for (k = 1; k < argc; k++) {
+        if (strncmp(argv[k], "--threads=", 10) == 0) {
+            char *end;
+            long value = strtol(argv[k] + 10, &end, 10);
+            if (end == argv[k] + 10 || *end != '\0' ||
+                value < 1 || value > EVAL_MAX_THREADS) {
+                fprintf(stderr, "Error: Invalid number of threads (1 to %d)\n",
+                        EVAL_MAX_THREADS);
                 return 1;
             }
-            temp_function[j++] = input_function[i];
-        }
-    }
-    temp_function[j] = '\0';
-    
-    /* Validate characters */
-    for (i = 0; temp_function[i] != '\0'; i++) {
-        if (!isalnum(temp_function[i]) && 
-            temp_function[i] != '(' && 
-            temp_function[i] != ')' && 
-            temp_function[i] != '^' && 
-            temp_function[i] != '*' && 
-            temp_function[i] != '/' && 
-            temp_function[i] != '+' && 
-            temp_function[i] != '-' && 
-            temp_function[i] != '.') {
-            fprintf(stderr, "Error: Invalid character in function: '%c'\n", temp_function[i]);
+            *num_threads = (int)value;
+        } else if (strncmp(argv[k], "--points=", 9) == 0) {
+            char *end;
+            long value = strtol(argv[k] + 9, &end, 10);
+            if (end == argv[k] + 9 || *end != '\0' ||
+                value < 2 || value > PLOT_MAX_POINTS) {
+                fprintf(stderr, "Error: Invalid number of points (2 to %d)\n",
+                        PLOT_MAX_POINTS);
+                return 1;
+            }
+            job->num_points = (int)value;
+        } else if (strncmp(argv[k], "--grid=", 7) == 0) {
+            char *end;
+            long value = strtol(argv[k] + 7, &end, 10);
+            if (end == argv[k] + 7 || *end != '\0' ||
+                value < 2 || value > PLOT_MAX_GRID) {
+                fprintf(stderr, "Error: Invalid grid size (2 to %d)\n",
+                        PLOT_MAX_GRID);
+                return 1;
+            }
+            job->grid_size = (int)value;
+        } else if (strncmp(argv[k], "--contours=", 11) == 0) {
+            char *end;
+            long value = strtol(argv[k] + 11, &end, 10);
+            if (end == argv[k] + 11 || *end != '\0' ||
+                value < 1 || value > PS_MAX_CONTOURS) {
+                fprintf(stderr, "Error: Invalid number of contours (1 to %d)\n",
+                        PS_MAX_CONTOURS);
+                return 1;
+            }
+            job->num_contours = (int)value;
+        } else if (strcmp(argv[k], "--heatmap") == 0) {
+            job->heatmap = 1;
+        } else if (strncmp(argv[k], "--var=", 6) == 0) {
+            if (set_plot_variable(job, argv[k] + 6) != 0) {
+                return 1;
+            }
+        } else if (strncmp(argv[k], "--sweep=", 8) == 0) {
+            if (set_plot_sweep(job, argv[k] + 8) != 0) {
+                return 1;
+            }
+        } else if (strncmp(argv[k], "--batch=", 8) == 0 && argv[k][8] != '\0') {
+            *batch_file = argv[k] + 8;
+        } else if (strncmp(argv[k], "--cache=", 8) == 0 && argv[k][8] != '\0') {
+            *cache_dir = argv[k] + 8;
+        } else if (strcmp(argv[k], "--no-jit") == 0) {
+            jit_set_enabled(0);
+        } else if (strncmp(argv[k], "--", 2) == 0) {
+            fprintf(stderr, "Error: Unknown option '%s'\n", argv[k]);
             return 1;
+        } else if (num_positional < 3) {
+            positional[num_positional++] = argv[k];
         }
     }
 
-    /* Copy cleaned function to output */
-    strcpy(function, temp_function);
-
-    /* Set output file */
-    *output_file = argv[2];
-
-    /* Parse optional range parameters if provided */
-    if (argc > 3) {
-        char range_copy[256];  /* Local buffer for range string */
-        strncpy(range_copy, argv[3], sizeof(range_copy) - 1);
-        range_copy[sizeof(range_copy) - 1] = '\0';  /* Ensure null termination */
-
-        char *token;
-        
-        /* Parse xmin */
-        token = strtok(range_copy, ":");
-        if (!token || sscanf(token, "%lf", xmin) != 1) {
-            fprintf(stderr, "Error: Invalid xmin value\n");
-            return 1;
-        }
-
-        /* Parse xmax */
-        token = strtok(NULL, ":");
-        if (!token || sscanf(token, "%lf", xmax) != 1) {
-            fprintf(stderr, "Error: Invalid xmax value\n");
+    if (*batch_file) {
+        if (num_positional > 0 || job->num_points > 0 || job->grid_size > 0 ||
+            job->num_contours > 0 || job->heatmap || job->variables_set ||
+            job->sweep.num_frames > 0) {
+            fprintf(stderr, "Error: Positional arguments and plot options cannot be combined with --batch\n");
             return 1;
         }
+        return 0;
+    }
 
-        /* Parse ymin */
-        token = strtok(NULL, ":");
-        if (!token || sscanf(token, "%lf", ymin) != 1) {
-            fprintf(stderr, "Error: Invalid ymin value\n");
-            return 1;
-        }
+    /* Verify minimum required arguments (function, output file) */
+    if (num_positional < 2) {
+        fprintf(stderr, "Usage: %s <function> <output_file> [xmin:xmax:ymin:ymax] [--threads=N] [--no-jit] [--points=N]\n", argv[0]);
+        fprintf(stderr, "       [--grid=N] [--contours=N] [--heatmap] [--var=NAME=VALUE]\n");
+        fprintf(stderr, "       [--sweep=NAME=FROM:TO:FRAMES] [--cache=DIR]\n");
+        fprintf(stderr, "       %s --batch=<manifest> [--threads=N] [--no-jit] [--cache=DIR]\n", argv[0]);
+        fprintf(stderr, "Example: %s \"sin(x^2)\" output.ps\n", argv[0]);
+        fprintf(stderr, "Example with limits: %s \"sin(x^2)\" output.ps -10:10:-1:1\n", argv[0]);
+        fprintf(stderr, "Example with overlay: %s \"sin(x);cos(x)\" output.ps\n", argv[0]);
+        fprintf(stderr, "Example with derivative: %s \"x^3;x^3'\" output.ps\n", argv[0]);
+        fprintf(stderr, "Example of a heatmap: %s \"sin(x)*cos(y)\" output.ps -5:5:-5:5\n", argv[0]);
+        fprintf(stderr, "Example with a parameter: %s \"sin(a*x)\" output.ps --var=a=2\n", argv[0]);
+        fprintf(stderr, "Example of a sweep: %s \"sin(a*x)\" frames.ps --sweep=a=1:3:20\n", argv[0]);
+        fprintf(stderr, "Note: Quotes are optional if function contains no spaces\n");
+        fprintf(stderr, "Manifest lines: <function> <output_file> [xmin:xmax:ymin:ymax]\n");
+        return 1;
+    }
 
-        /* Parse ymax */
-        token = strtok(NULL, ":");
-        if (!token || sscanf(token, "%lf", ymax) != 1) {
-            fprintf(stderr, "Error: Invalid ymax value\n");
-            return 1;
-        }
+    /* Set default plotting range values */
+    job->xmin = PLOT_DEFAULT_MIN;
+    job->xmax = PLOT_DEFAULT_MAX;
+    job->ymin = PLOT_DEFAULT_MIN;
+    job->ymax = PLOT_DEFAULT_MAX;
+
+    /* Copy and clean the function string, set the output file */
+    if (set_plot_function(job, positional[0]) != 0 ||
+        set_plot_output(job, positional[1]) != 0) {
+        return 1;
+    }
 
-        /* Validate ranges */
-        if (*xmax <= *xmin || *ymax <= *ymin) {
-            fprintf(stderr, "Error: Invalid range (max must be greater than min)\n");
-            return 1;
-        }
+    /* Parse optional range parameters if provided */
+    if (num_positional > 2 && set_plot_range(job, positional[2]) != 0) {
+        return 1;
     }
 
     return 0; /* Success */
-}
\ No newline at end of file
+}
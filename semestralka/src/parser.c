@@ -5,19 +5,20 @@
 
     Implementation of a mathematical expression parser 
     capable of processing complex expressions with various functions, 
-    operators, and a single variable (x).
+    operators, and named variables (x, y, t and registered parameters).
 
     Key Features:
     - Support for mathematical operations 
     - Mathematical function parsing
-    - Single variable (x) support
+    - Variables resolved to slots at compile time
     - Error handling and validation
     - Undefined point detection
+    - Compilation to postfix bytecode for repeated evaluation
 
     Expression Grammar:
     expression = term {("+"|"-") term}
     term       = factor {("*"|"/") factor}
-    factor     = number | "x" | function "(" expression ")" | 
+    factor     = number | variable | function "(" expression ")" | 
                  "(" expression ")" | "-" factor | factor "^" factor
 
     Dialect: ANSI C
@@ -28,6 +29,8 @@
 */
 
 #include "parser.h"
+#include "ast.h"    /* Expression tree used by the compiler */
+#include "jit.h"    /* Release of native code */
 
 /* List of known mathematical functions */
 const char *KNOWN_FUNCTIONS[] = {
@@ -38,6 +41,62 @@ const char *KNOWN_FUNCTIONS[] = {
 };
 const int NUM_KNOWN_FUNCTIONS = sizeof(KNOWN_FUNCTIONS) / sizeof(KNOWN_FUNCTIONS[0]);
 
+/* Function table entries of the built-in functions, in KNOWN_FUNCTIONS order */
+static const FunctionEntry BUILTIN_FUNCTIONS[] = {
+    { "abs",  OP_ABS,  -1, NULL }, { "exp",  OP_EXP,  -1, NULL },
+    { "ln",   OP_LN,   -1, NULL }, { "log",  OP_LOG,  -1, NULL },
+    { "sin",  OP_SIN,  -1, NULL }, { "cos",  OP_COS,  -1, NULL },
+    { "tan",  OP_TAN,  -1, NULL },
+    { "asin", OP_ASIN, -1, NULL }, { "acos", OP_ACOS, -1, NULL },
+    { "atan", OP_ATAN, -1, NULL },
+    { "sinh", OP_SINH, -1, NULL }, { "cosh", OP_COSH, -1, NULL },
+    { "tanh", OP_TANH, -1, NULL }
+};
+
+/* Indices into BUILTIN_FUNCTIONS used by the lookup trie */
+enum {
+    FN_ABS, FN_EXP, FN_LN, FN_LOG, FN_SIN, FN_COS, FN_TAN,
+    FN_ASIN, FN_ACOS, FN_ATAN, FN_SINH, FN_COSH, FN_TANH
+};
+
+/*
+  Registry of functions added at runtime
+  Entries are stored in registration order, the open addressing hash table
+  maps names to entry indices (stored +1, 0 marks an empty slot). The table
+  is kept at most half full so probe sequences stay short.
+*/
+#define REGISTRY_HASH_SIZE (MAX_REGISTERED_FUNCTIONS * 2)
+static FunctionEntry registered_functions[MAX_REGISTERED_FUNCTIONS];
+static char registered_names[MAX_REGISTERED_FUNCTIONS][MAX_FUNCTION_NAME_LEN + 1];
+static int num_registered_functions = 0;
+static int registry_hash[REGISTRY_HASH_SIZE];
+
+/*
+  Names of the variable slots
+  The built-in variables take the first slots, register_variable() adds
+  parameters after them. Unused slots hold empty names.
+*/
+static char variable_names[MAX_VARIABLES][MAX_FUNCTION_NAME_LEN + 1] = {
+    "x", "y", "t"
+};
+static int num_variables = VAR_T + 1;
+
+/* Internal function prototypes */
+static int literal_out_of_range(const char *start, const char *end,
+                                double value);
+static int read_variable(const char *expr, size_t *length);
+static EvaluationResult evaluate(const char *expr, double x,
+                                 const double *values);
+static ParserError build_trees(const char *const *exprs, const int *orders,
+                               int count, ExprNode **trees, int *parsed);
+
+/* Internal compiler function prototypes */
+static ExprNode *compile_sum(Parser *p);
+static ExprNode *compile_term(Parser *p);
+static ExprNode *compile_factor(Parser *p);
+static ExprNode *compile_function(Parser *p);
+static ExprNode *check_node(Parser *p, ExprNode *node);
+
 
 /* ____________________________________________________________________________
     EvaluationResult evaluate_expression(const char *expr, double x)
@@ -54,16 +113,48 @@ const int NUM_KNOWN_FUNCTIONS = sizeof(KNOWN_FUNCTIONS) / sizeof(KNOWN_FUNCTIONS
     Responsibilities:
     - Validate input expression
     - Parse and compute expression value
+    - Report parse errors through the result instead of exiting
     - Handle mathematical undefined scenarios
    ____________________________________________________________________________
 */
 EvaluationResult evaluate_expression(const char *expr, double x) {
+   return evaluate(expr, x, NULL);
+}
+
+/* ____________________________________________________________________________
+    EvaluationResult evaluate_expression_at(const char *expr,
+                                            const double *values)
+    
+    Evaluates an expression with values for all variable slots.
+   ____________________________________________________________________________
+*/
+EvaluationResult evaluate_expression_at(const char *expr, const double *values) {
+   EvaluationResult result = {0, 0, PARSER_ERROR_INVALID_INPUT};
+
+   if (!values) {
+       return result;
+   }
+
+   return evaluate(expr, values[VAR_X], values);
+}
+
+/* ____________________________________________________________________________
+    static EvaluationResult evaluate(const char *expr, double x,
+                                     const double *values)
+    
+    Shared implementation of evaluate_expression() and
+    evaluate_expression_at(), values may be NULL.
+   ____________________________________________________________________________
+*/
+static EvaluationResult evaluate(const char *expr, double x,
+                                 const double *values) {
    /* Initialize result struct - default to "defined" state */
-   EvaluationResult result = {0, 1};
+   EvaluationResult result = {0, 1, PARSER_OK};
    
    /* Validate input expression pointer and length */
    if (!expr || strlen(expr) >= MAX_EXPR_LEN) {
        result.is_defined = 0;
+       result.error = PARSER_ERROR_INVALID_INPUT;
        return result;
    }
    
@@ -73,15 +164,29 @@ EvaluationResult evaluate_expression(const char *expr, double x) {
    validated_expr[MAX_EXPR_LEN - 1] = '\0';
    
    /* Set up parser with validated expression */
-   Parser parser = { validated_expr, x };
+   Parser parser = { validated_expr, x, PARSER_OK, NULL };
+   parser.values = values;
    result.value = parse_expression(&parser);
+
+   /* The whole expression must be consumed */
+   skip_whitespace(&parser);
+   if (parser.error == PARSER_OK && *parser.expr != '\0') {
+       parser.error = PARSER_ERROR_SYNTAX;
+   }
+
+   /* Invalid expressions have no value at all */
+   if (parser.error != PARSER_OK) {
+       result.value = 0;
+       result.is_defined = 0;
+       result.error = parser.error;
+       return result;
+   }
    
-   /* Check for overflow/underflow and infinity conditions */
-   if (errno == ERANGE || 
+   /* NaN signals a domain error, infinity an overflow */
+   if (result.value != result.value ||
        result.value == HUGE_VAL || 
        result.value == -HUGE_VAL) {
        result.is_defined = 0;
-       errno = 0;
    }
    
    return result;
@@ -102,7 +207,7 @@ double parse_expression(Parser *p) {
     skip_whitespace(p);            /* Skip any whitespace after the term */
 
     /* Process addition and subtraction operators. */
-    while (*p->expr == '+' || *p->expr == '-') {
+    while (p->error == PARSER_OK && (*p->expr == '+' || *p->expr == '-')) {
         char op = *p->expr;         /* Get the current operator ('+' or '-') */
         match(p, op);              /* Consume the operator and advance the parser */
         skip_whitespace(p);        /* Skip any whitespace. */
@@ -134,7 +239,7 @@ double parse_term(Parser *p) {
     skip_whitespace(p);             /* Skip any whitespace after the factor */
 
     /* Process multiplication and division operators */
-    while (*p->expr == '*' || *p->expr == '/') {
+    while (p->error == PARSER_OK && (*p->expr == '*' || *p->expr == '/')) {
         char op = *p->expr;         /* Get the current operator ('*' or '/') */
         match(p, op);              /* Consume the operator and advance the parser */
         skip_whitespace(p);        /* Skip any whitespace. */
@@ -145,11 +250,10 @@ double parse_term(Parser *p) {
             double divisor = parse_factor(p); /* Parse the divisor */
 
             if (divisor == 0) {
-                fprintf(stderr, "Error: Division by zero\n");
-                exit(2); /* Terminate the program on division by zero */
+                result = 0.0 / 0.0; /* Undefined point, NaN propagates */
+            } else {
+                result /= divisor; /* Divide by the divisor */
             }
-
-            result /= divisor; /* Divide by the divisor */
         }
 
         skip_whitespace(p);        /* Skip any whitespace after the operation */
@@ -173,6 +277,11 @@ double parse_factor(Parser *p) {
     skip_whitespace(p); /* Skip any leading whitespace */
     double result;
 
+    /* Stop descending once an error has been recorded */
+    if (p->error != PARSER_OK) {
+        return 0;
+    }
+
     if (*p->expr == '(') {
         /* Handle expressions within parentheses */
         match(p, '(');
@@ -187,9 +296,15 @@ double parse_factor(Parser *p) {
         result = -parse_factor(p); /* Negate the result of the next factor */
     } else if (isalpha(*p->expr)) {
         /* Handle variables or functions */
-        if (*p->expr == 'x') {
+        size_t length;
+        int slot = read_variable(p->expr, &length);
+        if (slot == VAR_X) {
             match(p, 'x');
             result = p->x; /* Retrieve the value of the variable 'x' */
+        } else if (slot >= 0) {
+            p->expr += length;
+            /* Variables without a value are undefined */
+            result = p->values ? p->values[slot] : 0.0 / 0.0;
         } else {
             result = parse_function(p); /* Parse and evaluate the function */
         }
@@ -200,12 +315,13 @@ double parse_factor(Parser *p) {
 
     skip_whitespace(p); /* Skip any whitespace */
 
-    if (*p->expr == '^') {
+    if (p->error == PARSER_OK && *p->expr == '^') {
         /* Handle exponentiation */
         match(p, '^');
         skip_whitespace(p);
         double exponent = parse_factor(p); /* Parse the exponent */
-        result = pow(result, exponent);    /* Raise the base to the exponent */
+        /* Same rule as compiled programs, undefined operands stay undefined */
+        result = apply_binary(OP_POW, result, exponent);
     }
 
     return result; /* Return the evaluated result of the factor */
@@ -225,15 +341,19 @@ double parse_factor(Parser *p) {
    ____________________________________________________________________________
 */
 double parse_function(Parser *p) {
-    char funcName[10] = {0}; /* Buffer to store the function name */
-    int i = 0;
+    const FunctionEntry *entry;
+    size_t length = 0;
 
-    /* Extract the function name from the expression */
-    while (isalpha(p->expr[i]) && i < 9) {
-        funcName[i] = p->expr[i];
-        i++;
+    /* Measure the function name and resolve it without copying */
+    while (isalpha(p->expr[length])) {
+        length++;
     }
-    p->expr += i; /* Advance the parser past the function name */
+    entry = lookup_function(p->expr, length);
+    if (!entry) {
+        p->error = PARSER_ERROR_UNKNOWN_FUNCTION;
+        return 0;
+    }
+    p->expr += length; /* Advance the parser past the function name */
 
     skip_whitespace(p); /* Skip any whitespace */
     match(p, '(');     /* Match the opening parenthesis of the function argument */
@@ -242,58 +362,13 @@ double parse_function(Parser *p) {
     skip_whitespace(p);
     match(p, ')');     /* Match the closing parenthesis */
 
-    /* Handle known mathematical functions */
-    if (strcmp(funcName, "sin") == 0) return sin(arg);
-    if (strcmp(funcName, "cos") == 0) return cos(arg);
-    if (strcmp(funcName, "tan") == 0) {
-        if (cos(arg) == 0) {
-            errno = ERANGE;
-            return HUGE_VAL; /* Undefined tangent */
-        }
-        return tan(arg);
+    /* Registered functions are called directly, built-ins by opcode */
+    if (entry->function) {
+        return entry->function(arg);
     }
 
-    if (strcmp(funcName, "asin") == 0) {
-        if (arg < -1 || arg > 1) {
-            errno = ERANGE;
-            return HUGE_VAL; /* Undefined arcsine */
-        }
-        return asin(arg);
-    }
-    if (strcmp(funcName, "acos") == 0) {
-        if (arg < -1 || arg > 1) {
-            errno = ERANGE;
-            return HUGE_VAL; /* Undefined arccosine */
-        }
-        return acos(arg);
-    }
-    if (strcmp(funcName, "atan") == 0) return atan(arg);
-
-    if (strcmp(funcName, "ln") == 0) {
-        if (arg <= 0) {
-            errno = ERANGE;
-            return HUGE_VAL; /* Undefined natural logarithm */
-        }
-        return log(arg);
-    }
-    if (strcmp(funcName, "log") == 0) {
-        if (arg <= 0) {
-            errno = ERANGE;
-            return HUGE_VAL; /* Undefined base-10 logarithm */
-        }
-        return log10(arg);
-    }
-
-    if (strcmp(funcName, "exp") == 0) return exp(arg);
-
-    if (strcmp(funcName, "sinh") == 0) return sinh(arg);
-    if (strcmp(funcName, "cosh") == 0) return cosh(arg);
-    if (strcmp(funcName, "tanh") == 0) return tanh(arg);
-
-    if (strcmp(funcName, "abs") == 0) return fabs(arg);
-
-    fprintf(stderr, "Error: Unknown function: %s\n", funcName);
-    exit(2); /* Terminate the program for an unknown function */
+    /* Domain errors (e.g. ln of a negative number) give NaN */
+    return apply_unary(entry->opcode, arg);
 }
 
 
@@ -310,9 +385,6 @@ double parse_function(Parser *p) {
    ____________________________________________________________________________
 */
 double parse_number(Parser *p) {
-    /* Reset error number for fresh error checking */
-    errno = 0;
-
     /* 
         Special handling for numbers starting with a decimal point 
         Prepends a '0' to ensure valid parsing of leading decimal numbers
@@ -321,23 +393,25 @@ double parse_number(Parser *p) {
         /* Create a buffer large enough for most number representations */
         char tempBuffer[64];  
         
-        /* Prepend '0' to the decimal number */
-        sprintf(tempBuffer, "0%s", p->expr);
+        /* Prepend '0' to the decimal number, the rest is truncated */
+        tempBuffer[0] = '0';
+        strncpy(tempBuffer + 1, p->expr, sizeof(tempBuffer) - 2);
+        tempBuffer[sizeof(tempBuffer) - 1] = '\0';
         char *endPtr;
         
         /* Attempt to parse the number */
         double result = strtod(tempBuffer, &endPtr);
         
-        /* Check for parsing failure */
-        if (tempBuffer == endPtr) {
-            fprintf(stderr, "Error: Invalid number format.\n");
-            exit(2);
+        /* Check for parsing failure ("0" alone means nothing was read) */
+        if (endPtr - tempBuffer <= 1) {
+            p->error = PARSER_ERROR_NUMBER_FORMAT;
+            return 0;
         }
         
         /* Check for number being out of representable range */
-        if (errno == ERANGE) {
-            fprintf(stderr, "Error: Number out of range.\n");
-            exit(2);
+        if (literal_out_of_range(tempBuffer, endPtr, result)) {
+            p->error = PARSER_ERROR_NUMBER_RANGE;
+            return 0;
         }
         
         /* 
@@ -354,8 +428,8 @@ double parse_number(Parser *p) {
     
     /* Check if no parsing occurred */
     if (p->expr == endPtr) {
-        fprintf(stderr, "Error: Invalid number format.\n");
-        exit(2);
+        p->error = PARSER_ERROR_NUMBER_FORMAT;
+        return 0;
     }
 
     /* Store original expression pointer for detailed validation */
@@ -363,9 +437,9 @@ double parse_number(Parser *p) {
     p->expr = endPtr;
     
     /* Check for number being out of representable range */
-    if (errno == ERANGE) {
-        fprintf(stderr, "Error: Number out of range.\n");
-        exit(2);
+    if (literal_out_of_range(original, endPtr, result)) {
+        p->error = PARSER_ERROR_NUMBER_RANGE;
+        return 0;
     }
 
     /* 
@@ -380,16 +454,16 @@ double parse_number(Parser *p) {
         /* Check for exponential notation */
         if (*original == 'e' || *original == 'E') {
             if (hasE != 0) {
-                fprintf(stderr, "Error: Invalid number format - multiple exponential notations.\n");
-                exit(2);
+                p->error = PARSER_ERROR_NUMBER_FORMAT; /* Multiple exponents */
+                return 0;
             }
             hasE = 1;
         } 
         /* Check for decimal points */
         else if (*original == '.') {
             if (hasDot) {
-                fprintf(stderr, "Error: Invalid number format - multiple decimal points.\n");
-                exit(2);
+                p->error = PARSER_ERROR_NUMBER_FORMAT; /* Multiple dots */
+                return 0;
             }
             hasDot = 1;
         }
@@ -399,6 +473,38 @@ double parse_number(Parser *p) {
     return result;
 }
 
+/* ____________________________________________________________________________
+    static int literal_out_of_range(const char *start, const char *end,
+                                    double value)
+    
+    Detects numeric literals that overflow or underflow a double. The
+    value returned by strtod() is examined directly instead of errno, so
+    the check does not depend on state shared with other code.
+    
+    Range Rules:
+    - Overflow yields HUGE_VAL
+    - Underflow yields zero or a subnormal value although the mantissa
+      has a non-zero digit
+   ____________________________________________________________________________
+*/
+static int literal_out_of_range(const char *start, const char *end,
+                                double value) {
+    if (value == HUGE_VAL) {
+        return 1;
+    }
+
+    if (value < DBL_MIN) {
+        /* Zero is only in range if it was written as zero */
+        for (; start < end && *start != 'e' && *start != 'E'; start++) {
+            if (*start >= '1' && *start <= '9') {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
 /* ____________________________________________________________________________
     void skip_whitespace(Parser *p)
     
@@ -419,7 +525,7 @@ void skip_whitespace(Parser *p) {
     Error Handling Strategy:
     - Skip leading whitespace
     - Check if current character matches expected character
-    - If mismatch, print error and exit
+    - If mismatch, record a syntax error and keep the position
     - If match, advance parser pointer
    ____________________________________________________________________________
 */
@@ -428,15 +534,9 @@ void match(Parser *p, char expected) {
 
     if (*p->expr == expected) {
         p->expr++; /* Advance the parser past the matched character */
-    } else {
-        if (*p->expr == '\0') {
-            /* Handle end-of-expression error */
-            fprintf(stderr, "Error: Expected '%c', found end of expression\n", expected);
-        } else {
-            /* Handle mismatched character error */
-            fprintf(stderr, "Error: Expected '%c', found '%c'\n", expected, *p->expr);
-        }
-        exit(2); /* Terminate the program on error */
+    } else if (p->error == PARSER_OK) {
+        /* Mismatched character or unexpected end of expression */
+        p->error = PARSER_ERROR_SYNTAX;
     }
 }
 
@@ -460,19 +560,12 @@ int is_operator(char c) {
     Validates whether a given string represents a known mathematical function.
     
     Validation Strategy:
-    - Iterate through list of known functions
-    - Compare input function name against predefined set
+    - Resolve the name through the function lookup trie and registry
     - Return 1 if match found, 0 otherwise
    ____________________________________________________________________________
 */
 int is_valid_function(const char *func_name) {
-    int i;
-    for (i = 0; i < NUM_KNOWN_FUNCTIONS; i++) {
-        if (strcmp(func_name, KNOWN_FUNCTIONS[i]) == 0) {
-            return 1; /* Function name is valid */
-        }
-    }
-    return 0; /* Function name is invalid */
+    return lookup_function(func_name, strlen(func_name)) != NULL;
 }
 
 /* ____________________________________________________________________________
@@ -534,7 +627,7 @@ int extract_function_name(const char *expr, char *function_name) {
     int func_len = 0;
     
     /* Read function name */
-    while (isalpha(expr[func_len]) && func_len < 9) {
+    while (isalpha(expr[func_len]) && func_len < MAX_FUNCTION_NAME_LEN) {
         function_name[func_len] = expr[func_len];
         func_len++;
     }
@@ -611,10 +704,21 @@ int validate_expression(const char *expr) {
             continue;
         }
 
-        /* Handle functions */
+        /* Handle named variables and functions */
         if (isalpha(*expr)) {
-            char function_name[10] = {0};
-            int func_len = extract_function_name(expr, function_name);
+            char function_name[MAX_FUNCTION_NAME_LEN + 1] = {0};
+            size_t name_len;
+            int func_len;
+
+            if (read_variable(expr, &name_len) >= 0) {
+                expr += name_len - 1;
+                last_was_operator = 0;
+                last_was_function = 0;
+                last_was_number = 0;
+                continue;
+            }
+
+            func_len = extract_function_name(expr, function_name);
 
             /* Check if it is a valid function */
             if (!is_valid_function(function_name)) return 0;
@@ -656,4 +760,884 @@ int validate_expression(const char *expr) {
     if (last_was_operator) return 0;
 
     return 1;
-}
\ No newline at end of file
+}
+
+/* ____________________________________________________________________________
+ 
+    BYTECODE COMPILER
+   ____________________________________________________________________________
+*/
+
+/* ____________________________________________________________________________
+    ParserError parse_expression_tree(const char *expr, ExprNode **tree)
+    
+    Builds the expression tree of an expression.
+    
+    Parsing Strategy:
+    - Walk the expression once with the recursive descent grammar
+    - Create a leaf for every operand and a node for every operator
+    - Stop at the first error recorded in the parser state
+   ____________________________________________________________________________
+*/
+ParserError parse_expression_tree(const char *expr, ExprNode **tree) {
+    Parser parser;
+    ExprNode *root;
+
+    if (!tree) {
+        return PARSER_ERROR_INVALID_INPUT;
+    }
+    *tree = NULL;
+
+    /* Validate input expression pointer and length */
+    if (!expr || strlen(expr) >= MAX_EXPR_LEN) {
+        return PARSER_ERROR_INVALID_INPUT;
+    }
+
+    parser.expr = expr;
+    parser.x = 0;
+    parser.values = NULL;
+    parser.error = PARSER_OK;
+
+    root = compile_sum(&parser);
+    skip_whitespace(&parser);
+
+    /* The whole expression must be consumed */
+    if (parser.error == PARSER_OK && *parser.expr != '\0') {
+        parser.error = PARSER_ERROR_SYNTAX;
+    }
+
+    if (parser.error != PARSER_OK) {
+        ast_free(root);
+        return parser.error;
+    }
+
+    *tree = root;
+    return PARSER_OK;
+}
+
+/* ____________________________________________________________________________
+    ParserError compile_expression(const char *expr, Program *prog)
+    
+    Compiles an expression into postfix bytecode.
+   ____________________________________________________________________________
+*/
+ParserError compile_expression(const char *expr, Program *prog) {
+    return compile_expressions(&expr, 1, prog);
+}
+
+/* ____________________________________________________________________________
+    ParserError compile_expressions(const char *const *exprs, int count,
+                                    Program *prog)
+    
+    Compiles several expressions into one program.
+   ____________________________________________________________________________
+*/
+ParserError compile_expressions(const char *const *exprs, int count,
+                                Program *prog) {
+    return compile_derivatives(exprs, NULL, count, prog);
+}
+
+/* ____________________________________________________________________________
+    ParserError compile_derivatives(const char *const *exprs,
+                                    const int *orders, int count,
+                                    Program *prog)
+    
+    Compiles several expressions or their derivatives into one program.
+    
+    Compilation Strategy:
+    - Build the simplified trees or their derivatives, see build_trees()
+    - Emit the trees one after another in postfix order, sharing
+      repeated subtrees through slots
+   ____________________________________________________________________________
+*/
+ParserError compile_derivatives(const char *const *exprs, const int *orders,
+                                int count, Program *prog) {
+    ExprNode *trees[MAX_PROGRAM_OUTPUTS];
+    ParserError error;
+    int i, parsed;
+
+    if (!prog) {
+        return PARSER_ERROR_INVALID_INPUT;
+    }
+    memset(prog, 0, sizeof(*prog));
+
+    if (!exprs || count < 1 || count > MAX_PROGRAM_OUTPUTS) {
+        return PARSER_ERROR_INVALID_INPUT;
+    }
+
+    error = build_trees(exprs, orders, count, trees, &parsed);
+    if (error == PARSER_OK) {
+        error = ast_emit_program(trees, count, prog);
+    }
+
+    for (i = 0; i < parsed; i++) {
+        ast_free(trees[i]);
+    }
+
+    if (error != PARSER_OK) {
+        free_program(prog);
+    }
+
+    return error;
+}
+
+/* ____________________________________________________________________________
+    ParserError compile_sweep(const char *const *exprs, const int *orders,
+                              int count, unsigned varying,
+                              Program *invariant, Program *frame)
+    
+    Compiles expressions into an invariant and a frame program.
+    
+    Compilation Strategy:
+    - Build the trees exactly as compile_derivatives() does
+    - Move the subtrees that do not read a varying variable out of the
+      trees, leaving OP_COLUMN leaves in their place
+    - Emit the moved subtrees as the invariant program and the remaining
+      trees as the frame program
+   ____________________________________________________________________________
+*/
+ParserError compile_sweep(const char *const *exprs, const int *orders,
+                          int count, unsigned varying, Program *invariant,
+                          Program *frame) {
+    ExprNode *trees[MAX_PROGRAM_OUTPUTS];
+    ExprNode *hoisted[MAX_PROGRAM_INPUTS];
+    ParserError error;
+    int i, parsed, num_hoisted = 0;
+
+    if (!invariant || !frame) {
+        return PARSER_ERROR_INVALID_INPUT;
+    }
+    memset(invariant, 0, sizeof(*invariant));
+    memset(frame, 0, sizeof(*frame));
+
+    if (!exprs || count < 1 || count > MAX_PROGRAM_OUTPUTS) {
+        return PARSER_ERROR_INVALID_INPUT;
+    }
+
+    error = build_trees(exprs, orders, count, trees, &parsed);
+    if (error == PARSER_OK) {
+        num_hoisted = ast_hoist_invariant(trees, count, varying & ~(1u << VAR_X),
+                                          hoisted, MAX_PROGRAM_INPUTS);
+    }
+    if (error == PARSER_OK && num_hoisted > 0) {
+        error = ast_emit_program(hoisted, num_hoisted, invariant);
+    }
+    if (error == PARSER_OK) {
+        error = ast_emit_program(trees, count, frame);
+        frame->num_inputs = num_hoisted;
+    }
+
+    for (i = 0; i < parsed; i++) {
+        ast_free(trees[i]);
+    }
+    for (i = 0; i < num_hoisted; i++) {
+        ast_free(hoisted[i]);
+    }
+
+    if (error != PARSER_OK) {
+        free_program(invariant);
+        free_program(frame);
+    }
+
+    return error;
+}
+
+/* ____________________________________________________________________________
+    static ParserError build_trees(const char *const *exprs,
+                                   const int *orders, int count,
+                                   ExprNode **trees, int *parsed)
+    
+    Parses, simplifies and differentiates the expressions of a program.
+    
+    Processing Steps:
+    - Parse every expression into a tree
+    - Simplify the trees (constant folding, identities)
+    - Replace a tree by its derivative as many times as requested, every
+      derivative is simplified again
+    - Collect polynomials in x into single Horner instructions
+    
+    Notes:
+    - parsed receives the number of trees the caller has to release,
+      also when an error is returned
+   ____________________________________________________________________________
+*/
+static ParserError build_trees(const char *const *exprs, const int *orders,
+                               int count, ExprNode **trees, int *parsed) {
+    ParserError error = PARSER_OK;
+    int n;
+
+    for (n = 0; n < count; n++) {
+        int order;
+
+        error = parse_expression_tree(exprs[n], &trees[n]);
+        if (error != PARSER_OK) {
+            break;
+        }
+        trees[n] = ast_optimize(trees[n]);
+
+        for (order = orders ? orders[n] : 0; order > 0; order--) {
+            ExprNode *derivative;
+            error = ast_derivative(trees[n], &derivative);
+            if (error != PARSER_OK) {
+                break;
+            }
+            ast_free(trees[n]);
+            trees[n] = derivative;
+        }
+        if (error != PARSER_OK) {
+            n++;  /* The tree is still owned here */
+            break;
+        }
+
+        /* Last, no other rewrite looks inside polynomials */
+        trees[n] = ast_polynomials(trees[n]);
+    }
+
+    *parsed = n;
+    return error;
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *compile_sum(Parser *p)
+    
+    Builds the tree of additions and subtractions, mirrors
+    parse_expression().
+   ____________________________________________________________________________
+*/
+static ExprNode *compile_sum(Parser *p) {
+    ExprNode *node = compile_term(p);  /* Build the first term */
+    skip_whitespace(p);
+
+    while (p->error == PARSER_OK && (*p->expr == '+' || *p->expr == '-')) {
+        char op = *p->expr;
+        match(p, op);
+        skip_whitespace(p);
+
+        /* Operators are left-associative, the tree grows to the left */
+        node = check_node(p, ast_binary(op == '+' ? OP_ADD : OP_SUB,
+                                        node, compile_term(p)));
+
+        skip_whitespace(p);
+    }
+
+    return node;
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *compile_term(Parser *p)
+    
+    Builds the tree of multiplications and divisions, mirrors parse_term().
+   ____________________________________________________________________________
+*/
+static ExprNode *compile_term(Parser *p) {
+    ExprNode *node = compile_factor(p); /* Build the first factor */
+    skip_whitespace(p);
+
+    while (p->error == PARSER_OK && (*p->expr == '*' || *p->expr == '/')) {
+        char op = *p->expr;
+        match(p, op);
+        skip_whitespace(p);
+
+        node = check_node(p, ast_binary(op == '*' ? OP_MUL : OP_DIV,
+                                        node, compile_factor(p)));
+
+        skip_whitespace(p);
+    }
+
+    return node;
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *compile_factor(Parser *p)
+    
+    Builds the tree of factors and exponentiation, mirrors parse_factor().
+   ____________________________________________________________________________
+*/
+static ExprNode *compile_factor(Parser *p) {
+    ExprNode *node;
+    skip_whitespace(p);
+
+    /* Stop descending once an error has been recorded */
+    if (p->error != PARSER_OK) {
+        return NULL;
+    }
+
+    if (*p->expr == '(') {
+        /* Parentheses only shape the tree */
+        match(p, '(');
+        skip_whitespace(p);
+        node = compile_sum(p);
+        skip_whitespace(p);
+        match(p, ')');
+    } else if (*p->expr == '-') {
+        match(p, '-');
+        skip_whitespace(p);
+        node = check_node(p, ast_unary(OP_NEG, 0, compile_factor(p)));
+    } else if (isalpha(*p->expr)) {
+        /* Variable names are resolved to their slots here */
+        size_t length;
+        int slot = read_variable(p->expr, &length);
+        if (slot == VAR_X) {
+            match(p, 'x');
+            node = check_node(p, ast_variable());
+        } else if (slot >= 0) {
+            p->expr += length;
+            node = check_node(p, ast_named_variable(slot));
+        } else {
+            node = compile_function(p);
+        }
+    } else {
+        /* Numeric literals become constant leaves */
+        double value = parse_number(p);
+        node = (p->error == PARSER_OK) ? check_node(p, ast_constant(value)) : NULL;
+    }
+
+    skip_whitespace(p);
+
+    if (p->error == PARSER_OK && *p->expr == '^') {
+        match(p, '^');
+        skip_whitespace(p);
+        node = check_node(p, ast_binary(OP_POW, node, compile_factor(p)));
+    }
+
+    return node;
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *compile_function(Parser *p)
+    
+    Builds the node of a function call, mirrors parse_function().
+    The function name is resolved to its opcode here, so execution never
+    looks at names.
+   ____________________________________________________________________________
+*/
+static ExprNode *compile_function(Parser *p) {
+    const FunctionEntry *entry;
+    ExprNode *argument;
+    size_t length = 0;
+
+    /* Measure the function name and resolve it without copying */
+    while (isalpha(p->expr[length])) {
+        length++;
+    }
+    entry = lookup_function(p->expr, length);
+    if (!entry) {
+        p->error = PARSER_ERROR_UNKNOWN_FUNCTION;
+        return NULL;
+    }
+    p->expr += length;
+
+    skip_whitespace(p);
+    match(p, '(');
+    skip_whitespace(p);
+    argument = compile_sum(p);    /* Build the function argument */
+    skip_whitespace(p);
+    match(p, ')');
+
+    return check_node(p, ast_unary(entry->opcode, entry->index, argument));
+}
+
+/* ____________________________________________________________________________
+    static ExprNode *check_node(Parser *p, ExprNode *node)
+    
+    Records a memory error when a node could not be created. Constructors
+    also return NULL for missing operands, in which case the parser error
+    has already been set.
+   ____________________________________________________________________________
+*/
+static ExprNode *check_node(Parser *p, ExprNode *node) {
+    if (!node && p->error == PARSER_OK) {
+        p->error = PARSER_ERROR_MEMORY;
+    }
+
+    return node;
+}
+
+/* ____________________________________________________________________________
+    double apply_binary(OpCode opcode, double a, double b)
+    
+    Computes the result of a binary bytecode operator.
+    NaN operands always produce NaN, so undefined values propagate.
+   ____________________________________________________________________________
+*/
+double apply_binary(OpCode opcode, double a, double b) {
+    switch (opcode) {
+        case OP_ADD: return a + b;
+        case OP_SUB: return a - b;
+        case OP_MUL: return a * b;
+        case OP_DIV:
+            return (b == 0) ? 0.0 / 0.0 : a / b; /* x/0 is undefined */
+        case OP_POW:
+            /* pow() returns 1 for some NaN arguments, keep them undefined */
+            if (a != a || b != b) return a + b;
+            return pow(a, b);
+        default:
+            return 0.0 / 0.0;
+    }
+}
+
+/* ____________________________________________________________________________
+    double apply_unary(OpCode opcode, double arg)
+    
+    Computes the result of a unary bytecode operator.
+    Arguments outside of the function domain produce NaN, the same points
+    that parse_function() reports as undefined.
+   ____________________________________________________________________________
+*/
+double apply_unary(OpCode opcode, double arg) {
+    switch (opcode) {
+        case OP_NEG:  return -arg;
+        case OP_ABS:  return fabs(arg);
+        case OP_EXP:  return exp(arg);
+        case OP_LN:   return (arg <= 0) ? 0.0 / 0.0 : log(arg);
+        case OP_LOG:  return (arg <= 0) ? 0.0 / 0.0 : log10(arg);
+        case OP_SIN:  return sin(arg);
+        case OP_COS:  return cos(arg);
+        case OP_TAN:  return (cos(arg) == 0) ? 0.0 / 0.0 : tan(arg);
+        case OP_ASIN: return (arg < -1 || arg > 1) ? 0.0 / 0.0 : asin(arg);
+        case OP_ACOS: return (arg < -1 || arg > 1) ? 0.0 / 0.0 : acos(arg);
+        case OP_ATAN: return atan(arg);
+        case OP_SINH: return sinh(arg);
+        case OP_COSH: return cosh(arg);
+        case OP_TANH: return tanh(arg);
+        case OP_SQUARE: return arg * arg;
+        default:      return 0.0 / 0.0;
+    }
+}
+
+/* ____________________________________________________________________________
+    EvaluationResult execute_program(const Program *prog, double x)
+    
+    Interprets compiled bytecode for a single value of x.
+    
+    Execution Strategy:
+    - Operands are pushed onto a local stack
+    - Operators replace their operands by the result
+    - Domain errors produce NaN which propagates to the final value
+    - The result is undefined when it is NaN or infinite
+   ____________________________________________________________________________
+*/
+EvaluationResult execute_program(const Program *prog, double x) {
+    EvaluationResult result = {0, 1, PARSER_OK};
+    double stack[MAX_STACK_DEPTH];
+    double slots[MAX_PROGRAM_SLOTS];
+    int sp = 0; /* Number of values on the stack */
+    int i;
+
+    /* Input columns only exist in the evaluator, see evaluator.h */
+    if (!prog || !prog->code || prog->max_stack_depth > MAX_STACK_DEPTH ||
+        prog->num_slots > MAX_PROGRAM_SLOTS || prog->num_inputs > 0) {
+        result.is_defined = 0;
+        result.error = PARSER_ERROR_INVALID_INPUT;
+        return result;
+    }
+
+    for (i = 0; i < prog->code_length; i++) {
+        const Instruction *ins = &prog->code[i];
+
+        switch (ins->opcode) {
+            case OP_CONST:
+                stack[sp++] = prog->constants[ins->operand];
+                break;
+            case OP_X:
+                stack[sp++] = x;
+                break;
+            case OP_VAR:
+                stack[sp++] = prog->variables[ins->operand];
+                break;
+            case OP_CALL:
+                stack[sp - 1] = registered_functions[ins->operand].function(stack[sp - 1]);
+                break;
+            case OP_STORE:
+                slots[ins->operand] = stack[sp - 1];
+                break;
+            case OP_LOAD:
+                stack[sp++] = slots[ins->operand];
+                break;
+            case OP_POLY: {
+                /* Horner's scheme, coefficients follow the degree */
+                const double *coefficient = prog->constants + ins->operand + 1;
+                int degree = (int)prog->constants[ins->operand];
+                double t = stack[sp - 1], value = coefficient[0];
+                int k;
+                for (k = 1; k <= degree; k++) {
+                    value = value * t + coefficient[k];
+                }
+                stack[sp - 1] = value;
+                break;
+            }
+            case OP_ADD:
+            case OP_SUB:
+            case OP_MUL:
+            case OP_DIV:
+            case OP_POW:
+                /* Binary operators combine the two topmost values */
+                sp--;
+                stack[sp - 1] = apply_binary(ins->opcode, stack[sp - 1], stack[sp]);
+                break;
+            default:
+                /* Unary operators replace the topmost value */
+                stack[sp - 1] = apply_unary(ins->opcode, stack[sp - 1]);
+                break;
+        }
+    }
+
+    result.value = stack[0];
+
+    /* NaN signals a domain error, infinity an overflow */
+    if (result.value != result.value ||
+        result.value == HUGE_VAL ||
+        result.value == -HUGE_VAL) {
+        result.is_defined = 0;
+    }
+
+    return result;
+}
+
+/* ____________________________________________________________________________
+    void free_program(Program *prog)
+    
+    Releases the instruction array, the constant pool and native code.
+   ____________________________________________________________________________
+*/
+void free_program(Program *prog) {
+    if (!prog) {
+        return;
+    }
+
+    jit_release(prog->native);
+    free(prog->code);
+    free(prog->constants);
+    memset(prog, 0, sizeof(*prog));
+}
+
+/* ____________________________________________________________________________
+    const char *parser_error_message(ParserError error)
+    
+    Maps parser error codes to messages for the user interface.
+   ____________________________________________________________________________
+*/
+const char *parser_error_message(ParserError error) {
+    switch (error) {
+        case PARSER_OK:                     return "No error";
+        case PARSER_ERROR_INVALID_INPUT:    return "Invalid or too long expression";
+        case PARSER_ERROR_SYNTAX:           return "Syntax error";
+        case PARSER_ERROR_UNKNOWN_FUNCTION: return "Unknown function";
+        case PARSER_ERROR_NUMBER_FORMAT:    return "Invalid number format";
+        case PARSER_ERROR_NUMBER_RANGE:     return "Number out of range";
+        case PARSER_ERROR_MEMORY:           return "Memory allocation failed";
+        case PARSER_ERROR_NOT_DIFFERENTIABLE:
+            return "Registered functions cannot be differentiated";
+    }
+    return "Unknown error";
+}
+
+
+/* ____________________________________________________________________________
+ 
+    FUNCTION TABLE
+   ____________________________________________________________________________
+*/
+
+/* ____________________________________________________________________________
+    static unsigned int hash_name(const char *name, size_t length)
+    
+    FNV-1a hash of a function name, used by the registry hash table.
+   ____________________________________________________________________________
+*/
+static unsigned int hash_name(const char *name, size_t length) {
+    unsigned long hash = 2166136261UL;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char)name[i];
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    return (unsigned int)hash;
+}
+
+/* ____________________________________________________________________________
+    static const FunctionEntry *lookup_builtin(const char *name, size_t length)
+    
+    Switch-based trie over the names in KNOWN_FUNCTIONS.
+    
+    Lookup Strategy:
+    - Branch on the name length
+    - Branch on the distinguishing character(s)
+    - Confirm the remaining characters with a single memcmp()
+    
+    Notes:
+    - Must be extended together with KNOWN_FUNCTIONS
+   ____________________________________________________________________________
+*/
+static const FunctionEntry *lookup_builtin(const char *name, size_t length) {
+    int index = -1;
+
+    switch (length) {
+        case 2:
+            if (name[0] == 'l' && name[1] == 'n') index = FN_LN;
+            break;
+
+        case 3:
+            switch (name[0]) {
+                case 'a': if (memcmp(name + 1, "bs", 2) == 0) index = FN_ABS; break;
+                case 'c': if (memcmp(name + 1, "os", 2) == 0) index = FN_COS; break;
+                case 'e': if (memcmp(name + 1, "xp", 2) == 0) index = FN_EXP; break;
+                case 'l': if (memcmp(name + 1, "og", 2) == 0) index = FN_LOG; break;
+                case 's': if (memcmp(name + 1, "in", 2) == 0) index = FN_SIN; break;
+                case 't': if (memcmp(name + 1, "an", 2) == 0) index = FN_TAN; break;
+            }
+            break;
+
+        case 4:
+            if (name[0] == 'a') {
+                /* Inverse trigonometric functions: asin, acos, atan */
+                switch (name[1]) {
+                    case 's': if (memcmp(name + 2, "in", 2) == 0) index = FN_ASIN; break;
+                    case 'c': if (memcmp(name + 2, "os", 2) == 0) index = FN_ACOS; break;
+                    case 't': if (memcmp(name + 2, "an", 2) == 0) index = FN_ATAN; break;
+                }
+            } else if (name[3] == 'h') {
+                /* Hyperbolic functions: sinh, cosh, tanh */
+                switch (name[0]) {
+                    case 's': if (memcmp(name + 1, "in", 2) == 0) index = FN_SINH; break;
+                    case 'c': if (memcmp(name + 1, "os", 2) == 0) index = FN_COSH; break;
+                    case 't': if (memcmp(name + 1, "an", 2) == 0) index = FN_TANH; break;
+                }
+            }
+            break;
+    }
+
+    return (index >= 0) ? &BUILTIN_FUNCTIONS[index] : NULL;
+}
+
+/* ____________________________________________________________________________
+    static int find_registry_slot(const char *name, size_t length)
+    
+    Finds the hash table slot of a name using linear probing.
+    Returns the slot holding the name, or the empty slot where it belongs.
+   ____________________________________________________________________________
+*/
+static int find_registry_slot(const char *name, size_t length) {
+    int slot = (int)(hash_name(name, length) % REGISTRY_HASH_SIZE);
+
+    while (registry_hash[slot] != 0) {
+        const char *candidate = registered_names[registry_hash[slot] - 1];
+        if (strlen(candidate) == length && memcmp(candidate, name, length) == 0) {
+            break;
+        }
+        slot = (slot + 1) % REGISTRY_HASH_SIZE;
+    }
+
+    return slot;
+}
+
+/* ____________________________________________________________________________
+    const FunctionEntry *lookup_function(const char *name, size_t length)
+    
+    Resolves a function name to its table entry.
+    
+    Lookup Strategy:
+    - Built-in functions through the switch-based trie
+    - Registered functions through the hash table, only if any exist
+   ____________________________________________________________________________
+*/
+const FunctionEntry *lookup_function(const char *name, size_t length) {
+    const FunctionEntry *entry;
+    int slot;
+
+    if (!name || length == 0 || length > MAX_FUNCTION_NAME_LEN) {
+        return NULL;
+    }
+
+    entry = lookup_builtin(name, length);
+    if (entry || num_registered_functions == 0) {
+        return entry;
+    }
+
+    slot = find_registry_slot(name, length);
+    if (registry_hash[slot] == 0) {
+        return NULL;
+    }
+
+    return &registered_functions[registry_hash[slot] - 1];
+}
+
+/* ____________________________________________________________________________
+    int register_function(const char *name, MathFunction function)
+    
+    Adds a function to the registry.
+    
+    Registration Strategy:
+    - Reject names that the expression syntax cannot express
+    - Reject names shadowing built-ins or already registered functions
+    - Store the entry and link it from the hash table
+   ____________________________________________________________________________
+*/
+int register_function(const char *name, MathFunction function) {
+    FunctionEntry *entry;
+    size_t length, i;
+    int slot;
+
+    if (!name || !function ||
+        num_registered_functions >= MAX_REGISTERED_FUNCTIONS) {
+        return 0;
+    }
+
+    /* Names consist of letters only, a leading 'x' is read as the variable */
+    length = strlen(name);
+    if (length == 0 || length > MAX_FUNCTION_NAME_LEN || name[0] == 'x') {
+        return 0;
+    }
+    for (i = 0; i < length; i++) {
+        if (!isalpha((unsigned char)name[i])) {
+            return 0;
+        }
+    }
+
+    /* Built-ins, variables and existing registrations cannot be replaced */
+    if (lookup_builtin(name, length) || lookup_variable(name, length) >= 0) {
+        return 0;
+    }
+    slot = find_registry_slot(name, length);
+    if (registry_hash[slot] != 0) {
+        return 0;
+    }
+
+    strcpy(registered_names[num_registered_functions], name);
+    entry = &registered_functions[num_registered_functions];
+    entry->name = registered_names[num_registered_functions];
+    entry->opcode = OP_CALL;
+    entry->index = num_registered_functions;
+    entry->function = function;
+
+    num_registered_functions++;
+    registry_hash[slot] = num_registered_functions;
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    MathFunction get_registered_function(int index)
+    
+    Returns the implementation stored at a registry index.
+   ____________________________________________________________________________
+*/
+MathFunction get_registered_function(int index) {
+    if (index < 0 || index >= num_registered_functions) {
+        return NULL;
+    }
+
+    return registered_functions[index].function;
+}
+
+/* ____________________________________________________________________________
+    int lookup_variable(const char *name, size_t length)
+    
+    Finds the slot of a variable name. There are only a few slots, so
+    they are searched linearly.
+   ____________________________________________________________________________
+*/
+int lookup_variable(const char *name, size_t length) {
+    int i;
+
+    if (!name || length == 0 || length > MAX_FUNCTION_NAME_LEN) {
+        return -1;
+    }
+
+    for (i = 0; i < num_variables; i++) {
+        if (strncmp(variable_names[i], name, length) == 0 &&
+            variable_names[i][length] == '\0') {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* ____________________________________________________________________________
+    int register_variable(const char *name)
+    
+    Adds a parameter to the variable slots.
+    
+    Registration Strategy:
+    - Known variables keep their slot
+    - Names follow the rules of register_function() and must not be
+      taken by a function
+   ____________________________________________________________________________
+*/
+int register_variable(const char *name) {
+    size_t length, i;
+    int slot;
+
+    if (!name) {
+        return -1;
+    }
+
+    length = strlen(name);
+    slot = lookup_variable(name, length);
+    if (slot >= 0) {
+        return slot;
+    }
+
+    /* Names consist of letters only, a leading 'x' is read as x */
+    if (length == 0 || length > MAX_FUNCTION_NAME_LEN || name[0] == 'x' ||
+        num_variables >= MAX_VARIABLES) {
+        return -1;
+    }
+    for (i = 0; i < length; i++) {
+        if (!isalpha((unsigned char)name[i])) {
+            return -1;
+        }
+    }
+    if (lookup_function(name, length)) {
+        return -1;
+    }
+
+    strcpy(variable_names[num_variables], name);
+    return num_variables++;
+}
+
+/* ____________________________________________________________________________
+    const char *variable_name(int slot)
+    
+    Returns the name of a variable slot.
+   ____________________________________________________________________________
+*/
+const char *variable_name(int slot) {
+    if (slot < 0 || slot >= num_variables) {
+        return NULL;
+    }
+
+    return variable_names[slot];
+}
+
+/* ____________________________________________________________________________
+    static int read_variable(const char *expr, size_t *length)
+    
+    Checks whether an identifier starts at expr and names a variable.
+    
+    Returns:
+    int - Variable slot, -1 if the identifier is not a variable
+    
+    Notes:
+    - 'x' is always a variable of one character, as it has been before
+      variables had names, so "xsin(x)" still reads x first
+    - length receives the number of characters of the identifier
+   ____________________________________________________________________________
+*/
+static int read_variable(const char *expr, size_t *length) {
+    size_t n = 0;
+
+    if (*expr == 'x') {
+        *length = 1;
+        return VAR_X;
+    }
+
+    while (isalpha((unsigned char)expr[n])) {
+        n++;
+    }
+    *length = n;
+
+    return lookup_variable(expr, n);
+}
@@ -5,19 +5,20 @@
 
     Implementation of a mathematical expression parser 
     capable of processing complex expressions with various functions, 
-    operators, and a single variable (x).
+    operators, and named variables (x, y, t and registered parameters).
 
     Key Features:
     - Support for mathematical operations 
     - Mathematical function parsing
-    - Single variable (x) support
+    - Variables resolved to slots at compile time
     - Error handling and validation
     - Undefined point detection
+    - Compilation to postfix bytecode for repeated evaluation
 
     Expression Grammar:
     expression = term {("+"|"-") term}
     term       = factor {("*"|"/") factor}
-    factor     = number | "x" | function "(" expression ")" | 
+    factor     = number | variable | function "(" expression ")" | 
                 "(" expression ")" | "-" factor | factor "^" factor
 
     Dialect: ANSI C
@@ -35,11 +36,36 @@
 #include <stdio.h>   /* Input/output operations */
 #include <string.h>  /* String manipulation functions */
 #include <ctype.h>   /* Character type functions */
-#include <errno.h>   /* Error number definitions */
+#include <float.h>   /* Limits of floating-point types */
 
 
 #define MAX_EXPR_LEN 1024
 
+/*
+  Maximum depth of the evaluation stack of a compiled program.
+  Every operand in an expression is separated from the next one by at least
+  one operator character, so an expression of MAX_EXPR_LEN characters can
+  never keep more than half of that many values on the stack at once.
+*/
+#define MAX_STACK_DEPTH (MAX_EXPR_LEN / 2 + 1)
+
+/* Longest function name accepted in expressions */
+#define MAX_FUNCTION_NAME_LEN 9
+
+/* Maximum number of functions that can be added by register_function() */
+#define MAX_REGISTERED_FUNCTIONS 32
+
+/*
+  Variable slots
+  Every variable name is resolved to a slot index at compile time. The
+  first slots are built in, register_variable() adds parameters after
+  them up to MAX_VARIABLES slots in total.
+*/
+#define MAX_VARIABLES 8
+#define VAR_X 0    /* Horizontal coordinate 'x' */
+#define VAR_Y 1    /* Vertical coordinate 'y' of grid plots */
+#define VAR_T 2    /* Parameter 't' */
+
 /*
   Array of supported mathematical function names.
   Contains strings representing all valid function names that can be used
@@ -59,6 +85,38 @@ extern const char *KNOWN_FUNCTIONS[];
  */
 extern const int NUM_KNOWN_FUNCTIONS;
 
+/*
+  Error codes reported by the parser and the compiler
+  Errors describe problems with the expression text. They are recorded in
+  the Parser structure instead of terminating the process, so one bad
+  expression never affects the caller.
+  
+  Values:
+  PARSER_OK                     - No error
+  PARSER_ERROR_INVALID_INPUT    - NULL or over-long expression
+  PARSER_ERROR_SYNTAX           - Unexpected character or end of expression
+  PARSER_ERROR_UNKNOWN_FUNCTION - Function name not in KNOWN_FUNCTIONS
+  PARSER_ERROR_NUMBER_FORMAT    - Malformed numeric literal
+  PARSER_ERROR_NUMBER_RANGE     - Numeric literal out of double range
+  PARSER_ERROR_MEMORY           - Memory allocation failed
+  PARSER_ERROR_NOT_DIFFERENTIABLE - Derivative of a registered function
+                                  requested
+  
+  Notes:
+  - Undefined values (e.g. division by zero) are not errors, they are
+    reported per sample through EvaluationResult.is_defined
+*/
+typedef enum {
+    PARSER_OK = 0,
+    PARSER_ERROR_INVALID_INPUT,
+    PARSER_ERROR_SYNTAX,
+    PARSER_ERROR_UNKNOWN_FUNCTION,
+    PARSER_ERROR_NUMBER_FORMAT,
+    PARSER_ERROR_NUMBER_RANGE,
+    PARSER_ERROR_MEMORY,
+    PARSER_ERROR_NOT_DIFFERENTIABLE
+} ParserError;
+
 /*
   Parser context structure
   Maintains the current state of the parsing process including the expression
@@ -69,6 +127,10 @@ extern const int NUM_KNOWN_FUNCTIONS;
          Updated as parsing progresses through the expression
   x    - Value of the variable 'x' for expression evaluation
          Used when 'x' is encountered in the expression
+  error - First error encountered while parsing, PARSER_OK if none
+          Once set, the parsing functions return immediately
+  values - Values of all variable slots (values[VAR_X] is not used),
+           NULL when only x is known and other variables are undefined
   
   Usage:
   - Created and initialized by evaluate_expression()
@@ -78,6 +140,8 @@ extern const int NUM_KNOWN_FUNCTIONS;
 typedef struct {
     const char *expr;  /* Current position in expression string */
     double x;         /* Value of variable x for evaluation */
+    ParserError error; /* Error state */
+    const double *values; /* Values of the other variables */
 } Parser;
 
 /*
@@ -90,16 +154,174 @@ typedef struct {
   is_defined - Flag indicating whether the result is mathematically defined
                0 for undefined (e.g., division by zero)
                1 for defined
+  error      - PARSER_OK, or the reason why the expression could not be
+               evaluated at all (is_defined is 0 in that case)
   
   Usage:
   - Returned by evaluate_expression()
   - Check is_defined before using value
 */
 typedef struct {
-    double value;     /* Numerical result */
-    int is_defined;   /* Definition status */
+    double value;      /* Numerical result */
+    int is_defined;    /* Definition status */
+    ParserError error; /* Error status */
 } EvaluationResult;
 
+/*
+  Operation codes of the compiled expression bytecode
+  Each instruction of a compiled program either pushes a value onto the
+  evaluation stack or replaces the topmost value(s) by the result of an
+  operation. The program is stored in postfix (reverse Polish) order.
+  
+  Groups:
+  - Operands:  OP_CONST (operand = index into the constant pool), OP_X,
+               OP_VAR (operand = variable slot other than VAR_X)
+  - Binary:    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW
+  - Unary:     OP_NEG, OP_SQUARE and one opcode per entry of KNOWN_FUNCTIONS
+  - Call:      OP_CALL (operand = index of a registered function)
+  - Slots:     OP_STORE copies the topmost value into a slot, OP_LOAD
+               pushes it (operand = slot index); used for subexpressions
+               shared within or between compiled expressions
+  - Polynomial: OP_POLY replaces the topmost value t by a polynomial in t
+               evaluated by Horner's scheme (operand = index of the degree
+               n in the constant pool, followed by the n + 1 coefficients
+               from the highest power down)
+  - Input:     OP_COLUMN pushes a value computed beforehand for the
+               sample (operand = input column), see compile_sweep()
+*/
+typedef enum {
+    OP_CONST,   /* Push constant from the constant pool */
+    OP_X,       /* Push value of the variable x */
+    OP_ADD,     /* Addition */
+    OP_SUB,     /* Subtraction */
+    OP_MUL,     /* Multiplication */
+    OP_DIV,     /* Division */
+    OP_POW,     /* Exponentiation */
+    OP_NEG,     /* Unary minus */
+    OP_ABS,     /* Absolute value */
+    OP_EXP,     /* Exponential function */
+    OP_LN,      /* Natural logarithm */
+    OP_LOG,     /* Base-10 logarithm */
+    OP_SIN,     /* Sine */
+    OP_COS,     /* Cosine */
+    OP_TAN,     /* Tangent */
+    OP_ASIN,    /* Arcsine */
+    OP_ACOS,    /* Arccosine */
+    OP_ATAN,    /* Arctangent */
+    OP_SINH,    /* Hyperbolic sine */
+    OP_COSH,    /* Hyperbolic cosine */
+    OP_TANH,    /* Hyperbolic tangent */
+    OP_CALL,    /* Function added by register_function() */
+    OP_SQUARE,  /* Square, produced by the optimizer for e^2 */
+    OP_STORE,   /* Copy topmost value into a slot */
+    OP_LOAD,    /* Push value of a slot */
+    OP_POLY,    /* Polynomial, produced by the optimizer for sums of powers */
+    OP_VAR,     /* Push value of a variable other than x */
+    OP_COLUMN   /* Push precomputed value of the sample */
+} OpCode;
+
+/*
+  Single instruction of a compiled program
+  
+  Members:
+  opcode  - Operation to perform
+  operand - Index into the constant pool for OP_CONST,
+            registry index for OP_CALL,
+            slot index for OP_STORE and OP_LOAD,
+            index of the degree in the constant pool for OP_POLY,
+            variable slot for OP_VAR,
+            input column for OP_COLUMN,
+            unused otherwise
+*/
+typedef struct {
+    OpCode opcode;    /* Operation code */
+    int operand;      /* Instruction argument */
+} Instruction;
+
+/* Signature of functions that can be registered for use in expressions */
+typedef double (*MathFunction)(double);
+
+/*
+  Function table entry
+  Result of a function name lookup. Built-in functions are compiled to
+  their own opcode, registered functions to OP_CALL with their index.
+  
+  Members:
+  name     - Function name as written in expressions
+  opcode   - Opcode emitted for calls of the function
+  index    - Registry index for OP_CALL, -1 for built-in functions
+  function - Implementation of a registered function, NULL for built-ins
+*/
+typedef struct {
+    const char *name;       /* Function name */
+    OpCode opcode;          /* Compiled opcode */
+    int index;              /* Registry index */
+    MathFunction function;  /* Registered implementation */
+} FunctionEntry;
+
+/* Maximum number of slots of a compiled program */
+#define MAX_PROGRAM_SLOTS 64
+
+/* Maximum number of expressions compiled into one program */
+#define MAX_PROGRAM_OUTPUTS 16
+
+/* Maximum number of input columns read by OP_COLUMN; the columns are
+   the outputs of another program */
+#define MAX_PROGRAM_INPUTS MAX_PROGRAM_OUTPUTS
+
+/* Expression tree node, defined in ast.h */
+typedef struct ExprNode ExprNode;
+
+/* Native code of a program, defined in jit.c */
+typedef struct NativeCode NativeCode;
+
+/*
+  Compiled mathematical expression
+  Flat postfix bytecode together with its constant pool. The program is
+  produced once by compile_expression() and can then be executed for any
+  number of x values without touching the expression text again.
+  
+  Members:
+  code            - Array of instructions in postfix order
+  code_length     - Number of instructions in code
+  code_capacity   - Allocated size of the code array
+  constants       - Constant pool referenced by OP_CONST instructions
+  num_constants   - Number of values in the constant pool
+  const_capacity  - Allocated size of the constant pool
+  max_stack_depth - Deepest evaluation stack the program needs
+  num_slots       - Number of slots used by OP_STORE and OP_LOAD
+  num_outputs     - Number of compiled expressions, their values are
+                    left on the stack in order (bottom first)
+  native          - Machine code of the program from jit_compile(),
+                    NULL when the bytecode is interpreted
+  variables       - Values of the variable slots read by OP_VAR, zero
+                    after compilation; the caller sets them before
+                    execution, the slot of x is not used
+  variable_mask   - Bit k is set if the program reads variable slot k
+  num_inputs      - Number of input columns read by OP_COLUMN, zero
+                    unless compiled by compile_sweep()
+  
+  Usage:
+  - Filled by compile_expression()
+  - Executed by execute_program()
+  - Released by free_program()
+*/
+typedef struct {
+    Instruction *code;    /* Instruction stream */
+    int code_length;      /* Number of instructions */
+    int code_capacity;    /* Allocated instructions */
+    double *constants;    /* Constant pool */
+    int num_constants;    /* Number of constants */
+    int const_capacity;   /* Allocated constants */
+    int max_stack_depth;  /* Required stack depth */
+    int num_slots;        /* Subexpression slots */
+    int num_outputs;      /* Number of results */
+    NativeCode *native;   /* Optional machine code */
+    double variables[MAX_VARIABLES]; /* Values of OP_VAR */
+    unsigned variable_mask;          /* Variables read */
+    int num_inputs;                  /* Columns of OP_COLUMN */
+} Program;
+
 /*
   Primary function for evaluating mathematical expressions
   Entry point for the expression parser that handles the complete evaluation
@@ -117,8 +339,8 @@ typedef struct {
   - Flag indicating if the result is mathematically defined
   
   Error Handling:
-  - Returns {0, 0} for undefined results
-  - Sets errno for various error conditions
+  - Returns is_defined = 0 for undefined results (e.g., x/0 at x = 0)
+  - Returns is_defined = 0 and the error code for invalid expressions
   
   Thread Safety:
   - Function is reentrant and thread-safe
@@ -126,6 +348,294 @@ typedef struct {
  */
 EvaluationResult evaluate_expression(const char *expr, double x);
 
+/*
+  Evaluates an expression with values for all variables
+  
+  Parameters:
+  expr   - Null-terminated string containing the mathematical expression
+  values - MAX_VARIABLES values indexed by variable slot, values[VAR_X]
+           is substituted for x
+  
+  Returns:
+  EvaluationResult with the same meaning as evaluate_expression()
+  
+  Notes:
+  - evaluate_expression() leaves all variables other than x undefined
+*/
+EvaluationResult evaluate_expression_at(const char *expr, const double *values);
+
+/*
+  Parses a mathematical expression into an expression tree
+  Uses the same recursive descent grammar as evaluate_expression(), but
+  instead of computing a value it builds a tree of ExprNode structures.
+  
+  Parameters:
+  expr - Null-terminated string containing the mathematical expression
+  tree - Receives the root of the tree, NULL on error
+  
+  Returns:
+  ParserError - PARSER_OK on success, error code otherwise
+  
+  Notes:
+  - The caller must release the tree with ast_free()
+*/
+ParserError parse_expression_tree(const char *expr, ExprNode **tree);
+
+/*
+  Compiles a mathematical expression into postfix bytecode
+  Parses the expression exactly once into an expression tree, simplifies
+  the tree with ast_optimize(), collects polynomials with
+  ast_polynomials() and emits instructions, collecting numeric
+  constants into a constant pool.
+  
+  Parameters:
+  expr - Null-terminated string containing the mathematical expression
+         Should be checked by validate_expression() beforehand
+  prog - Pointer to Program structure that receives the bytecode
+         Any previous content is overwritten without being released
+  
+  Returns:
+  ParserError - PARSER_OK if the expression was compiled successfully
+                Error code describing the problem otherwise
+  
+  Error Handling:
+  - On error the program is left empty and needs no free_program()
+  
+  Notes:
+  - The caller must release the program with free_program()
+*/
+ParserError compile_expression(const char *expr, Program *prog);
+
+/*
+  Compiles several expressions into one program
+  The program computes the value of every expression for the same x.
+  Subexpressions occurring more than once, within one expression or
+  across them, are computed once and reused through slots.
+  
+  Parameters:
+  exprs - Array of count expressions
+  count - Number of expressions, 1 to MAX_PROGRAM_OUTPUTS
+  prog  - Pointer to Program structure that receives the bytecode
+  
+  Returns:
+  ParserError - PARSER_OK on success, the error of the first invalid
+                expression otherwise
+  
+  Notes:
+  - compile_expression() is the single expression case
+  - The caller must release the program with free_program()
+*/
+ParserError compile_expressions(const char *const *exprs, int count,
+                                Program *prog);
+
+/*
+  Compiles several expressions or their derivatives into one program
+  Same as compile_expressions(), but expression k is differentiated
+  orders[k] times with respect to x before it is compiled. Derivatives
+  are built symbolically, no finite differences are involved.
+  
+  Parameters:
+  exprs  - Array of count expressions
+  orders - Array of count derivative orders (0 keeps the expression),
+           NULL compiles the expressions themselves
+  count  - Number of expressions, 1 to MAX_PROGRAM_OUTPUTS
+  prog   - Pointer to Program structure that receives the bytecode
+  
+  Returns:
+  ParserError - PARSER_OK on success
+                PARSER_ERROR_NOT_DIFFERENTIABLE if a differentiated
+                expression calls a registered function of x
+                the error of the first invalid expression otherwise
+  
+  Notes:
+  - A function and its derivative compiled together share their common
+    subexpressions, e.g. sin(x) in both x*sin(x) and sin(x)+x*cos(x)
+*/
+ParserError compile_derivatives(const char *const *exprs, const int *orders,
+                                int count, Program *prog);
+
+/*
+  Compiles expressions for repeated evaluation with changing variables
+  Same as compile_derivatives(), but the work is split between two
+  programs. Every largest subexpression that does not read a variable
+  of the varying mask is moved into the invariant program, which is
+  run once per x; the frame program reads its results with OP_COLUMN
+  and recomputes only the rest whenever a varying variable changes.
+  
+  Parameters:
+  exprs     - Array of count expressions
+  orders    - Array of count derivative orders, may be NULL
+  count     - Number of expressions, 1 to MAX_PROGRAM_OUTPUTS
+  varying   - Bit k is set for every variable slot k that changes
+              between runs of the frame program; the bit of x is ignored
+  invariant - Receives the invariant program, one output per input
+              column of the frame program; stays empty (no code) when
+              nothing could be moved
+  frame     - Receives the frame program, frame->num_inputs is the
+              number of outputs of the invariant program
+  
+  Returns:
+  ParserError - Same as compile_derivatives()
+  
+  Notes:
+  - Both programs must be released with free_program(), also on failure
+  - Single leaves are never moved, reading them is as cheap as reading
+    a column; at most MAX_PROGRAM_INPUTS subexpressions are moved and
+    identical subexpressions share their column
+  - The frame program computes every value exactly as the program of
+    compile_derivatives() would, provided the input columns hold the
+    unnormalized results of the invariant program, see
+    evaluate_expression_points_raw() in evaluator.h
+*/
+ParserError compile_sweep(const char *const *exprs, const int *orders,
+                          int count, unsigned varying, Program *invariant,
+                          Program *frame);
+
+/*
+  Executes a compiled program for a single value of x
+  Runs the bytecode on a local evaluation stack. The expression text is
+  not needed any more, so the per-sample cost is only the arithmetic.
+  
+  Parameters:
+  prog - Pointer to program produced by compile_expression()
+  x    - Value to substitute for the variable 'x'
+  
+  Returns:
+  EvaluationResult with the same meaning as evaluate_expression()
+  For programs of several expressions the result of the first one
+  
+  Error Handling:
+  - Division by zero and domain errors of functions make the result
+    undefined, execution never stops early
+  
+  Thread Safety:
+  - Function is reentrant, the program is only read
+*/
+EvaluationResult execute_program(const Program *prog, double x);
+
+/*
+  Finds a function by name
+  Built-in functions are resolved by a switch-based trie on the name
+  length and characters, so a lookup costs a few comparisons regardless
+  of the number of functions. Registered functions are only searched
+  in a hash table when the name is not a built-in.
+  
+  Parameters:
+  name   - Pointer to the function name, need not be null-terminated
+  length - Number of characters of the name
+  
+  Returns:
+  const FunctionEntry* - Matching function table entry
+                         NULL if the name is unknown
+*/
+const FunctionEntry *lookup_function(const char *name, size_t length);
+
+/*
+  Adds a function that can be called from expressions
+  
+  Parameters:
+  name     - Function name, letters only, at most MAX_FUNCTION_NAME_LEN
+             characters, must not start with 'x' (read as the variable)
+             and must not be the name of a built-in or a variable
+  function - Implementation, NaN or infinite results are undefined points
+  
+  Returns:
+  int - 1 if the function was registered
+        0 on invalid name, duplicate name or full registry
+  
+  Thread Safety:
+  - Not thread-safe, register functions before evaluation starts
+*/
+int register_function(const char *name, MathFunction function);
+
+/*
+  Finds a variable by name
+  
+  Parameters:
+  name   - Pointer to the variable name, need not be null-terminated
+  length - Number of characters of the name
+  
+  Returns:
+  int - Variable slot, -1 if the name is not a variable
+*/
+int lookup_variable(const char *name, size_t length);
+
+/*
+  Adds a named parameter that can be used in expressions
+  The built-in variables x, y and t always exist.
+  
+  Parameters:
+  name - Variable name, the same rules as for register_function() apply,
+         and it must not be the name of a function
+  
+  Returns:
+  int - Slot of the variable, the existing slot if it is already known
+        -1 on invalid name or when all MAX_VARIABLES slots are taken
+  
+  Thread Safety:
+  - Not thread-safe, register variables before compiling expressions
+*/
+int register_variable(const char *name);
+
+/*
+  Returns the name of a variable slot
+  
+  Returns:
+  const char* - Variable name, NULL for an unused slot
+*/
+const char *variable_name(int slot);
+
+/*
+  Returns the implementation of a registered function
+  
+  Parameters:
+  index - Registry index taken from FunctionEntry or an OP_CALL operand
+  
+  Returns:
+  MathFunction - Function pointer, NULL for invalid index
+*/
+MathFunction get_registered_function(int index);
+
+/*
+  Applies a binary bytecode operator to two values
+  
+  Parameters:
+  opcode - One of OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW
+  a, b   - Left and right operand
+  
+  Returns:
+  double - Result of the operation, NaN if it is undefined
+  
+  Notes:
+  - NaN operands always produce NaN
+  - Shared by all evaluators of compiled programs
+*/
+double apply_binary(OpCode opcode, double a, double b);
+
+/*
+  Applies a unary bytecode operator to a value
+  
+  Parameters:
+  opcode - OP_NEG or one of the function opcodes
+  arg    - Operand
+  
+  Returns:
+  double - Result of the operation, NaN outside of the function domain
+*/
+double apply_unary(OpCode opcode, double arg);
+
+/*
+  Releases all memory owned by a compiled program
+  
+  Parameters:
+  prog - Pointer to program to release
+  
+  Notes:
+  - Resets all members so the structure can be reused
+  - Safe to call with NULL pointer
+*/
+void free_program(Program *prog);
+
 /*
   Parses addition and subtraction operations in the expression
   Implements the highest level of operator precedence parsing,
@@ -142,8 +652,8 @@ EvaluationResult evaluate_expression(const char *expr, double x);
   double - Computed value of the expression
   
   Error Handling:
-  - Exits with status 2 on syntax errors
-  - Sets errno for mathematical errors
+  - Sets p->error on syntax errors
+  - Returns NaN for mathematical errors
   
   Notes:
   - Left-associative evaluation
@@ -167,8 +677,8 @@ double parse_expression(Parser *p);
   double - Computed value of the term
   
   Error Handling:
-  - Exits with status 2 on syntax errors
-  - Sets errno for division by zero
+  - Sets p->error on syntax errors
+  - Returns NaN for division by zero
   
   Notes:
   - Left-associative evaluation
@@ -195,8 +705,8 @@ double parse_term(Parser *p);
   double - Computed value of the factor
   
   Error Handling:
-  - Exits with status 2 on syntax errors
-  - Sets errno for domain errors
+  - Sets p->error on syntax errors
+  - Returns NaN for domain errors
   
   Notes:
   - Right-associative for exponentiation
@@ -209,7 +719,7 @@ double parse_factor(Parser *p);
 /*
   Parses and evaluates mathematical function calls
   Handles the parsing and computation of all supported mathematical
-  functions listed in KNOWN_FUNCTIONS.
+  functions listed in KNOWN_FUNCTIONS and of registered functions.
   
   Parameters:
   p - Pointer to Parser structure containing parsing context
@@ -219,9 +729,8 @@ double parse_factor(Parser *p);
   double - Computed value of the function
   
   Error Handling:
-  - Exits with status 2 for unknown functions
-  - Sets errno for domain errors
-  - Sets errno for undefined results
+  - Sets p->error for unknown functions
+  - Returns NaN for domain errors and undefined results
   
   Supported Functions:
   - Trigonometric: sin, cos, tan
@@ -231,7 +740,7 @@ double parse_factor(Parser *p);
   - Other: abs, exp
   
   Notes:
-  - Validates function names against KNOWN_FUNCTIONS
+  - Resolves function names with lookup_function()
   - Handles domain restrictions (e.g., asin range [-1,1])
   - Detects undefined points (e.g., tan(π/2))
 */
@@ -256,8 +765,8 @@ double parse_function(Parser *p);
   - Leading decimal point: ".123"
   
   Error Handling:
-  - Exits with status 2 for invalid number format
-  - Sets errno for out of range values
+  - Sets p->error for invalid number format
+  - Sets p->error for out of range values
   
   Notes:
   - Handles both positive and negative numbers
@@ -301,12 +810,10 @@ void skip_whitespace(Parser *p);
   expected - The character that should appear at the current position
   
   Error Handling:
-  - If the current character doesn't match the expected character:
-    - Prints error message to stderr with context
-    - Exits with status code 2
-  - If end of expression is reached unexpectedly:
-    - Prints appropriate error message
-    - Exits with status code 2
+  - If the current character doesn't match the expected character,
+    or the end of expression is reached unexpectedly:
+    - Sets p->error to PARSER_ERROR_SYNTAX
+    - Leaves the parser position unchanged
   
   Notes:
   - Automatically skips leading whitespace before matching
@@ -334,7 +841,7 @@ void match(Parser *p, char expected);
   - Proper operator placement and sequence
   - Valid function names and usage
   - Correct number format
-  - Variable 'x' usage
+  - Variable usage (x and names known to lookup_variable())
   - No consecutive operators (except unary minus)
   - No missing operators between operands
   
@@ -354,4 +861,15 @@ void match(Parser *p, char expected);
 */
 int validate_expression(const char *expr);
 
+/*
+  Returns a human readable description of a parser error code
+  
+  Parameters:
+  error - Error code from Parser, EvaluationResult or compile_expression()
+  
+  Returns:
+  const char* - Static string, never NULL
+*/
+const char *parser_error_message(ParserError error);
+
 #endif /* PARSER_H */
\ No newline at end of file
@@ -0,0 +1,904 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module plot.c
+
+    Plotting pipeline shared by the single plot and batch modes.
+
+    Implementation Details:
+    - Input checks and messages are the ones of the original command
+      line handling, so both modes report problems the same way
+    - Jobs do not share any state, several jobs may be rendered by
+      different threads at the same time
+    - Only names of variables are global (see register_variable()),
+      their values are stored per job
+    - Cached graphs are stored as the bytes of the written file, a hit
+      copies them to the output path; keys hold variable names, never
+      slot numbers, as slots differ between processes
+    - The text key of a job stores a link record, the canonical form
+      of its compiled programs, which is the key of the graph itself
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#include <stdarg.h>      /* Variable argument lists */
+#include "plot.h"
+#include "sampler.h"     /* Adaptive sampling of compiled expressions */
+#include "postscript.h"  /* PostScript graph generation utilities */
+#include "jit.h"         /* Native code of compiled programs */
+#include "stream.h"      /* Streamed uniform sampling */
+#include "evaluator.h"   /* Grid evaluation */
+
+/* Version of the cache keys, changed whenever the output format changes */
+#define PLOT_CACHE_VERSION "plot 1"
+
+/* Flag of stored graphs with undefined values */
+#define PLOT_CACHE_UNDEFINED 1u
+
+/* Flag of link records, their bytes are the canonical key of a graph */
+#define PLOT_CACHE_LINK 2u
+
+/* Internal function prototypes */
+static int parse_range_value(const char **text, double *value);
+static void key_settings(const PlotJob *job, CacheKey *key);
+static int write_stored(PlotJob *job, const CacheBlob *blob);
+static int store_output(PlotJob *job, const CacheKey *key);
+static void store_link(PlotJob *job, const CacheKey *key);
+static void report_undefined(PlotJob *job);
+static int render_job(PlotJob *job, int num_threads);
+static int render_adaptive(PlotJob *job, int num_threads);
+static int render_streamed(PlotJob *job, int num_threads);
+static int render_grid(PlotJob *job, int num_threads);
+static int render_sweep(PlotJob *job, int num_threads);
+
+/* ____________________________________________________________________________
+    int set_plot_function(PlotJob *job, const char *input)
+
+    Copies the expression while removing whitespace, quoted expressions
+    may therefore contain spaces, and validates its characters.
+   ____________________________________________________________________________
+*/
+int set_plot_function(PlotJob *job, const char *input) {
+    size_t i, j = 0;
+
+    /* Copy while removing whitespace */
+    for (i = 0; input[i] != '\0'; i++) {
+        if (!isspace((unsigned char)input[i])) {
+            if (j >= sizeof(job->function) - 1) {
+                plot_message(job, "Error: Function too long\n");
+                return 1;
+            }
+            job->function[j++] = input[i];
+        }
+    }
+    job->function[j] = '\0';
+
+    /* Validate characters */
+    for (i = 0; job->function[i] != '\0'; i++) {
+        char c = job->function[i];
+        if (!isalnum((unsigned char)c) && c != '(' && c != ')' &&
+            c != '^' && c != '*' && c != '/' && c != '+' && c != '-' &&
+            c != '.' && c != ';' && c != '\'') {
+            plot_message(job, "Error: Invalid character in function: '%c'\n", c);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    int set_plot_output(PlotJob *job, const char *path)
+
+    Stores a copy of the output path in the job.
+   ____________________________________________________________________________
+*/
+int set_plot_output(PlotJob *job, const char *path) {
+    if (strlen(path) >= sizeof(job->output_file)) {
+        plot_message(job, "Error: Output file path too long\n");
+        return 1;
+    }
+
+    strcpy(job->output_file, path);
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    int set_plot_range(PlotJob *job, const char *text)
+
+    Parses the four colon separated limits of the plotting window.
+
+    Implementation Notes:
+    - The text is not modified and no static state is used, unlike
+      strtok(), so ranges can be parsed anywhere
+   ____________________________________________________________________________
+*/
+int set_plot_range(PlotJob *job, const char *text) {
+    static const char *const names[4] = { "xmin", "xmax", "ymin", "ymax" };
+    double *limits[4];
+    int k;
+
+    limits[0] = &job->xmin;
+    limits[1] = &job->xmax;
+    limits[2] = &job->ymin;
+    limits[3] = &job->ymax;
+
+    for (k = 0; k < 4; k++) {
+        if (!parse_range_value(&text, limits[k])) {
+            plot_message(job, "Error: Invalid %s value\n", names[k]);
+            return 1;
+        }
+    }
+
+    /* Validate ranges */
+    if (job->xmax <= job->xmin || job->ymax <= job->ymin) {
+        plot_message(job, "Error: Invalid range (max must be greater than min)\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    static int parse_range_value(const char **text, double *value)
+
+    Parses one limit and advances past the following separator. Empty
+    fields are skipped the way strtok() skips them.
+   ____________________________________________________________________________
+*/
+static int parse_range_value(const char **text, double *value) {
+    char field[64];
+    const char *start = *text;
+    const char *end;
+    size_t length;
+
+    while (*start == ':') {
+        start++;
+    }
+    end = strchr(start, ':');
+    length = end ? (size_t)(end - start) : strlen(start);
+    if (length == 0 || length >= sizeof(field)) {
+        return 0;
+    }
+
+    memcpy(field, start, length);
+    field[length] = '\0';
+    *text = end ? end + 1 : start + length;
+
+    return sscanf(field, "%lf", value) == 1;
+}
+
+/* ____________________________________________________________________________
+    int set_plot_variable(PlotJob *job, const char *assignment)
+
+    Parses name=value and stores the value in the slot of the name.
+   ____________________________________________________________________________
+*/
+int set_plot_variable(PlotJob *job, const char *assignment) {
+    char name[MAX_FUNCTION_NAME_LEN + 1];
+    const char *equals = strchr(assignment, '=');
+    size_t length = equals ? (size_t)(equals - assignment) : 0;
+    double value;
+    char extra;
+    int slot;
+
+    if (length == 0 || length > MAX_FUNCTION_NAME_LEN ||
+        sscanf(equals + 1, "%lf%c", &value, &extra) != 1 ||
+        value != value || value == HUGE_VAL || value == -HUGE_VAL) {
+        plot_message(job, "Error: Invalid variable assignment '%.64s'\n",
+                     assignment);
+        return 1;
+    }
+
+    memcpy(name, assignment, length);
+    name[length] = '\0';
+    slot = register_variable(name);
+    if (slot < 0 || slot == VAR_X) {
+        plot_message(job, "Error: Invalid variable name '%s'\n", name);
+        return 1;
+    }
+
+    job->variables[slot] = value;
+    job->variables_set |= 1u << slot;
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    int set_plot_sweep(PlotJob *job, const char *range)
+
+    Parses name=from:to:frames and stores the sweep of the name.
+   ____________________________________________________________________________
+*/
+int set_plot_sweep(PlotJob *job, const char *range) {
+    char name[MAX_FUNCTION_NAME_LEN + 1];
+    const char *equals = strchr(range, '=');
+    size_t length = equals ? (size_t)(equals - range) : 0;
+    double from, to;
+    int frames, slot;
+    char extra;
+
+    if (length == 0 || length > MAX_FUNCTION_NAME_LEN ||
+        sscanf(equals + 1, "%lf:%lf:%d%c", &from, &to, &frames, &extra) != 3 ||
+        from != from || from == HUGE_VAL || from == -HUGE_VAL ||
+        to != to || to == HUGE_VAL || to == -HUGE_VAL ||
+        frames < 1 || frames > PLOT_MAX_FRAMES) {
+        plot_message(job, "Error: Invalid sweep '%.64s'\n", range);
+        return 1;
+    }
+
+    memcpy(name, range, length);
+    name[length] = '\0';
+    slot = register_variable(name);
+    if (slot < 0 || slot == VAR_X || slot == VAR_Y) {
+        plot_message(job, "Error: Invalid variable name '%s'\n", name);
+        return 1;
+    }
+
+    job->sweep.slot = slot;
+    job->sweep.from = from;
+    job->sweep.to = to;
+    job->sweep.num_frames = frames;
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    int restore_plot(PlotJob *job)
+
+    Looks the job up under its text key and follows the link record
+    found there to the stored graph, which is copied to the output file.
+    The key is kept for render_plot().
+
+    Key Contents:
+    - Key version and the cleaned expression
+    - Names and values of all variables given a value
+    - Window, sampling and drawing settings, see key_settings()
+   ____________________________________________________________________________
+*/
+int restore_plot(PlotJob *job) {
+    CacheBlob *link, *blob;
+    CacheKey key;
+    int slot, result;
+
+    if (!job->cache) {
+        return -1;
+    }
+
+    cache_key_free(&job->text_key);
+    cache_key_string(&job->text_key, PLOT_CACHE_VERSION);
+    cache_key_string(&job->text_key, job->function);
+    for (slot = 0; slot < MAX_VARIABLES; slot++) {
+        if (job->variables_set & (1u << slot)) {
+            cache_key_string(&job->text_key, variable_name(slot));
+            cache_key_double(&job->text_key, job->variables[slot]);
+        }
+    }
+    key_settings(job, &job->text_key);
+
+    link = cache_get(job->cache, &job->text_key);
+    if (!link) {
+        return -1;
+    }
+    if (!(link->flags & PLOT_CACHE_LINK)) {
+        cache_release(job->cache, link);
+        return -1;
+    }
+
+    /* The record is used as the key in place, it is never modified */
+    key.bytes = (unsigned char *)link->bytes;
+    key.length = link->length;
+    key.capacity = link->length;
+    key.failed = 0;
+    blob = cache_get(job->cache, &key);
+    cache_release(job->cache, link);
+    if (!blob) {
+        return -1;
+    }
+
+    result = write_stored(job, blob);
+    cache_release(job->cache, blob);
+    return result;
+}
+
+/* ____________________________________________________________________________
+    static void key_settings(const PlotJob *job, CacheKey *key)
+
+    Appends everything besides the expressions the graph depends on.
+    Settings that do not apply to the job are zero and harmless.
+   ____________________________________________________________________________
+*/
+static void key_settings(const PlotJob *job, CacheKey *key) {
+    cache_key_double(key, job->xmin);
+    cache_key_double(key, job->xmax);
+    cache_key_double(key, job->ymin);
+    cache_key_double(key, job->ymax);
+    cache_key_int(key, job->num_points);
+    cache_key_int(key, job->grid_size);
+    cache_key_int(key, job->num_contours);
+    cache_key_int(key, job->heatmap);
+    cache_key_int(key, job->sweep.num_frames);
+    if (job->sweep.num_frames > 0) {
+        cache_key_string(key, variable_name(job->sweep.slot));
+        cache_key_double(key, job->sweep.from);
+        cache_key_double(key, job->sweep.to);
+    }
+}
+
+/* ____________________________________________________________________________
+    int compile_plot(PlotJob *job)
+
+    Validates the expressions and compiles them into one program, samples
+    are then evaluated from bytecode only.
+
+    Implementation Notes:
+    - The function is split at ';' into a local copy, every part is
+      validated on its own
+    - Trailing apostrophes of a part are its derivative order
+    - Subexpressions shared by the parts are computed once per sample
+    - Every variable the program reads needs a value, except y of a
+      grid plot; an expression in y without a value for y becomes a
+      grid plot
+    - A sweep moves everything that does not depend on the swept
+      variable into the invariant program, see compile_sweep()
+    - The programs are translated to native code where possible, the
+      bytecode interpreter remains the fallback
+   ____________________________________________________________________________
+*/
+int compile_plot(PlotJob *job) {
+    char functions[MAX_EXPR_LEN];
+    const char *parts[MAX_PROGRAM_OUTPUTS];
+    int orders[MAX_PROGRAM_OUTPUTS];
+    char *cursor = functions;
+    int count = 0;
+    ParserError error;
+
+    memset(&job->program, 0, sizeof(job->program));
+    memset(&job->invariant, 0, sizeof(job->invariant));
+    strcpy(functions, job->function);
+
+    for (;;) {
+        char *separator = strchr(cursor, ';');
+
+        if (count == MAX_PROGRAM_OUTPUTS) {
+            plot_message(job, "Error: Too many functions (at most %d).\n",
+                         MAX_PROGRAM_OUTPUTS);
+            return 2;
+        }
+        if (separator) {
+            *separator = '\0';
+        }
+
+        /* f' and f'' plot derivatives */
+        orders[count] = 0;
+        {
+            size_t length = strlen(cursor);
+            while (length > 0 && cursor[length - 1] == '\'') {
+                cursor[--length] = '\0';
+                orders[count]++;
+            }
+        }
+        if (orders[count] > PLOT_MAX_ORDER) {
+            plot_message(job, "Error: Derivative order too high (at most %d).\n",
+                         PLOT_MAX_ORDER);
+            return 2;
+        }
+
+        /* Validate the provided mathematical expression */
+        if (validate_expression(cursor) == 0) {
+            plot_message(job, "Error: Invalid mathematical expression.\n");
+            return 2;
+        }
+        parts[count++] = cursor;
+
+        if (!separator) {
+            break;
+        }
+        cursor = separator + 1;
+    }
+
+    if (job->sweep.num_frames > 0) {
+        error = compile_sweep(parts, orders, count, 1u << job->sweep.slot,
+                              &job->invariant, &job->program);
+    } else {
+        error = compile_derivatives(parts, orders, count, &job->program);
+    }
+    if (error != PARSER_OK) {
+        plot_message(job, "Error: %s.\n", parser_error_message(error));
+        return error == PARSER_ERROR_MEMORY ? 5 : 2;
+    }
+
+    /* Variables other than x need values, y may be swept by a grid */
+    {
+        unsigned missing = (job->program.variable_mask |
+                            job->invariant.variable_mask) &
+                           ~job->variables_set & ~(1u << VAR_X);
+        int slot;
+
+        if (job->sweep.num_frames > 0) {
+            missing &= ~(1u << job->sweep.slot);
+        }
+
+        if ((missing & (1u << VAR_Y)) && job->grid_size == 0) {
+            job->grid_size = PLOT_DEFAULT_GRID;
+        }
+        if (job->grid_size > 0) {
+            missing &= ~(1u << VAR_Y);
+        }
+        for (slot = 0; slot < MAX_VARIABLES; slot++) {
+            if (missing & (1u << slot)) {
+                plot_message(job, "Error: Variable '%s' has no value.\n",
+                             variable_name(slot));
+                free_plot(job);
+                return 2;
+            }
+        }
+    }
+    if (job->grid_size > 0 && (count > 1 || job->num_points > 0)) {
+        plot_message(job, "Error: A grid plot takes a single function and no --points.\n");
+        free_plot(job);
+        return 2;
+    }
+    if (job->grid_size > 0 && job->sweep.num_frames > 0) {
+        plot_message(job, "Error: A grid plot cannot be swept.\n");
+        free_plot(job);
+        return 2;
+    }
+    memcpy(job->program.variables, job->variables, sizeof(job->variables));
+    memcpy(job->invariant.variables, job->variables, sizeof(job->variables));
+
+    jit_compile(&job->program);
+    if (job->invariant.code) {
+        jit_compile(&job->invariant);
+    }
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    int render_plot(PlotJob *job, int num_threads)
+
+    Copies the graph from the cache or renders and stores it.
+
+    Caching Strategy:
+    - The canonical key holds the compiled programs instead of the
+      expressions, so "x*1" finds the graph of "x"
+    - A hit or a stored graph also gets a link record under the text
+      key, so the next request in the same form, also by a later
+      process using the same directory, skips compilation
+    - Jobs calling registered functions are always rendered
+   ____________________________________________________________________________
+*/
+int render_plot(PlotJob *job, int num_threads) {
+    CacheKey key;
+    CacheBlob *blob;
+    int result;
+
+    if (!job->cache) {
+        return render_job(job, num_threads);
+    }
+
+    cache_key_init(&key);
+    cache_key_string(&key, PLOT_CACHE_VERSION);
+    if (!cache_key_program(&key, &job->program) ||
+        (job->invariant.code && !cache_key_program(&key, &job->invariant))) {
+        cache_key_free(&key);
+        return render_job(job, num_threads);
+    }
+    key_settings(job, &key);
+
+    blob = cache_get(job->cache, &key);
+    if (blob) {
+        result = write_stored(job, blob);
+        cache_release(job->cache, blob);
+        if (result == 0) {
+            store_link(job, &key);
+        }
+    } else {
+        result = render_job(job, num_threads);
+        if (result == 0 && store_output(job, &key)) {
+            store_link(job, &key);
+        }
+    }
+
+    cache_key_free(&key);
+    return result;
+}
+
+/* ____________________________________________________________________________
+    static int write_stored(PlotJob *job, const CacheBlob *blob)
+
+    Writes a stored graph to the output file and repeats its warning.
+   ____________________________________________________________________________
+*/
+static int write_stored(PlotJob *job, const CacheBlob *blob) {
+    FILE *file;
+    int ok;
+
+    if (blob->flags & PLOT_CACHE_UNDEFINED) {
+        report_undefined(job);
+    }
+
+    file = fopen(job->output_file, "wb");
+    if (!file) {
+        plot_message(job, "Error: Failed to generate PostScript graph. Code: %d\n",
+                     ERROR_FILE_OPERATION);
+        return 6;
+    }
+    ok = fwrite(blob->bytes, 1, blob->length, file) == blob->length;
+    if (fclose(file) != 0 || !ok) {
+        plot_message(job, "Error: Failed to generate PostScript graph. Code: %d\n",
+                     ERROR_FILE_OPERATION);
+        return 6;
+    }
+
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    static int store_output(PlotJob *job, const CacheKey *key)
+
+    Reads the written output file back and stores it under the canonical
+    key. Files the cache would not keep are not read.
+
+    Returns:
+    int - 1 if the graph was stored, 0 otherwise
+   ____________________________________________________________________________
+*/
+static int store_output(PlotJob *job, const CacheKey *key) {
+    FILE *file = fopen(job->output_file, "rb");
+    CacheBlob *blob;
+    char *bytes;
+    long length;
+
+    if (!file) {
+        return 0;
+    }
+    if (fseek(file, 0, SEEK_END) != 0 || (length = ftell(file)) < 0 ||
+        !cache_fits(job->cache, (size_t)length) ||
+        fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return 0;
+    }
+
+    bytes = malloc(length > 0 ? (size_t)length : 1);
+    if (!bytes || fread(bytes, 1, (size_t)length, file) != (size_t)length) {
+        free(bytes);
+        fclose(file);
+        return 0;
+    }
+    fclose(file);
+
+    blob = cache_put(job->cache, key, bytes, (size_t)length,
+                     job->undefined ? PLOT_CACHE_UNDEFINED : 0);
+    cache_release(job->cache, blob);
+    free(bytes);
+    return blob != NULL;
+}
+
+/* ____________________________________________________________________________
+    static void store_link(PlotJob *job, const CacheKey *key)
+
+    Stores the canonical key of a stored graph under the text key of the
+    job, in memory and on disk.
+   ____________________________________________________________________________
+*/
+static void store_link(PlotJob *job, const CacheKey *key) {
+    if (job->text_key.length > 0) {
+        cache_release(job->cache,
+                      cache_put(job->cache, &job->text_key, (const char *)key->bytes,
+                                key->length, PLOT_CACHE_LINK));
+    }
+}
+
+/* ____________________________________________________________________________
+    static void report_undefined(PlotJob *job)
+
+    Warns about undefined values and remembers the warning for the cache.
+   ____________________________________________________________________________
+*/
+static void report_undefined(PlotJob *job) {
+    job->undefined = 1;
+    plot_message(job, "Warning: The function contains undefined values in the given range.\n");
+}
+
+/* ____________________________________________________________________________
+    static int render_job(PlotJob *job, int num_threads)
+
+    Hands the job to the renderer of its kind.
+   ____________________________________________________________________________
+*/
+static int render_job(PlotJob *job, int num_threads) {
+    if (job->grid_size > 0) {
+        return render_grid(job, num_threads);
+    }
+    if (job->sweep.num_frames > 0) {
+        return render_sweep(job, num_threads);
+    }
+    if (job->num_points > 0) {
+        return render_streamed(job, num_threads);
+    }
+
+    return render_adaptive(job, num_threads);
+}
+
+/* ____________________________________________________________________________
+    static int render_adaptive(PlotJob *job, int num_threads)
+
+    Samples the compiled expressions and writes the graph.
+
+    Rendering Strategy:
+    - Sample all functions at once, dense only where a curve needs it
+    - Hand the interleaved samples over to the PostScript generator as
+      one series per function
+   ____________________________________________________________________________
+*/
+static int render_adaptive(PlotJob *job, int num_threads) {
+    GraphSeries series[MAX_PROGRAM_OUTPUTS];
+    SampleWindow window;
+    SampleSet samples;
+    GraphParams params;
+    int result, k;
+
+    window.min_x = job->xmin;
+    window.max_x = job->xmax;
+    window.min_y = job->ymin;
+    window.max_y = job->ymax;
+    window.width = PLOT_SIZE;
+    window.height = PLOT_SIZE;
+
+    if (!sample_function(&job->program, &window, num_threads, &samples)) {
+        plot_message(job, "Error: Memory allocation failed.\n");
+        return 5;
+    }
+
+    if (samples.num_undefined > 0) {
+        report_undefined(job);
+    }
+
+    /* Configure graph parameters */
+    params.min_x = job->xmin;
+    params.max_x = job->xmax;
+    params.min_y = job->ymin;
+    params.max_y = job->ymax;
+    params.width = window.width;
+    params.height = window.height;
+    params.x_divisions = 10;
+    params.y_divisions = 10;
+    for (k = 0; k < samples.num_series; k++) {
+        series[k].points = samples.y + k;
+        series[k].stride = samples.num_series;
+        set_default_series_style(&series[k], k);
+    }
+    params.series = series;
+    params.num_series = samples.num_series;
+    params.x_coords = samples.x;
+    params.num_points = samples.count;
+    params.tolerance = PS_DEFAULT_TOLERANCE;
+
+    result = generate_postscript_graph(&params, job->output_file);
+    free_samples(&samples);
+
+    if (result != 0) {
+        plot_message(job, "Error: Failed to generate PostScript graph. Code: %d\n", result);
+        return 6;
+    }
+
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    static int render_streamed(PlotJob *job, int num_threads)
+
+    Samples the compiled expressions uniformly and streams the samples
+    into the graph, see stream_plot().
+   ____________________________________________________________________________
+*/
+static int render_streamed(PlotJob *job, int num_threads) {
+    GraphSeries series[MAX_PROGRAM_OUTPUTS];
+    GraphParams params;
+    int num_series = job->program.num_outputs > 0 ? job->program.num_outputs : 1;
+    int num_undefined, result, k;
+
+    memset(&params, 0, sizeof(params));
+    params.min_x = job->xmin;
+    params.max_x = job->xmax;
+    params.min_y = job->ymin;
+    params.max_y = job->ymax;
+    params.width = PLOT_SIZE;
+    params.height = PLOT_SIZE;
+    params.x_divisions = 10;
+    params.y_divisions = 10;
+    for (k = 0; k < num_series; k++) {
+        memset(&series[k], 0, sizeof(series[k]));
+        set_default_series_style(&series[k], k);
+    }
+    params.series = series;
+    params.num_series = num_series;
+    params.tolerance = PS_DEFAULT_TOLERANCE;
+
+    result = stream_plot(&job->program, &params, job->output_file,
+                         job->num_points, num_threads, &num_undefined);
+
+    if (num_undefined > 0) {
+        report_undefined(job);
+    }
+    if (result == ERROR_MEMORY_ALLOCATION) {
+        plot_message(job, "Error: Memory allocation failed.\n");
+        return 5;
+    }
+    if (result != 0) {
+        plot_message(job, "Error: Failed to generate PostScript graph. Code: %d\n", result);
+        return 6;
+    }
+
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    static int render_grid(PlotJob *job, int num_threads)
+
+    Evaluates the expression over a square grid of the plotting window
+    and draws it, see generate_postscript_grid().
+
+    Rendering Strategy:
+    - Evaluate the whole grid with the tiled parallel evaluator
+    - Span the color scale and the contour levels over the defined values
+    - Draw a heatmap unless only contours were asked for
+   ____________________________________________________________________________
+*/
+static int render_grid(PlotJob *job, int num_threads) {
+    GraphParams params;
+    GridData grid;
+    int size = job->grid_size;
+    size_t count = (size_t)size * size;
+    size_t num_undefined = 0, i;
+    double *values;
+    int result;
+
+    values = malloc(count * sizeof(double));
+    if (!values ||
+        !evaluate_grid_parallel(&job->program, job->xmin, job->xmax, size,
+                                job->ymin, job->ymax, size, values, NULL,
+                                num_threads)) {
+        free(values);
+        plot_message(job, "Error: Memory allocation failed.\n");
+        return 5;
+    }
+
+    memset(&grid, 0, sizeof(grid));
+    grid.min_z = HUGE_VAL;
+    grid.max_z = -HUGE_VAL;
+    for (i = 0; i < count; i++) {
+        if (values[i] != values[i]) {
+            num_undefined++;
+        } else {
+            if (values[i] < grid.min_z) grid.min_z = values[i];
+            if (values[i] > grid.max_z) grid.max_z = values[i];
+        }
+    }
+    if (num_undefined == count) {
+        grid.min_z = grid.max_z = 0;
+    }
+    if (num_undefined > 0) {
+        report_undefined(job);
+    }
+
+    grid.values = values;
+    grid.columns = size;
+    grid.rows = size;
+    grid.heatmap = job->num_contours == 0 || job->heatmap;
+    grid.num_contours = job->num_contours;
+
+    memset(&params, 0, sizeof(params));
+    params.min_x = job->xmin;
+    params.max_x = job->xmax;
+    params.min_y = job->ymin;
+    params.max_y = job->ymax;
+    params.width = PLOT_SIZE;
+    params.height = PLOT_SIZE;
+    params.x_divisions = 10;
+    params.y_divisions = 10;
+
+    result = generate_postscript_grid(&params, &grid, job->output_file);
+    free(values);
+
+    if (result != 0) {
+        plot_message(job, "Error: Failed to generate PostScript graph. Code: %d\n", result);
+        return 6;
+    }
+
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    static int render_sweep(PlotJob *job, int num_threads)
+
+    Samples every frame of a sweep uniformly and writes one page per
+    frame, see sweep_plot().
+   ____________________________________________________________________________
+*/
+static int render_sweep(PlotJob *job, int num_threads) {
+    GraphSeries series[MAX_PROGRAM_OUTPUTS];
+    GraphParams params;
+    int num_series = job->program.num_outputs > 0 ? job->program.num_outputs : 1;
+    int num_points = job->num_points > 0 ? job->num_points : PLOT_SWEEP_POINTS;
+    int num_undefined, result, k;
+
+    memset(&params, 0, sizeof(params));
+    params.min_x = job->xmin;
+    params.max_x = job->xmax;
+    params.min_y = job->ymin;
+    params.max_y = job->ymax;
+    params.width = PLOT_SIZE;
+    params.height = PLOT_SIZE;
+    params.x_divisions = 10;
+    params.y_divisions = 10;
+    for (k = 0; k < num_series; k++) {
+        memset(&series[k], 0, sizeof(series[k]));
+        set_default_series_style(&series[k], k);
+    }
+    params.series = series;
+    params.num_series = num_series;
+    params.tolerance = PS_DEFAULT_TOLERANCE;
+
+    result = sweep_plot(&job->invariant, &job->program, &job->sweep, &params,
+                        job->output_file, num_points, num_threads,
+                        &num_undefined);
+
+    if (num_undefined > 0) {
+        report_undefined(job);
+    }
+    if (result == ERROR_MEMORY_ALLOCATION) {
+        plot_message(job, "Error: Memory allocation failed.\n");
+        return 5;
+    }
+    if (result != 0) {
+        plot_message(job, "Error: Failed to generate PostScript graph. Code: %d\n", result);
+        return 6;
+    }
+
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    void free_plot(PlotJob *job)
+
+    Releases the compiled programs and the text key of a job.
+   ____________________________________________________________________________
+*/
+void free_plot(PlotJob *job) {
+    if (job) {
+        free_program(&job->program);
+        free_program(&job->invariant);
+        cache_key_free(&job->text_key);
+    }
+}
+
+/* ____________________________________________________________________________
+    void plot_message(const PlotJob *job, const char *format, ...)
+
+    Formats a diagnostic message into a local buffer and writes it with
+    one fputs() call.
+
+    Implementation Notes:
+    - Messages are short, their only long parts are the output path and
+      the expression, both bounded by their buffer sizes
+   ____________________________________________________________________________
+*/
+void plot_message(const PlotJob *job, const char *format, ...) {
+    char message[2 * PLOT_MAX_PATH + MAX_EXPR_LEN];
+    size_t length = 0;
+    va_list args;
+
+    if (job && job->line > 0) {
+        length = (size_t)sprintf(message, "line %d: ", job->line);
+    }
+
+    va_start(args, format);
+    vsprintf(message + length, format, args);
+    va_end(args);
+
+    fputs(message, stderr);
+}
@@ -0,0 +1,256 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header plot.h
+
+    Plotting pipeline shared by the single plot and batch modes.
+    A plot job carries one expression from its command line or manifest
+    form through compilation and sampling to the PostScript file.
+    Several expressions separated by ';' are drawn into one graph, an
+    expression followed by apostrophes (f', f'') is differentiated.
+    An expression in x and y is drawn as a heatmap or contour lines
+    over a grid of samples.
+
+    Key Features:
+    - Input cleaning and validation of expressions and ranges
+    - Compilation of the expression into a program
+    - Adaptive sampling and PostScript generation
+    - Streamed dense uniform sampling for very high resolution output
+    - Parallel grid evaluation for functions of x and y
+    - Diagnostics tagged with the manifest line in batch mode
+    - Optional cache of written files, see cache.h
+
+    Exit Codes:
+    - 1 invalid arguments, 2 invalid expression, 3 output file error,
+      5 memory allocation failure, 6 graph generation failure
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef PLOT_H
+#define PLOT_H
+
+#include "parser.h"  /* Expression compilation */
+#include "sweep.h"   /* Parameter sweeps */
+#include "cache.h"   /* Cache of written graphs */
+
+/* Maximum length of an output file path */
+#define PLOT_MAX_PATH 1024
+
+/* Default plotting range */
+#define PLOT_DEFAULT_MIN -10
+#define PLOT_DEFAULT_MAX 10
+
+/* Highest derivative order of a plotted expression */
+#define PLOT_MAX_ORDER 4
+
+/* Size of the plotted area in points */
+#define PLOT_SIZE 512
+
+/* Largest number of uniform samples of a streamed plot */
+#define PLOT_MAX_POINTS 1000000000
+
+/* Samples per axis of grid plots, by default and at most */
+#define PLOT_DEFAULT_GRID 256
+#define PLOT_MAX_GRID 2048
+
+/* Uniform samples per frame of a sweep without --points */
+#define PLOT_SWEEP_POINTS 1024
+
+/* Largest number of frames of a sweep */
+#define PLOT_MAX_FRAMES 10000
+
+/*
+  Plot job
+  One expression to be plotted into one file.
+
+  Members:
+  function    - Expressions without whitespace, separated by ';',
+                each optionally followed by apostrophes
+  output_file - Path of the PostScript file
+  xmin, xmax  - Plotted range of x
+  ymin, ymax  - Plotted range of y
+  line        - Manifest line number for diagnostics, 0 outside batch mode
+  num_points  - Number of uniform samples streamed to the file, 0 for
+                adaptive sampling
+  grid_size   - Samples per axis of a grid plot, 0 for curves; set by
+                compile_plot() when the expression uses y without a value
+  num_contours - Contour levels of a grid plot, 0 for none
+  heatmap     - Nonzero to draw the heatmap of a grid plot together with
+                its contours, a grid plot without contours always has one
+  variables   - Values of the variables marked in variables_set
+  variables_set - Bit k is set if variable slot k has a value
+  sweep       - Swept variable, sweep.num_frames is 0 without a sweep
+  program     - Compiled expressions, valid after compile_plot(); the
+                frame program of compile_sweep() for sweeps
+  invariant   - Invariant program of a sweep, empty otherwise
+  cache       - Cache of written graphs, NULL for none; may be shared
+                by the jobs of several threads
+  text_key    - Key of the job as written, set by restore_plot()
+  undefined   - Nonzero once undefined values were reported
+*/
+typedef struct {
+    char function[MAX_EXPR_LEN];        /* Cleaned expression */
+    char output_file[PLOT_MAX_PATH];    /* Output path */
+    double xmin, xmax, ymin, ymax;      /* Plotting window */
+    int line;                           /* Manifest line, 0 if none */
+    int num_points;                     /* Streamed samples, 0 if adaptive */
+    int grid_size;                      /* Grid samples per axis, 0 if none */
+    int num_contours;                   /* Contour levels */
+    int heatmap;                        /* Heatmap under the contours */
+    double variables[MAX_VARIABLES];    /* Values of parameters */
+    unsigned variables_set;             /* Parameters with a value */
+    SweepRange sweep;                   /* Swept parameter */
+    Program program;                    /* Compiled expression */
+    Program invariant;                  /* Part not depending on sweep */
+    PlotCache *cache;                   /* Graph cache, NULL if none */
+    CacheKey text_key;                  /* Key of the uncompiled job */
+    int undefined;                      /* Undefined values reported */
+} PlotJob;
+
+/*
+  Copies an expression without whitespace and checks its characters
+
+  Parameters:
+  job   - Job receiving the expression
+  input - Expression as written by the user
+
+  Returns:
+  int - 0 on success, 1 if the expression is too long or contains
+        an invalid character
+*/
+int set_plot_function(PlotJob *job, const char *input);
+
+/*
+  Sets the output file of a job
+
+  Returns:
+  int - 0 on success, 1 if the path is too long
+*/
+int set_plot_output(PlotJob *job, const char *path);
+
+/*
+  Parses a range in the form xmin:xmax:ymin:ymax
+
+  Returns:
+  int - 0 on success, 1 on malformed or empty ranges
+*/
+int set_plot_range(PlotJob *job, const char *text);
+
+/*
+  Gives a variable a value, e.g. from "a=2"
+
+  Parameters:
+  job        - Job receiving the value
+  assignment - Variable name, '=' and the value; unknown names are
+               registered with register_variable()
+
+  Returns:
+  int - 0 on success, 1 on malformed assignments, invalid names, x or
+        too many variables
+*/
+int set_plot_variable(PlotJob *job, const char *assignment);
+
+/*
+  Sweeps a variable, e.g. from "a=0:6.28:60"
+
+  Parameters:
+  job   - Job receiving the sweep
+  range - Variable name, '=', the first and the last value and the
+          number of frames, separated by ':'; unknown names are
+          registered with register_variable()
+
+  Returns:
+  int - 0 on success, 1 on malformed ranges, invalid names, x, y or
+        frame counts outside 1 to PLOT_MAX_FRAMES
+*/
+int set_plot_sweep(PlotJob *job, const char *range);
+
+/*
+  Writes the output file of a job from the cache, before compilation
+
+  Parameters:
+  job - Job with all settings, its cache may be NULL
+
+  Returns:
+  int - -1 if the job has no cache or its graph is not stored, the job
+        must then be compiled and rendered
+        0 if the output file was written, 6 if it could not be written
+
+  Notes:
+  - The key is the expression as written together with the settings,
+    so only repeated requests in the same form are found here;
+    render_plot() also finds equivalent expressions
+  - The text key holds a link record written by render_plot(), the
+    canonical form of the compiled programs; the graph is then looked
+    up under it, so both must still be stored
+  - The warning about undefined values is repeated for stored graphs
+    that had them
+*/
+int restore_plot(PlotJob *job);
+
+/*
+  Validates and compiles the expressions of a job
+
+  Returns:
+  int - 0 on success, 2 for invalid expressions, more than
+        MAX_PROGRAM_OUTPUTS of them, derivatives that cannot be built,
+        variables without a value, grid plots of several functions or
+        sweeps of grid plots, 5 on memory failure
+
+  Notes:
+  - Expressions using y without a value for it become grid plots with
+    PLOT_DEFAULT_GRID samples per axis unless grid_size is set
+  - Sweeps are compiled with compile_sweep(), the swept variable is
+    the only varying one
+*/
+int compile_plot(PlotJob *job);
+
+/*
+  Samples a compiled job and writes its PostScript file
+
+  Parameters:
+  job         - Job prepared by compile_plot()
+  num_threads - Maximum number of threads evaluating the samples
+
+  Returns:
+  int - 0 on success, 5 on memory failure, 6 if the graph could not
+        be written
+
+  Notes:
+  - Reports undefined values in the plotted range as a warning
+  - Jobs with num_points set are sampled uniformly through the
+    streaming pipeline (see stream.h) instead of adaptively
+  - Jobs with grid_size set are evaluated over a grid of x and y and
+    drawn as a heatmap and/or contours, the color scale spans the range
+    of the defined values
+  - Sweeps write one page per frame, each sampled uniformly in
+    num_points or PLOT_SWEEP_POINTS samples, see sweep_plot()
+  - Every expression is drawn with its own style, see
+    set_default_series_style()
+  - With a cache the graph is looked up under the canonical form of
+    the compiled programs (see cache_key_program()) before sampling;
+    a written or found graph is stored under that key and a link to
+    it under the key of restore_plot()
+*/
+int render_plot(PlotJob *job, int num_threads);
+
+/*
+  Releases the compiled programs and the cache key of a job
+  The cache itself belongs to the caller.
+*/
+void free_plot(PlotJob *job);
+
+/*
+  Writes a diagnostic message of a job to stderr
+  In batch mode the message is prefixed with the manifest line. The
+  message is written with a single call, so messages of concurrently
+  processed jobs do not interleave.
+*/
+void plot_message(const PlotJob *job, const char *format, ...);
+
+#endif /* PLOT_H */
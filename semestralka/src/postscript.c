@@ -18,10 +18,29 @@
     - Grid line generation
     - Function curve plotting
     - Complete memory management
+    - Buffered output with a fixed precision number formatter
+    - Heatmaps as one color image, contours by marching squares
 ____________________________________________________________________________ */
 
 #include "postscript.h"
 
+static int validate_graph_axes(const GraphParams* params);
+static int validate_graph_layout(const GraphParams* params);
+static void draw_main_axes(PsWriter* out);
+static void label_axes_titled(PsWriter* out, const GraphParams* params,
+                              const char* y_title);
+static void write_document_start(PsWriter* out, const GraphParams* params);
+static int write_document_end(PsWriter* out);
+static void scale_color(double t, double rgb[3]);
+static double grid_position(const GridData* grid, double value);
+static void draw_heatmap(PsWriter* out, const GraphParams* params,
+                         const GridData* grid);
+static void draw_contours(PsWriter* out, const GraphParams* params,
+                          const GridData* grid);
+static void contour_cell(PsWriter* out, const GraphParams* params,
+                         const GridData* grid, int i, int j, double level,
+                         int* started);
+
 /* Error codes for internal use */
 #define ERROR_INVALID_PARAMS     -1  /* Invalid parameter values provided */
 #define ERROR_FILE_OPERATION     -2  /* File access or write operation failed */
@@ -68,6 +87,30 @@ void generate_axis_label(char* buffer, size_t buffer_size, double value) {
     }
 }
 
+/* ____________________________________________________________________________
+    Function: set_default_series_style
+    
+    Implementation Notes:
+    - Colors are chosen to stay distinguishable on the gray grid
+    - Every further round of the palette gets longer dashes
+____________________________________________________________________________ */
+void set_default_series_style(GraphSeries* series, int index) {
+    static const double palette[PS_PALETTE_SIZE][3] = {
+        { 0, 0, 1 },       /* Blue */
+        { 0.8, 0, 0 },     /* Red */
+        { 0, 0.6, 0 },     /* Green */
+        { 0.7, 0, 0.7 },   /* Magenta */
+        { 1, 0.5, 0 },     /* Orange */
+        { 0, 0.6, 0.6 }    /* Teal */
+    };
+    int color = index % PS_PALETTE_SIZE;
+
+    series->red = palette[color][0];
+    series->green = palette[color][1];
+    series->blue = palette[color][2];
+    series->dash = 3.0 * (index / PS_PALETTE_SIZE);
+}
+
 /* ____________________________________________________________________________
     Function: validate_graph_params
     
@@ -78,6 +121,30 @@ void generate_axis_label(char* buffer, size_t buffer_size, double value) {
     - Ensures data array validity
 ____________________________________________________________________________ */
 int validate_graph_params(const GraphParams* params) {
+    if (!validate_graph_layout(params) ||
+        params->num_points <= 0) {           /* Must have at least one point */
+        return 0;
+    }
+    
+    int i;
+    for (i = 0; i < params->num_series; i++) {
+        if (!params->series[i].points ||         /* Data array must exist */
+            params->series[i].stride <= 0) {     /* Values must advance */
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    Function: validate_graph_axes
+    
+    Implementation Notes:
+    - Checks the ranges, dimensions and divisions shared by curve and
+      grid graphs
+____________________________________________________________________________ */
+static int validate_graph_axes(const GraphParams* params) {
     if (!params) return 0;
     
     /* Check for invalid ranges and dimensions that would cause rendering issues */
@@ -86,15 +153,39 @@ int validate_graph_params(const GraphParams* params) {
         params->width <= 0 ||                /* Width must be positive */
         params->height <= 0 ||               /* Height must be positive */
         params->x_divisions <= 0 ||          /* Must have at least one division */
-        params->y_divisions <= 0 ||          /* Must have at least one division */
-        !params->points ||                   /* Data array must exist */
-        params->num_points <= 0) {           /* Must have at least one point */
+        params->y_divisions <= 0) {          /* Must have at least one division */
         return 0;
     }
     
     return 1;
 }
 
+/* ____________________________________________________________________________
+    Function: validate_graph_layout
+    
+    Implementation Notes:
+    - Checks everything but the data arrays, streamed graphs receive
+      their points only after the file has been started
+____________________________________________________________________________ */
+static int validate_graph_layout(const GraphParams* params) {
+    if (!validate_graph_axes(params)) return 0;
+    
+    if (!(params->tolerance >= 0) ||         /* Tolerance must not be negative */
+        !params->series ||                   /* Series array must exist */
+        params->num_series <= 0) {           /* Must have at least one series */
+        return 0;
+    }
+    
+    int i;
+    for (i = 0; i < params->num_series; i++) {
+        if (!(params->series[i].dash >= 0)) {    /* Dash must not be negative */
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
 /* ____________________________________________________________________________
     Function: write_ps_header
     
@@ -104,14 +195,16 @@ int validate_graph_params(const GraphParams* params) {
     - Calculates proper bounding box with margins
     - Ensures proper document structure
 ____________________________________________________________________________ */
-void write_ps_header(FILE* ps_file, const GraphParams* params) {
-    fprintf(ps_file, "%%!PS-Adobe-3.0\n");
-    fprintf(ps_file, "%%Creator: Jiri Joska\n");
-    fprintf(ps_file, "%%Title: Graph of f(x)\n");
-    fprintf(ps_file, "%%BoundingBox: 0 0 %d %d\n", 
-            params->width + 100,  /* Add margins */
-            params->height + 100);
-    fprintf(ps_file, "%%EndComments\n\n");
+void write_ps_header(PsWriter* out, const GraphParams* params) {
+    ps_write_string(out, "%!PS-Adobe-3.0\n");
+    ps_write_string(out, "%Creator: Jiri Joska\n");
+    ps_write_string(out, "%Title: Graph of f(x)\n");
+    ps_write_string(out, "%BoundingBox: 0 0 ");
+    ps_write_int(out, params->width + 100);   /* Add margins */
+    ps_write_string(out, " ");
+    ps_write_int(out, params->height + 100);
+    ps_write_string(out, "\n");
+    ps_write_string(out, "%EndComments\n\n");
 }
 
 /* ____________________________________________________________________________
@@ -123,20 +216,236 @@ void write_ps_header(FILE* ps_file, const GraphParams* params) {
     - Handles potential division by zero
     - Sets up margin handling
 ____________________________________________________________________________ */
-void setup_coordinate_system(FILE* ps_file, const GraphParams* params) {
-    fprintf(ps_file, "/margin 50 def\n");
-    fprintf(ps_file, "/graphWidth %d def\n", params->width);
-    fprintf(ps_file, "/graphHeight %d def\n", params->height);
+void setup_coordinate_system(PsWriter* out, const GraphParams* params) {
+    ps_write_string(out, "/margin 50 def\n");
+    ps_write_string(out, "/graphWidth ");
+    ps_write_int(out, params->width);
+    ps_write_string(out, " def\n/graphHeight ");
+    ps_write_int(out, params->height);
+    ps_write_string(out, " def\n");
     
     /* Calculate the range of data values for both x and y axes */
     double x_range = params->max_x - params->min_x;
     double y_range = params->max_y - params->min_y;
     
     /* Calculate the scaling factor for the x-axis */
-    fprintf(ps_file, "/xScale %g def\n", 
+    ps_write_string(out, "/xScale ");
+    ps_write_general(out,
             (fabs(x_range) > DBL_EPSILON) ? params->width / x_range : 1.0);
-    fprintf(ps_file, "/yScale %g def\n", 
+    ps_write_string(out, " def\n/yScale ");
+    ps_write_general(out,
             (fabs(y_range) > DBL_EPSILON) ? params->height / y_range : 1.0);
+    ps_write_string(out, " def\n");
+}
+
+/* Constant pi, not provided by ANSI C math.h */
+#define PS_PI 3.14159265358979323846
+
+/* 
+    Path Simplifier Structure
+    
+    Streaming collinearity merge of one path segment. Points are accepted
+    while a single line from the anchor (the last written vertex) passes
+    within the tolerance of all of them. The set of such line directions
+    is an angular interval that shrinks with every accepted point.
+*/
+typedef struct {
+    PsWriter *out;               /* Output of the path */
+    double tolerance;            /* Allowed distance, 0 keeps all points */
+    int active;                  /* Nonzero inside a path segment */
+    double anchor_x, anchor_y;   /* Last written vertex */
+    int has_pending;             /* Nonzero if a point is not written yet */
+    double pending_x, pending_y; /* Last accepted point */
+    int constrained;             /* Nonzero once the interval is set */
+    double center;               /* Direction of the first constraint */
+    double min_angle, max_angle; /* Interval of allowed directions */
+} PathSimplifier;
+
+/* ____________________________________________________________________________
+    Function: path_write_vertex
+    
+    Implementation Notes:
+    - Writes a vertex of the current path and makes it the new anchor
+____________________________________________________________________________ */
+static void path_write_vertex(PathSimplifier* path, double x, double y,
+                              const char* operator_name) {
+    ps_write_number(path->out, x);
+    ps_write_string(path->out, " ");
+    ps_write_number(path->out, y);
+    ps_write_string(path->out, operator_name);
+
+    path->anchor_x = x;
+    path->anchor_y = y;
+    path->has_pending = 0;
+    path->constrained = 0;
+}
+
+/* ____________________________________________________________________________
+    Function: path_add_point
+    
+    Implementation Notes:
+    - The first point of a segment is written with moveto
+    - A point within the tolerance of the anchor adds no constraint
+    - A point whose direction falls into the allowed interval narrows
+      the interval by the angle the tolerance spans at its distance
+    - Any other point ends the merged run: the pending point is written
+      with lineto and the new point is processed again from there
+____________________________________________________________________________ */
+static void path_add_point(PathSimplifier* path, double x, double y) {
+    if (!path->active) {
+        path_write_vertex(path, x, y, " moveto\n");
+        path->active = 1;
+        return;
+    }
+
+    if (path->tolerance <= 0) {
+        path_write_vertex(path, x, y, " lineto\n");
+        return;
+    }
+
+    double dx = x - path->anchor_x;
+    double dy = y - path->anchor_y;
+    double distance = sqrt(dx * dx + dy * dy);
+
+    if (distance > path->tolerance) {
+        double angle = atan2(dy, dx);
+        double spread = asin(path->tolerance / distance);
+
+        if (!path->constrained) {
+            path->center = angle;
+            path->min_angle = angle - spread;
+            path->max_angle = angle + spread;
+            path->constrained = 1;
+        } else {
+            /* Compare directions on the same side of the branch cut */
+            if (angle < path->center - PS_PI) {
+                angle += 2 * PS_PI;
+            } else if (angle > path->center + PS_PI) {
+                angle -= 2 * PS_PI;
+            }
+
+            if (angle < path->min_angle || angle > path->max_angle) {
+                /* Direction changed, close the run at the pending point */
+                path_write_vertex(path, path->pending_x, path->pending_y,
+                                  " lineto\n");
+                path_add_point(path, x, y);
+                return;
+            }
+
+            if (angle - spread > path->min_angle) {
+                path->min_angle = angle - spread;
+            }
+            if (angle + spread < path->max_angle) {
+                path->max_angle = angle + spread;
+            }
+        }
+    }
+
+    path->pending_x = x;
+    path->pending_y = y;
+    path->has_pending = 1;
+}
+
+/* ____________________________________________________________________________
+    Function: path_end_segment
+    
+    Implementation Notes:
+    - Writes the pending point, so every segment ends at its last sample
+____________________________________________________________________________ */
+static void path_end_segment(PathSimplifier* path) {
+    if (path->has_pending) {
+        path_write_vertex(path, path->pending_x, path->pending_y, " lineto\n");
+    }
+    path->active = 0;
+}
+
+/* ____________________________________________________________________________
+    Function: begin_series, end_series
+    
+    Implementation Notes:
+    - Set the pen of the series and start its path, dashed series
+      restore a solid pen after stroking
+____________________________________________________________________________ */
+static void begin_series(PsWriter* out, const GraphSeries* series) {
+    ps_write_number(out, series->red);
+    ps_write_string(out, " ");
+    ps_write_number(out, series->green);
+    ps_write_string(out, " ");
+    ps_write_number(out, series->blue);
+    ps_write_string(out, " setrgbcolor\n");
+    ps_write_string(out, "1 setlinewidth\n");
+    if (series->dash > 0) {
+        ps_write_string(out, "[");
+        ps_write_number(out, series->dash);
+        ps_write_string(out, " ");
+        ps_write_number(out, series->dash);
+        ps_write_string(out, "] 0 setdash\n");
+    }
+    ps_write_string(out, "newpath\n");
+}
+
+static void end_series(PsWriter* out, const GraphSeries* series) {
+    ps_write_string(out, "stroke\n");
+    if (series->dash > 0) {
+        ps_write_string(out, "[] 0 setdash\n");
+    }
+}
+
+/* ____________________________________________________________________________
+    Function: path_add_sample
+    
+    Implementation Notes:
+    - Breaks the path at undefined values and values out of range
+    - Converts the sample from data to graph coordinates
+____________________________________________________________________________ */
+static void path_add_sample(PathSimplifier* path, const GraphParams* params,
+                            double x, double y) {
+    /* Only plot points within the valid y-range to avoid artifacts */
+    if (y >= params->min_y && y <= params->max_y) {
+        /* Convert from data coordinates to graph coordinates */
+        double graph_x = ((x - params->min_x) / 
+                       (params->max_x - params->min_x)) * params->width;
+        double graph_y = ((y - params->min_y) / 
+                       (params->max_y - params->min_y)) * params->height;
+
+        /* Starts a new path segment after a discontinuity */
+        path_add_point(path, graph_x, graph_y);
+    } else {
+        /* Point out of range - finish the current segment */
+        path_end_segment(path);
+    }
+}
+
+/* ____________________________________________________________________________
+    Function: draw_series
+    
+    Implementation Notes:
+    - Draws all points of one series as a single stroked path
+____________________________________________________________________________ */
+static void draw_series(PsWriter* out, const GraphParams* params,
+                        const GraphSeries* series) {
+    begin_series(out, series);
+
+    PathSimplifier path;
+    path.out = out;
+    path.tolerance = params->tolerance;
+    path.active = 0;
+    path.has_pending = 0;
+    path.constrained = 0;
+
+    int i;
+    for (i = 0; i < params->num_points; i++) {
+        /* Use explicit x coordinate or calculate it from point index */
+        double x = params->x_coords ? params->x_coords[i] :
+                   params->min_x + (params->max_x - params->min_x) * 
+                  ((double)i / (params->num_points - 1));
+
+        path_add_sample(&path, params, x,
+                        series->points[(size_t)i * series->stride]);
+    }
+    path_end_segment(&path);
+
+    end_series(out, series);
 }
 
 /* ____________________________________________________________________________
@@ -148,51 +457,27 @@ void setup_coordinate_system(FILE* ps_file, const GraphParams* params) {
     - Performs range checking for each point
     - Uses efficient PostScript path commands
     - Maintains proper scaling and positioning
+    - Merges nearly collinear vertices within params->tolerance
 
     The function implements several important features:
     - Automatically breaks the path when points go out of range
     - Scales points to match the graph dimensions
     - Creates a continuous line for connected points
+    - Draws every series with its own pen over the shared grid
     - Handles potential gaps in the data
+    - Accepts non-uniform samples, e.g. from adaptive sampling
+    - Simplifies in graph coordinates, so the tolerance is in points
+      on the page regardless of the plotted range
 ____________________________________________________________________________ */
-void draw_function(FILE* ps_file, const GraphParams* params) {
-    fprintf(ps_file, "%% Draw Function\n");
-    fprintf(ps_file, "0 0 1 setrgbcolor\n");  /* Blue color of the pen */
-    fprintf(ps_file, "1 setlinewidth\n");
-    fprintf(ps_file, "newpath\n");
-
-    int first_valid_point = 1;  /* Track when to start a new path segment */
+void draw_function(PsWriter* out, const GraphParams* params) {
+    ps_write_string(out, "% Draw Function\n");
 
     int i;
-    for (i = 0; i < params->num_points; i++) {
-        /* Calculate x coordinate based on point index */
-        double x = params->min_x + (params->max_x - params->min_x) * 
-                  ((double)i / (params->num_points - 1));
-        double y = params->points[i];
-
-        /* Only plot points within the valid y-range to avoid artifacts */
-        if (y >= params->min_y && y <= params->max_y) {
-            /* Convert from data coordinates to graph coordinates */
-            double graph_x = ((x - params->min_x) / 
-                           (params->max_x - params->min_x)) * params->width;
-            double graph_y = ((y - params->min_y) / 
-                           (params->max_y - params->min_y)) * params->height;
-
-            /* Start new path segment for first point or after discontinuity */
-            if (first_valid_point) {
-                fprintf(ps_file, "%g %g moveto\n", graph_x, graph_y);
-                first_valid_point = 0;
-            } else {
-                /* Continue current path segment */
-                fprintf(ps_file, "%g %g lineto\n", graph_x, graph_y);
-            }
-        } else {
-            /* Point out of range - mark next valid point as start of new segment */
-            first_valid_point = 1;
-        }
+    for (i = 0; i < params->num_series; i++) {
+        draw_series(out, params, &params->series[i]);
     }
 
-    fprintf(ps_file, "stroke\n\n");
+    ps_write_string(out, "\n");
 }
 
 
@@ -206,53 +491,67 @@ void draw_function(FILE* ps_file, const GraphParams* params) {
     - Uses PostScript graphics state stack
     - Implements proper line styles and colors
 ____________________________________________________________________________ */
-void draw_grid_and_axes(FILE* ps_file, const GraphParams* params) {
+void draw_grid_and_axes(PsWriter* out, const GraphParams* params) {
     /* Draw graph background */
-    fprintf(ps_file, "%% Draw graph background\n");
-    fprintf(ps_file, "gsave\n");
-    fprintf(ps_file, "0.95 setgray\n");
-    fprintf(ps_file, "newpath\n");
-    fprintf(ps_file, "0 0 moveto\n");
-    fprintf(ps_file, "graphWidth 0 lineto\n");
-    fprintf(ps_file, "graphWidth graphHeight lineto\n");
-    fprintf(ps_file, "0 graphHeight lineto\n");
-    fprintf(ps_file, "closepath fill\n");
-    fprintf(ps_file, "grestore\n\n");
+    ps_write_string(out, "% Draw graph background\n");
+    ps_write_string(out, "gsave\n");
+    ps_write_string(out, "0.95 setgray\n");
+    ps_write_string(out, "newpath\n");
+    ps_write_string(out, "0 0 moveto\n");
+    ps_write_string(out, "graphWidth 0 lineto\n");
+    ps_write_string(out, "graphWidth graphHeight lineto\n");
+    ps_write_string(out, "0 graphHeight lineto\n");
+    ps_write_string(out, "closepath fill\n");
+    ps_write_string(out, "grestore\n\n");
 
     /* Grid lines */
-    fprintf(ps_file, "%% Draw grid lines\n");
-    fprintf(ps_file, "0.8 setgray\n");
-    fprintf(ps_file, "0.3 setlinewidth\n");
+    ps_write_string(out, "% Draw grid lines\n");
+    ps_write_string(out, "0.8 setgray\n");
+    ps_write_string(out, "0.3 setlinewidth\n");
     
     /* X-axis grid lines */
     int i;
     for (i = 0; i <= params->x_divisions; i++) {
         double x_pos = (double)i * params->width / params->x_divisions;
-        fprintf(ps_file, "newpath\n");
-        fprintf(ps_file, "%g 0 moveto\n", x_pos);
-        fprintf(ps_file, "%g graphHeight lineto\n", x_pos);
-        fprintf(ps_file, "stroke\n");
+        ps_write_string(out, "newpath\n");
+        ps_write_number(out, x_pos);
+        ps_write_string(out, " 0 moveto\n");
+        ps_write_number(out, x_pos);
+        ps_write_string(out, " graphHeight lineto\n");
+        ps_write_string(out, "stroke\n");
     }
 
     /* Y-axis grid lines */
     for (i = 0; i <= params->y_divisions; i++) {
         double y_pos = (double)i * params->height / params->y_divisions;
-        fprintf(ps_file, "newpath\n");
-        fprintf(ps_file, "0 %g moveto\n", y_pos);
-        fprintf(ps_file, "graphWidth %g lineto\n", y_pos);
-        fprintf(ps_file, "stroke\n");
+        ps_write_string(out, "newpath\n");
+        ps_write_string(out, "0 ");
+        ps_write_number(out, y_pos);
+        ps_write_string(out, " moveto\ngraphWidth ");
+        ps_write_number(out, y_pos);
+        ps_write_string(out, " lineto\n");
+        ps_write_string(out, "stroke\n");
     }
 
-    /* Main axes */
-    fprintf(ps_file, "%% Draw main axes\n");
-    fprintf(ps_file, "0 setgray\n");
-    fprintf(ps_file, "1 setlinewidth\n");
-    fprintf(ps_file, "newpath\n");
-    fprintf(ps_file, "0 0 moveto\n");
-    fprintf(ps_file, "graphWidth 0 lineto\n");
-    fprintf(ps_file, "0 0 moveto\n");
-    fprintf(ps_file, "0 graphHeight lineto\n");
-    fprintf(ps_file, "stroke\n\n");
+    draw_main_axes(out);
+}
+
+/* ____________________________________________________________________________
+    Function: draw_main_axes
+    
+    Implementation Notes:
+    - Strokes the x and y axis lines along the bottom and left edges
+____________________________________________________________________________ */
+static void draw_main_axes(PsWriter* out) {
+    ps_write_string(out, "% Draw main axes\n");
+    ps_write_string(out, "0 setgray\n");
+    ps_write_string(out, "1 setlinewidth\n");
+    ps_write_string(out, "newpath\n");
+    ps_write_string(out, "0 0 moveto\n");
+    ps_write_string(out, "graphWidth 0 lineto\n");
+    ps_write_string(out, "0 0 moveto\n");
+    ps_write_string(out, "0 graphHeight lineto\n");
+    ps_write_string(out, "stroke\n\n");
 }
 
 /* ____________________________________________________________________________
@@ -272,12 +571,24 @@ void draw_grid_and_axes(FILE* ps_file, const GraphParams* params) {
     - Y-axis title is rotated 90 degrees using PostScript's coordinate system
     - Labels maintain proper spacing even with varying text lengths
 ____________________________________________________________________________ */
-void label_axes(FILE* ps_file, const GraphParams* params) {
+void label_axes(PsWriter* out, const GraphParams* params) {
+    label_axes_titled(out, params, "f(x)");
+}
+
+/* ____________________________________________________________________________
+    Function: label_axes_titled
+    
+    Implementation Notes:
+    - The labels of label_axes() with a given y-axis title, grid graphs
+      plot y on the vertical axis instead of f(x)
+____________________________________________________________________________ */
+static void label_axes_titled(PsWriter* out, const GraphParams* params,
+                              const char* y_title) {
     char label_buffer[32] = {0};
     
-    fprintf(ps_file, "%% Draw axis labels\n");
+    ps_write_string(out, "% Draw axis labels\n");
     /* Use Helvetica for readability at small sizes */
-    fprintf(ps_file, "/Helvetica findfont 10 scalefont setfont\n");
+    ps_write_string(out, "/Helvetica findfont 10 scalefont setfont\n");
 
     /* X-axis labels: positioned below x-axis with centered alignment */
     int i;
@@ -289,10 +600,12 @@ void label_axes(FILE* ps_file, const GraphParams* params) {
         generate_axis_label(label_buffer, sizeof(label_buffer), x_value);
         
         /* Position text 15 units below axis line */
-        fprintf(ps_file, "%g -15 moveto\n", x_pos);
+        ps_write_number(out, x_pos);
+        ps_write_string(out, " -15 moveto\n");
         /* Center text by moving left half the string width */
-        fprintf(ps_file, "(%s) dup stringwidth pop 2 div neg 0 rmoveto show\n", 
-                label_buffer);
+        ps_write_string(out, "(");
+        ps_write_string(out, label_buffer);
+        ps_write_string(out, ") dup stringwidth pop 2 div neg 0 rmoveto show\n");
     }
 
     /* Y-axis labels: positioned left of y-axis with right alignment */
@@ -304,24 +617,29 @@ void label_axes(FILE* ps_file, const GraphParams* params) {
         generate_axis_label(label_buffer, sizeof(label_buffer), y_value);
         
         /* Position text 10 units left of axis line */
-        fprintf(ps_file, "-10 %g moveto\n", y_pos);
+        ps_write_string(out, "-10 ");
+        ps_write_number(out, y_pos);
+        ps_write_string(out, " moveto\n");
         /* Right-align text by moving left the full string width */
-        fprintf(ps_file, "(%s) dup stringwidth pop neg 0 rmoveto show\n", 
-                label_buffer);
+        ps_write_string(out, "(");
+        ps_write_string(out, label_buffer);
+        ps_write_string(out, ") dup stringwidth pop neg 0 rmoveto show\n");
     }
 
     /* Axis titles: centered along axes with larger bold font */
-    fprintf(ps_file, "/Helvetica-Bold findfont 12 scalefont setfont\n");
+    ps_write_string(out, "/Helvetica-Bold findfont 12 scalefont setfont\n");
     
     /* X-axis title: centered below labels */
-    fprintf(ps_file, "graphWidth 2 div -35 moveto\n");
-    fprintf(ps_file, "(x) dup stringwidth pop 2 div neg 0 rmoveto show\n");
+    ps_write_string(out, "graphWidth 2 div -35 moveto\n");
+    ps_write_string(out, "(x) dup stringwidth pop 2 div neg 0 rmoveto show\n");
     
     /* Y-axis title: centered vertically, rotated 90 degrees */
-    fprintf(ps_file, "-35 graphHeight 2 div moveto\n");
-    fprintf(ps_file, "90 rotate\n");                /* Start rotation */
-    fprintf(ps_file, "(f(x)) dup stringwidth pop 2 div neg 0 rmoveto show\n");
-    fprintf(ps_file, "-90 rotate\n");              /* Restore rotation */
+    ps_write_string(out, "-35 graphHeight 2 div moveto\n");
+    ps_write_string(out, "90 rotate\n");                /* Start rotation */
+    ps_write_string(out, "(");
+    ps_write_string(out, y_title);
+    ps_write_string(out, ") dup stringwidth pop 2 div neg 0 rmoveto show\n");
+    ps_write_string(out, "-90 rotate\n");              /* Restore rotation */
 }
 
 
@@ -333,6 +651,7 @@ void label_axes(FILE* ps_file, const GraphParams* params) {
     - Validates all input parameters
     - Manages file operations
     - Sets up proper PostScript environment
+    - Writes the whole document through one buffered writer
     - Ensures proper cleanup and file closure
 ____________________________________________________________________________ */
 int generate_postscript_graph(const GraphParams* params, const char* output_file) {
@@ -340,37 +659,726 @@ int generate_postscript_graph(const GraphParams* params, const char* output_file
         return ERROR_INVALID_PARAMS;
     }
 
-    FILE *ps_file = fopen(output_file, "w");
-    if (!ps_file) {
+    PsWriter out;
+    out.file = fopen(output_file, "w");
+    if (!out.file) {
         return ERROR_FILE_OPERATION;
     }
+    out.length = 0;
+    out.error = 0;
 
     /* Write PostScript document */
-    write_ps_header(ps_file, params);
-    setup_coordinate_system(ps_file, params);
+    write_document_start(&out, params);
+    draw_function(&out, params);
+    return write_document_end(&out);
+}
+
+/* ____________________________________________________________________________
+    Function: write_document_start
+    
+    Implementation Notes:
+    - Everything in front of the curves: header, coordinate system,
+      graphics state, grid, axes and labels
+____________________________________________________________________________ */
+static void write_document_start(PsWriter* out, const GraphParams* params) {
+    write_ps_header(out, params);
+    setup_coordinate_system(out, params);
 
     /* Begin graphics state */
-    fprintf(ps_file, "gsave\n");
-    fprintf(ps_file, "margin margin translate\n");
-    fprintf(ps_file, "/Helvetica-Bold findfont 12 scalefont setfont\n\n");
+    ps_write_string(out, "gsave\n");
+    ps_write_string(out, "margin margin translate\n");
+    ps_write_string(out, "/Helvetica-Bold findfont 12 scalefont setfont\n\n");
 
     /* Draw graph components */
-    draw_grid_and_axes(ps_file, params);
-    label_axes(ps_file, params);
-    draw_function(ps_file, params);
+    draw_grid_and_axes(out, params);
+    label_axes(out, params);
+}
 
-    /* End document */
-    fprintf(ps_file, "grestore\n");
-    fprintf(ps_file, "showpage\n");
-    fprintf(ps_file, "%%EOF\n");
+/* ____________________________________________________________________________
+    Function: write_document_end
+    
+    Implementation Notes:
+    - Ends the document, writes the rest of the buffer and closes the
+      file in any case
+____________________________________________________________________________ */
+static int write_document_end(PsWriter* out) {
+    ps_write_string(out, "grestore\n");
+    ps_write_string(out, "showpage\n");
+    ps_write_string(out, "%EOF\n");
 
-    if (fclose(ps_file) != 0) {
+    ps_flush(out);
+    if (fclose(out->file) != 0 || out->error) {
         return ERROR_FILE_OPERATION;
     }
 
     return 0;
 }
 
+/* Number of samples per line of heatmap image data */
+#define PS_HEX_SAMPLES           32
+
+/* Number of colors of the heatmap scale */
+#define PS_SCALE_STOPS           5
+
+/* ____________________________________________________________________________
+    Function: generate_postscript_grid
+    
+    Implementation Notes:
+    - Uses the document frame of curve graphs: header, coordinate system,
+      background, grid lines, axes and labels
+    - The heatmap covers the grid lines, so the axes are stroked again
+      on top of it
+    - The y-axis is titled y instead of f(x)
+____________________________________________________________________________ */
+int generate_postscript_grid(const GraphParams* params, const GridData* grid,
+                             const char* output_file) {
+    if (!validate_graph_axes(params) || !grid || !grid->values ||
+        grid->columns < 2 || grid->rows < 2 ||
+        grid->num_contours < 0 || grid->num_contours > PS_MAX_CONTOURS ||
+        !(grid->max_z >= grid->min_z) || !output_file) {
+        return ERROR_INVALID_PARAMS;
+    }
+
+    PsWriter out;
+    out.file = fopen(output_file, "w");
+    if (!out.file) {
+        return ERROR_FILE_OPERATION;
+    }
+    out.length = 0;
+    out.error = 0;
+
+    write_ps_header(&out, params);
+    setup_coordinate_system(&out, params);
+
+    /* Begin graphics state */
+    ps_write_string(&out, "gsave\n");
+    ps_write_string(&out, "margin margin translate\n");
+    ps_write_string(&out, "/Helvetica-Bold findfont 12 scalefont setfont\n\n");
+
+    draw_grid_and_axes(&out, params);
+    if (grid->heatmap) {
+        draw_heatmap(&out, params, grid);
+    }
+    if (grid->num_contours > 0) {
+        draw_contours(&out, params, grid);
+    }
+    if (grid->heatmap) {
+        draw_main_axes(&out);
+    }
+    label_axes_titled(&out, params, "y");
+
+    return write_document_end(&out);
+}
+
+/* ____________________________________________________________________________
+    Function: scale_color
+    
+    Implementation Notes:
+    - Maps t from [0, 1] to a color, interpolating linearly between
+      dark blue, blue, green, yellow and dark red
+____________________________________________________________________________ */
+static void scale_color(double t, double rgb[3]) {
+    static const double stops[PS_SCALE_STOPS][3] = {
+        { 0, 0, 0.5 },     /* Dark blue */
+        { 0, 0.4, 1 },     /* Blue */
+        { 0.2, 0.8, 0.4 }, /* Green */
+        { 1, 0.85, 0 },    /* Yellow */
+        { 0.65, 0, 0 }     /* Dark red */
+    };
+
+    if (!(t > 0)) t = 0;
+    if (t > 1) t = 1;
+
+    double position = t * (PS_SCALE_STOPS - 1);
+    int k = (int)position;
+    if (k > PS_SCALE_STOPS - 2) {
+        k = PS_SCALE_STOPS - 2;
+    }
+    double fraction = position - k;
+
+    int c;
+    for (c = 0; c < 3; c++) {
+        rgb[c] = stops[k][c] + (stops[k + 1][c] - stops[k][c]) * fraction;
+    }
+}
+
+/* ____________________________________________________________________________
+    Function: grid_position
+    
+    Implementation Notes:
+    - Position of a value within [min_z, max_z], 0.5 for an empty range
+____________________________________________________________________________ */
+static double grid_position(const GridData* grid, double value) {
+    double range = grid->max_z - grid->min_z;
+
+    return (range > 0) ? (value - grid->min_z) / range : 0.5;
+}
+
+/* ____________________________________________________________________________
+    Function: draw_heatmap
+    
+    Implementation Notes:
+    - Writes the samples as one 8-bit RGB image, the colorimage operator
+      reads it as hexadecimal data following the operator
+    - Image pixels are centered on the samples: the image extends half
+      a cell over every edge and is clipped to the graph area
+    - Image rows go up from the bottom, the order of the grid rows
+    - Undefined samples have the background color
+____________________________________________________________________________ */
+static void draw_heatmap(PsWriter* out, const GraphParams* params,
+                         const GridData* grid) {
+    static const char digits[] = "0123456789ABCDEF";
+    double cell_width = (double)params->width / (grid->columns - 1);
+    double cell_height = (double)params->height / (grid->rows - 1);
+    char line[PS_HEX_SAMPLES * 6 + 2];
+
+    ps_write_string(out, "% Draw heatmap\n");
+    ps_write_string(out, "gsave\n");
+    ps_write_string(out, "newpath\n");
+    ps_write_string(out, "0 0 moveto\n");
+    ps_write_string(out, "graphWidth 0 lineto\n");
+    ps_write_string(out, "graphWidth graphHeight lineto\n");
+    ps_write_string(out, "0 graphHeight lineto\n");
+    ps_write_string(out, "closepath clip\n");
+    ps_write_general(out, -cell_width / 2);
+    ps_write_string(out, " ");
+    ps_write_general(out, -cell_height / 2);
+    ps_write_string(out, " translate\n");
+    ps_write_general(out, cell_width * grid->columns);
+    ps_write_string(out, " ");
+    ps_write_general(out, cell_height * grid->rows);
+    ps_write_string(out, " scale\n");
+    ps_write_string(out, "/heatRow ");
+    ps_write_int(out, grid->columns * 3);
+    ps_write_string(out, " string def\n");
+    ps_write_int(out, grid->columns);
+    ps_write_string(out, " ");
+    ps_write_int(out, grid->rows);
+    ps_write_string(out, " 8 [");
+    ps_write_int(out, grid->columns);
+    ps_write_string(out, " 0 0 ");
+    ps_write_int(out, grid->rows);
+    ps_write_string(out, " 0 0]\n");
+    ps_write_string(out, "{ currentfile heatRow readhexstring pop } false 3 colorimage\n");
+
+    size_t count = (size_t)grid->columns * grid->rows;
+    size_t i;
+    int length = 0;
+    for (i = 0; i < count; i++) {
+        double value = grid->values[i];
+        double rgb[3];
+        int c;
+
+        if (value != value) {
+            rgb[0] = rgb[1] = rgb[2] = 0.95;    /* Background gray */
+        } else {
+            scale_color(grid_position(grid, value), rgb);
+        }
+
+        for (c = 0; c < 3; c++) {
+            int byte = (int)(rgb[c] * 255 + 0.5);
+            line[length++] = digits[byte >> 4];
+            line[length++] = digits[byte & 15];
+        }
+
+        if (length == PS_HEX_SAMPLES * 6 || i + 1 == count) {
+            line[length++] = '\n';
+            line[length] = '\0';
+            ps_write_string(out, line);
+            length = 0;
+        }
+    }
+
+    ps_write_string(out, "grestore\n\n");
+}
+
+/* ____________________________________________________________________________
+    Function: draw_contours
+    
+    Implementation Notes:
+    - Levels lie in the middle of num_contours equal parts of
+      [min_z, max_z], so no level touches the extremes
+    - Every row of cells is stroked on its own, so paths stay short
+____________________________________________________________________________ */
+static void draw_contours(PsWriter* out, const GraphParams* params,
+                          const GridData* grid) {
+    ps_write_string(out, "% Draw contours\n");
+    ps_write_string(out, "0.5 setlinewidth\n");
+    if (grid->heatmap) {
+        ps_write_string(out, "0 setgray\n");
+    }
+
+    int k;
+    for (k = 0; k < grid->num_contours; k++) {
+        double t = (k + 0.5) / grid->num_contours;
+        double level = grid->min_z + (grid->max_z - grid->min_z) * t;
+
+        if (!grid->heatmap) {
+            double rgb[3];
+            scale_color(t, rgb);
+            ps_write_number(out, rgb[0]);
+            ps_write_string(out, " ");
+            ps_write_number(out, rgb[1]);
+            ps_write_string(out, " ");
+            ps_write_number(out, rgb[2]);
+            ps_write_string(out, " setrgbcolor\n");
+        }
+
+        int i, j;
+        for (j = 0; j + 1 < grid->rows; j++) {
+            int started = 0;
+            for (i = 0; i + 1 < grid->columns; i++) {
+                contour_cell(out, params, grid, i, j, level, &started);
+            }
+            if (started) {
+                ps_write_string(out, "stroke\n");
+            }
+        }
+    }
+
+    ps_write_string(out, "\n");
+}
+
+/* ____________________________________________________________________________
+    Function: contour_cell
+    
+    Implementation Notes:
+    - Marching squares: the corners at or above the level form a 4-bit
+      case, the table lists the crossed edges joined by each segment
+    - Corners are numbered counterclockwise from the lower left, edge e
+      joins corner e and corner e + 1
+    - The two saddle cases are resolved by the average of the corners,
+      a center above the level joins the high corners, which separates
+      the corners like the complementary case
+    - Crossings are interpolated linearly along the edges
+____________________________________________________________________________ */
+static void contour_cell(PsWriter* out, const GraphParams* params,
+                         const GridData* grid, int i, int j, double level,
+                         int* started) {
+    static const signed char segments[16][4] = {
+        { -1, -1, -1, -1 }, { 3, 0, -1, -1 }, { 0, 1, -1, -1 },
+        { 3, 1, -1, -1 },   { 1, 2, -1, -1 }, { 3, 0, 1, 2 },
+        { 0, 2, -1, -1 },   { 3, 2, -1, -1 }, { 2, 3, -1, -1 },
+        { 0, 2, -1, -1 },   { 0, 1, 2, 3 },   { 1, 2, -1, -1 },
+        { 3, 1, -1, -1 },   { 0, 1, -1, -1 }, { 3, 0, -1, -1 },
+        { -1, -1, -1, -1 }
+    };
+    const double* row = grid->values + (size_t)j * grid->columns + i;
+    double value[4], x[4], y[4];
+    double cell_width = (double)params->width / (grid->columns - 1);
+    double cell_height = (double)params->height / (grid->rows - 1);
+    int cell = 0;
+    int c;
+
+    value[0] = row[0];
+    value[1] = row[1];
+    value[2] = row[grid->columns + 1];
+    value[3] = row[grid->columns];
+    x[0] = x[3] = i * cell_width;
+    x[1] = x[2] = (i + 1) * cell_width;
+    y[0] = y[1] = j * cell_height;
+    y[2] = y[3] = (j + 1) * cell_height;
+
+    for (c = 0; c < 4; c++) {
+        if (value[c] != value[c]) {
+            return;     /* Undefined corner */
+        }
+        if (value[c] >= level) {
+            cell |= 1 << c;
+        }
+    }
+
+    if ((cell == 5 || cell == 10) &&
+        (value[0] + value[1] + value[2] + value[3]) / 4 >= level) {
+        cell = 15 - cell;
+    }
+
+    int s;
+    for (s = 0; s < 4 && segments[cell][s] >= 0; s++) {
+        int a = segments[cell][s];
+        int b = (a + 1) % 4;
+        double t = (level - value[a]) / (value[b] - value[a]);
+
+        if (!*started) {
+            ps_write_string(out, "newpath\n");
+            *started = 1;
+        }
+        ps_write_number(out, x[a] + (x[b] - x[a]) * t);
+        ps_write_string(out, " ");
+        ps_write_number(out, y[a] + (y[b] - y[a]) * t);
+        ps_write_string(out, (s % 2 == 0) ? " moveto " : " lineto\n");
+    }
+}
+
+/* 
+    Graph Stream Structure
+    
+    State of a graph whose curves arrive in chunks:
+    - Every series keeps its own simplified path across the chunks
+    - resume marks series whose path continues into the next chunk
+*/
+struct PsStream {
+    PsWriter out;                /* Output of the document */
+    GraphParams params;          /* Layout of the graph */
+    PathSimplifier* paths;       /* Path of every series */
+    int* resume;                 /* Path continues in the next chunk */
+};
+
+/* ____________________________________________________________________________
+    Function: ps_stream_open
+    
+    Implementation Notes:
+    - Writes the whole document up to the curves right away
+____________________________________________________________________________ */
+int ps_stream_open(PsStream** stream, const GraphParams* params,
+                   const char* output_file) {
+    if (!stream || !validate_graph_layout(params) || !output_file) {
+        return ERROR_INVALID_PARAMS;
+    }
+
+    PsStream* s = malloc(sizeof(PsStream));
+    if (!s) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    s->paths = malloc(params->num_series * sizeof(PathSimplifier));
+    s->resume = calloc(params->num_series, sizeof(int));
+    if (!s->paths || !s->resume) {
+        free(s->paths);
+        free(s->resume);
+        free(s);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    s->out.file = fopen(output_file, "w");
+    if (!s->out.file) {
+        free(s->paths);
+        free(s->resume);
+        free(s);
+        return ERROR_FILE_OPERATION;
+    }
+    s->out.length = 0;
+    s->out.error = 0;
+    s->params = *params;
+
+    int i;
+    for (i = 0; i < params->num_series; i++) {
+        s->paths[i].out = &s->out;
+        s->paths[i].tolerance = params->tolerance;
+        s->paths[i].active = 0;
+        s->paths[i].has_pending = 0;
+        s->paths[i].constrained = 0;
+    }
+
+    write_document_start(&s->out, params);
+    ps_write_string(&s->out, "% Draw Function\n");
+
+    *stream = s;
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    Function: ps_stream_points
+    
+    Implementation Notes:
+    - Every series is stroked once per chunk, so paths stay short
+    - A path still running at the end of a chunk is ended at its last
+      sample and the next chunk moves back there first
+____________________________________________________________________________ */
+void ps_stream_points(PsStream* stream, const double* x, const double* y,
+                      int count) {
+    const GraphParams* params = &stream->params;
+    int ns = params->num_series;
+    int i, k;
+
+    for (k = 0; k < ns; k++) {
+        PathSimplifier* path = &stream->paths[k];
+
+        begin_series(&stream->out, &params->series[k]);
+        if (stream->resume[k]) {
+            path_add_point(path, path->anchor_x, path->anchor_y);
+        }
+
+        for (i = 0; i < count; i++) {
+            path_add_sample(path, params, x[i], y[(size_t)i * ns + k]);
+        }
+
+        stream->resume[k] = path->active;
+        path_end_segment(path);
+        end_series(&stream->out, &params->series[k]);
+    }
+}
+
+/* ____________________________________________________________________________
+    Function: ps_stream_close
+    
+    Implementation Notes:
+    - Finishes the document like generate_postscript_graph() and
+      releases the stream
+____________________________________________________________________________ */
+int ps_stream_close(PsStream* stream) {
+    if (!stream) {
+        return ERROR_INVALID_PARAMS;
+    }
+
+    ps_write_string(&stream->out, "\n");
+    int result = write_document_end(&stream->out);
+
+    free(stream->paths);
+    free(stream->resume);
+    free(stream);
+    return result;
+}
+
+/* 
+    Multi-page Document Structure
+*/
+struct PsDocument {
+    PsWriter out;                /* Output of the document */
+    int pages;                   /* Pages written so far */
+};
+
+/* ____________________________________________________________________________
+    Function: ps_document_open
+    
+    Implementation Notes:
+    - Writes only the header, every page sets up its own coordinate
+      system
+____________________________________________________________________________ */
+int ps_document_open(PsDocument** doc, const GraphParams* params,
+                     const char* output_file) {
+    if (!doc || !params || params->width <= 0 || params->height <= 0 ||
+        !output_file) {
+        return ERROR_INVALID_PARAMS;
+    }
+
+    PsDocument* d = malloc(sizeof(PsDocument));
+    if (!d) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    d->out.file = fopen(output_file, "w");
+    if (!d->out.file) {
+        free(d);
+        return ERROR_FILE_OPERATION;
+    }
+    d->out.length = 0;
+    d->out.error = 0;
+    d->pages = 0;
+
+    write_ps_header(&d->out, params);
+
+    *doc = d;
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    Function: ps_document_page
+    
+    Implementation Notes:
+    - The page is the document of generate_postscript_graph() without
+      the header, with the caption drawn between the labels and curves
+    - save/restore discards the definitions of the coordinate system,
+      restore follows showpage as usual for DSC pages
+____________________________________________________________________________ */
+int ps_document_page(PsDocument* doc, const GraphParams* params,
+                     const char* caption) {
+    if (!doc || !validate_graph_params(params)) {
+        return ERROR_INVALID_PARAMS;
+    }
+
+    PsWriter* out = &doc->out;
+    doc->pages++;
+
+    ps_write_string(out, "%%Page: ");
+    ps_write_int(out, doc->pages);
+    ps_write_string(out, " ");
+    ps_write_int(out, doc->pages);
+    ps_write_string(out, "\nsave\n");
+
+    setup_coordinate_system(out, params);
+    ps_write_string(out, "gsave\n");
+    ps_write_string(out, "margin margin translate\n");
+    ps_write_string(out, "/Helvetica-Bold findfont 12 scalefont setfont\n\n");
+    draw_grid_and_axes(out, params);
+    label_axes(out, params);
+
+    if (caption) {
+        /* Centered above the plot area, in the bold title font */
+        ps_write_string(out, "graphWidth 2 div graphHeight 15 add moveto\n");
+        ps_write_string(out, "(");
+        ps_write_string(out, caption);
+        ps_write_string(out, ") dup stringwidth pop 2 div neg 0 rmoveto show\n");
+    }
+
+    draw_function(out, params);
+
+    ps_write_string(out, "grestore\n");
+    ps_write_string(out, "showpage\n");
+    ps_write_string(out, "restore\n");
+    return 0;
+}
+
+/* ____________________________________________________________________________
+    Function: ps_document_close
+    
+    Implementation Notes:
+    - Closes the file and releases the document also when a write
+      failed
+____________________________________________________________________________ */
+int ps_document_close(PsDocument* doc) {
+    if (!doc) {
+        return ERROR_INVALID_PARAMS;
+    }
+
+    PsWriter* out = &doc->out;
+    ps_write_string(out, "%%Trailer\n");
+    ps_write_string(out, "%%Pages: ");
+    ps_write_int(out, doc->pages);
+    ps_write_string(out, "\n%EOF\n");
+
+    ps_flush(out);
+    int result = (fclose(out->file) != 0 || out->error) ?
+                 ERROR_FILE_OPERATION : 0;
+
+    free(doc);
+    return result;
+}
+
+/* ____________________________________________________________________________
+    Function: ps_flush
+    
+    Implementation Notes:
+    - Writes the buffered output with a single fwrite() call
+    - Remembers a failed write, later output is discarded
+____________________________________________________________________________ */
+int ps_flush(PsWriter* out) {
+    if (out->length > 0 && !out->error &&
+        fwrite(out->buffer, 1, out->length, out->file) != out->length) {
+        out->error = 1;
+    }
+    out->length = 0;
+
+    return out->error ? ERROR_FILE_OPERATION : 0;
+}
+
+/* ____________________________________________________________________________
+    Function: ps_write_string
+    
+    Implementation Notes:
+    - Copies the string into the buffer, flushing whenever it fills up
+    - Strings longer than the buffer are written in several chunks
+____________________________________________________________________________ */
+void ps_write_string(PsWriter* out, const char* text) {
+    size_t length = strlen(text);
+
+    while (length > 0) {
+        size_t room = PS_BUFFER_SIZE - out->length;
+        size_t chunk = (length < room) ? length : room;
+
+        memcpy(out->buffer + out->length, text, chunk);
+        out->length += chunk;
+        text += chunk;
+        length -= chunk;
+
+        if (out->length == PS_BUFFER_SIZE) {
+            ps_flush(out);
+        }
+    }
+}
+
+/* ____________________________________________________________________________
+    Function: ps_write_int
+    
+    Implementation Notes:
+    - Digits are generated backwards into a small local buffer
+    - Negative values are handled through unsigned arithmetic, so the
+      most negative int is printed correctly
+____________________________________________________________________________ */
+void ps_write_int(PsWriter* out, int value) {
+    char digits[16];
+    char* p = digits + sizeof(digits);
+    unsigned long magnitude = (value < 0) ? 0UL - (unsigned long)value
+                                          : (unsigned long)value;
+
+    *--p = '\0';
+    do {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0) {
+        *--p = '-';
+    }
+
+    ps_write_string(out, p);
+}
+
+/* ____________________________________________________________________________
+    Function: ps_write_number
+    
+    Implementation Notes:
+    - Rounds the value to hundredths and prints the integer number of
+      hundredths, the decimal point is inserted before the last two digits
+    - Trailing zeros of the fraction and the decimal point are omitted
+      ("12.5" instead of "12.50", "3" instead of "3.00")
+    - Values that do not fit into the integer fast path fall back to
+      ps_write_general()
+
+    No libc formatting is involved in the fast path, plot coordinates
+    are always small enough for it.
+____________________________________________________________________________ */
+void ps_write_number(PsWriter* out, double value) {
+    char digits[24];
+    char* p = digits + sizeof(digits);
+    double magnitude = fabs(value);
+    unsigned long hundredths;
+    unsigned fraction;
+
+    /* NaN fails the comparison and takes the general path as well */
+    if (!(magnitude < PS_FAST_NUMBER_LIMIT)) {
+        ps_write_general(out, value);
+        return;
+    }
+
+    hundredths = (unsigned long)(magnitude * 100.0 + 0.5);
+    fraction = (unsigned)(hundredths % 100);
+    hundredths /= 100;
+
+    *--p = '\0';
+    if (fraction != 0) {
+        if (fraction % 10 != 0) {
+            *--p = (char)('0' + fraction % 10);
+        }
+        *--p = (char)('0' + fraction / 10);
+        *--p = '.';
+    }
+    do {
+        *--p = (char)('0' + hundredths % 10);
+        hundredths /= 10;
+    } while (hundredths > 0);
+
+    /* Values rounding to zero are printed without sign */
+    if (value < 0 && (fraction != 0 || p[0] != '0' || p[1] != '\0')) {
+        *--p = '-';
+    }
+
+    ps_write_string(out, p);
+}
+
+/* ____________________________________________________________________________
+    Function: ps_write_general
+    
+    Implementation Notes:
+    - Uses the %g conversion, for values needing more than the fixed
+      0.01 precision (scale factors) or outside the fast path range
+____________________________________________________________________________ */
+void ps_write_general(PsWriter* out, double value) {
+    char temp[32];
+
+    sprintf(temp, "%g", value);
+    ps_write_string(out, temp);
+}
+
 /* ____________________________________________________________________________
     Function: print_graph_error
     
@@ -10,6 +10,8 @@
     - Automatic axis scaling and labeling
     - Customizable graph dimensions and divisions
     - Support for arbitrary function data points
+    - Several curves sharing one set of axes
+    - Heatmaps and contour lines of functions of x and y
     - Professional-grade PostScript output
     - Comprehensive error handling
     
@@ -21,7 +23,8 @@
     Usage Requirements:
     - Input data must be pre-calculated
     - Requires write access to output directory
-    - Memory requirements scale with number of points
+    - Memory requirements scale with number of points, except for
+      streamed graphs
 ____________________________________________________________________________ */
 
 #ifndef POSTSCRIPT_GRAPH_H
@@ -40,13 +43,59 @@ ____________________________________________________________________________ */
 #define ERROR_FILE_OPERATION     -2  /* File access or write operation failed */
 #define ERROR_MEMORY_ALLOCATION  -3  /* Dynamic memory allocation failed */
 
+/* Default curve simplification tolerance in points, well below the
+   width of the drawn line */
+#define PS_DEFAULT_TOLERANCE     0.1
+
+/* Size of the output buffer, the file is written in chunks of this size */
+#define PS_BUFFER_SIZE           65536
+
+/* Magnitude limit of the integer fast path of ps_write_number(), keeps
+   the number of hundredths within 32 bits */
+#define PS_FAST_NUMBER_LIMIT     1e7
+
+/* 
+    PostScript Writer Structure
+    
+    Buffered output of the generated document:
+    - Text is collected in a user-space buffer
+    - The buffer is written with one fwrite() call whenever it fills up
+    - A failed write is remembered and reported by ps_flush()
+*/
+typedef struct {
+    FILE *file;                  /* Output file */
+    char buffer[PS_BUFFER_SIZE]; /* Pending output */
+    size_t length;               /* Number of pending bytes */
+    int error;                   /* Nonzero after a failed write */
+} PsWriter;
+
+/* Number of distinct colors of the default series styles */
+#define PS_PALETTE_SIZE          6
+
+/* 
+    Graph Series Structure
+    
+    One curve of the graph:
+    - Function values, stride apart, so interleaved sample arrays can
+      be drawn without copying
+    - Pen color and dash length, 0 draws a solid line
+*/
+typedef struct {
+    const double *points;       /* First function value */
+    int stride;                 /* Distance of consecutive values */
+    double red, green, blue;    /* Pen color, components in [0, 1] */
+    double dash;                /* Dash length in points, 0 if solid */
+} GraphSeries;
+
 /* 
     Graph Parameters Structure
     
     Contains all necessary parameters for graph generation:
     - Axis ranges and dimensions
     - Grid division specifications
-    - Function data points
+    - Function data points of one or more series, evenly spaced over the
+      x-axis range unless their x coordinates are given explicitly
+    - Tolerance of the curve simplification, 0 writes every point
 */
 typedef struct {
     double min_x, max_x;        /* X-axis range */
@@ -54,10 +103,35 @@ typedef struct {
     int width, height;          /* Graph dimensions in points */
     int x_divisions;            /* Number of x-axis grid divisions */
     int y_divisions;            /* Number of y-axis grid divisions */
-    double *points;             /* Array of function values */
-    int num_points;             /* Number of data points */
+    const GraphSeries *series;  /* Curves to be drawn */
+    int num_series;             /* Number of curves */
+    double *x_coords;           /* X coordinates of points, NULL if uniform */
+    int num_points;             /* Number of data points per series */
+    double tolerance;           /* Path simplification tolerance in points */
 } GraphParams;
 
+/* Largest number of contour levels of a grid graph */
+#define PS_MAX_CONTOURS          64
+
+/* 
+    Grid Data Structure
+    
+    Function of x and y sampled on a regular grid:
+    - columns samples over the x-axis range and rows samples over the
+      y-axis range of the graph, both ends included
+    - Row j starts at values[j * columns], rows go up from min_y
+    - NaN marks undefined samples
+    - Values from min_z to max_z are mapped to the color scale, contour
+      levels are spread evenly over the same range
+*/
+typedef struct {
+    const double *values;       /* Samples, row by row */
+    int columns, rows;          /* Grid size, at least 2 x 2 */
+    double min_z, max_z;        /* Range of the color scale */
+    int heatmap;                /* Nonzero to fill the graph with colors */
+    int num_contours;           /* Number of contour levels, 0 for none */
+} GridData;
+
 /* ____________________________________________________________________________
     Function: generate_axis_label
     
@@ -76,6 +150,22 @@ typedef struct {
 ____________________________________________________________________________ */
 void generate_axis_label(char* buffer, size_t buffer_size, double value);
 
+/* ____________________________________________________________________________
+    Function: set_default_series_style
+    
+    Assigns the color and dash pattern of the index-th curve of a graph.
+    
+    Parameters:
+    - series: Series receiving the style
+    - index:  Position of the series in the graph
+    
+    Style Rules:
+    - The first series is blue and solid, as single curves always were
+    - Colors repeat after PS_PALETTE_SIZE series, the repeated ones are
+      dashed with growing dash lengths
+____________________________________________________________________________ */
+void set_default_series_style(GraphSeries* series, int index);
+
 /* ____________________________________________________________________________
     Function: validate_graph_params
     
@@ -103,7 +193,7 @@ int validate_graph_params(const GraphParams* params);
     and metadata.
     
     Parameters:
-    - ps_file: Output file pointer
+    - out:     Buffered output writer
     - params:  Graph parameters for dimension information
     
     PostScript Elements:
@@ -111,7 +201,7 @@ int validate_graph_params(const GraphParams* params);
     - Creator information
     - BoundingBox specification
 ____________________________________________________________________________ */
-void write_ps_header(FILE* ps_file, const GraphParams* params);
+void write_ps_header(PsWriter* out, const GraphParams* params);
 
 /* ____________________________________________________________________________
     Function: setup_coordinate_system
@@ -120,7 +210,7 @@ void write_ps_header(FILE* ps_file, const GraphParams* params);
     for the graph.
     
     Parameters:
-    - ps_file: Output file pointer
+    - out:     Buffered output writer
     - params:  Graph parameters for scaling calculations
     
     Coordinate System:
@@ -128,23 +218,26 @@ void write_ps_header(FILE* ps_file, const GraphParams* params);
     - Scales adjusted for specified ranges
     - Margins included in calculations
 ____________________________________________________________________________ */
-void setup_coordinate_system(FILE* ps_file, const GraphParams* params);
+void setup_coordinate_system(PsWriter* out, const GraphParams* params);
 
 /* ____________________________________________________________________________
     Function: draw_function
     
-    Renders the function curve using the provided data points.
+    Renders the function curves using the provided data points.
     
     Parameters:
-    - ps_file: Output file pointer
+    - out:     Buffered output writer
     - params:  Graph parameters including function data
     
     Drawing Features:
     - Automatic point connection
     - Range checking
     - Discontinuity handling
+    - Uniform or explicit x coordinates
+    - Omits vertices closer than params->tolerance to the drawn line
+    - One stroked path per series in the order of params->series
 ____________________________________________________________________________ */
-void draw_function(FILE* ps_file, const GraphParams* params);
+void draw_function(PsWriter* out, const GraphParams* params);
 
 /* ____________________________________________________________________________
     Function: draw_grid_and_axes
@@ -152,7 +245,7 @@ void draw_function(FILE* ps_file, const GraphParams* params);
     Draws the graph grid lines and main coordinate axes.
     
     Parameters:
-    - ps_file: Output file pointer
+    - out:     Buffered output writer
     - params:  Graph parameters for grid specifications
     
     Visual Elements:
@@ -160,7 +253,7 @@ void draw_function(FILE* ps_file, const GraphParams* params);
     - Grid lines at specified divisions
     - Main coordinate axes
 ____________________________________________________________________________ */
-void draw_grid_and_axes(FILE* ps_file, const GraphParams* params);
+void draw_grid_and_axes(PsWriter* out, const GraphParams* params);
 
 /* ____________________________________________________________________________
     Function: label_axes
@@ -168,7 +261,7 @@ void draw_grid_and_axes(FILE* ps_file, const GraphParams* params);
     Adds formatted labels to both axes including tick marks and titles.
     
     Parameters:
-    - ps_file: Output file pointer
+    - out:     Buffered output writer
     - params:  Graph parameters for label positioning
     
     Label Features:
@@ -176,7 +269,43 @@ void draw_grid_and_axes(FILE* ps_file, const GraphParams* params);
     - Centered placement
     - Axis titles
 ____________________________________________________________________________ */
-void label_axes(FILE* ps_file, const GraphParams* params);
+void label_axes(PsWriter* out, const GraphParams* params);
+
+/* ____________________________________________________________________________
+    Function: ps_write_string, ps_write_int, ps_write_number,
+              ps_write_general
+    
+    Append text or numbers to the output buffer.
+    
+    Parameters:
+    - out:   Buffered output writer
+    - text:  Zero-terminated string to append
+    - value: Number to format
+    
+    Number Formats:
+    - ps_write_int:     Decimal integer
+    - ps_write_number:  Fixed precision of 0.01 without trailing zeros,
+                        the precision of PostScript coordinates in points
+    - ps_write_general: The %g conversion for other values
+____________________________________________________________________________ */
+void ps_write_string(PsWriter* out, const char* text);
+void ps_write_int(PsWriter* out, int value);
+void ps_write_number(PsWriter* out, double value);
+void ps_write_general(PsWriter* out, double value);
+
+/* ____________________________________________________________________________
+    Function: ps_flush
+    
+    Writes all buffered output to the file.
+    
+    Parameters:
+    - out: Buffered output writer
+    
+    Returns:
+    - 0 on success
+    - ERROR_FILE_OPERATION if this or any earlier write failed
+____________________________________________________________________________ */
+int ps_flush(PsWriter* out);
 
 /* ____________________________________________________________________________
     Function: generate_postscript_graph
@@ -199,4 +328,147 @@ void label_axes(FILE* ps_file, const GraphParams* params);
 ____________________________________________________________________________ */
 int generate_postscript_graph(const GraphParams* params, const char* output_file);
 
+/* ____________________________________________________________________________
+    Function: generate_postscript_grid
+    
+    Generates a PostScript graph of a function of x and y.
+    
+    Parameters:
+    - params:      Axis ranges, dimensions and divisions; series, x_coords,
+                   num_points and tolerance are not used
+    - grid:        Samples and drawing style
+    - output_file: Path to output file
+    
+    Returns:
+    - 0 on success
+    - Negative error code on failure
+    
+    Drawing Features:
+    - Heatmap: every sample colors the cell around it, undefined samples
+      keep the background
+    - Contours: lines of constant value traced by marching squares,
+      black over a heatmap and colored by level without one
+    - Cells with an undefined corner have no contour lines
+____________________________________________________________________________ */
+int generate_postscript_grid(const GraphParams* params, const GridData* grid,
+                             const char* output_file);
+
+/* 
+    Graph Stream
+    
+    Graph written while its samples are still being produced:
+    - The document up to the curves is written when the stream opens
+    - Samples follow in chunks of increasing x, every chunk is drawn and
+      released by the caller right away
+    - Memory use does not depend on the total number of samples
+*/
+typedef struct PsStream PsStream;
+
+/* ____________________________________________________________________________
+    Function: ps_stream_open
+    
+    Creates the output file of a streamed graph.
+    
+    Parameters:
+    - stream:      Receives the new stream
+    - params:      Graph layout and series styles; points, x_coords and
+                   num_points are not used
+    - output_file: Path to output file
+    
+    Returns:
+    - 0 on success
+    - Negative error code on failure
+____________________________________________________________________________ */
+int ps_stream_open(PsStream** stream, const GraphParams* params,
+                   const char* output_file);
+
+/* ____________________________________________________________________________
+    Function: ps_stream_points
+    
+    Draws the next chunk of samples of all series.
+    
+    Parameters:
+    - stream: Open stream
+    - x:      X coordinates of count samples, continuing the previous
+              chunk in increasing order
+    - y:      Function values, value k of sample i is y[i * num_series + k]
+    - count:  Number of samples
+____________________________________________________________________________ */
+void ps_stream_points(PsStream* stream, const double* x, const double* y,
+                      int count);
+
+/* ____________________________________________________________________________
+    Function: ps_stream_close
+    
+    Finishes the document, closes the file and releases the stream.
+    
+    Returns:
+    - 0 on success
+    - ERROR_FILE_OPERATION if any write failed
+____________________________________________________________________________ */
+int ps_stream_close(PsStream* stream);
+
+/* 
+    Multi-page Document
+    
+    Sequence of curve graphs, one per page, e.g. the frames of a
+    parameter sweep:
+    - The header is written once when the document opens
+    - Every page is a complete graph with its own axis ranges, enclosed
+      in save/restore so pages do not depend on each other
+    - Pages are written as they are added, the caller may reuse the
+      sample arrays for the next page right away
+*/
+typedef struct PsDocument PsDocument;
+
+/* ____________________________________________________________________________
+    Function: ps_document_open
+    
+    Creates the output file of a multi-page document.
+    
+    Parameters:
+    - doc:         Receives the new document
+    - params:      Layout used for the bounding box of the header, every
+                   page must have the same width and height
+    - output_file: Path to output file
+    
+    Returns:
+    - 0 on success
+    - Negative error code on failure
+____________________________________________________________________________ */
+int ps_document_open(PsDocument** doc, const GraphParams* params,
+                     const char* output_file);
+
+/* ____________________________________________________________________________
+    Function: ps_document_page
+    
+    Appends a page with the graph of generate_postscript_graph().
+    
+    Parameters:
+    - doc:     Open document
+    - params:  Complete graph parameters, as for
+               generate_postscript_graph()
+    - caption: Text centered above the graph, NULL for none; must not
+               contain parentheses or backslashes
+    
+    Returns:
+    - 0 on success
+    - ERROR_INVALID_PARAMS if the parameters are invalid, nothing is
+      written in that case
+____________________________________________________________________________ */
+int ps_document_page(PsDocument* doc, const GraphParams* params,
+                     const char* caption);
+
+/* ____________________________________________________________________________
+    Function: ps_document_close
+    
+    Writes the trailer with the number of pages, closes the file and
+    releases the document.
+    
+    Returns:
+    - 0 on success
+    - ERROR_FILE_OPERATION if any write failed
+____________________________________________________________________________ */
+int ps_document_close(PsDocument* doc);
+
 #endif /* POSTSCRIPT_GRAPH_H */
\ No newline at end of file
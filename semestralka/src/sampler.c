@@ -0,0 +1,692 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module sampler.c
+
+    Adaptive sampling of compiled expressions for plotting.
+
+    Implementation Details:
+    - Samples are kept in two parallel arrays ordered by x, the values
+      of all expressions of a sample are stored next to each other
+    - An interval is refined when any of the expressions needs it, so all
+      curves share one set of x coordinates
+    - Every pass classifies all intervals, evaluates the midpoints of the
+      ones to refine in a single batch and merges them in place
+    - Vertical distances are clamped to a band around the visible range,
+      so huge values near poles do not distort the measurements
+    - Interval arithmetic (interval.h) removes parts of the grid whose
+      values are all outside the window before they are evaluated, and
+      decides whether a suspected jump can really be a discontinuity
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#include "sampler.h"
+#include "evaluator.h"  /* Batched evaluation of samples */
+#include "interval.h"   /* Enclosures of whole intervals */
+
+/* Interval classification */
+#define INTERVAL_KEEP    0  /* Segment is good enough */
+#define INTERVAL_REFINE  1  /* Evaluate the midpoint */
+#define INTERVAL_BREAK   2  /* Jump, path is broken at the midpoint */
+
+/*
+  Sampler context
+  Window transformation and per-pass work arrays.
+*/
+typedef struct {
+    const Program *prog;     /* Sampled program */
+    SampleSet *samples;      /* Samples being refined */
+    int num_series;          /* Values per sample */
+    double min_x, min_y;     /* Window origin */
+    double max_y;            /* Top of the window */
+    double x_scale;          /* Plot units per unit of x */
+    double y_scale;          /* Plot units per unit of y */
+    double height;           /* Plot height */
+    char *marks;             /* Classification of every interval */
+    double *mid_x;           /* Midpoints to be inserted */
+    double *mid_y;           /* Values at the midpoints, num_series each */
+    char *mid_defined;       /* Definition flags of the midpoint values */
+    int work_capacity;       /* Length of the work arrays */
+} Sampler;
+
+/* Internal function prototypes */
+static int reserve_samples(SampleSet *samples, int capacity);
+static int reserve_work(Sampler *s, int capacity);
+static double plot_y(const Sampler *s, double y);
+static int outside_same_side(const Sampler *s, double py0, double py1);
+static double interval_slope(const Sampler *s, int k, int i);
+static double neighbour_slope(const Sampler *s, int k, int i);
+static int enclosure(const Sampler *s, int k, int i, Interval *result);
+static int hidden(const Sampler *s, const Interval *value);
+static int block_hidden(const Sampler *s, double a, double b);
+static int classify_interval(const Sampler *s, int k, int i);
+static int classify_all(const Sampler *s, int i);
+static void mark_intervals(Sampler *s);
+static void mark_curvature(const Sampler *s, int k);
+static int collect_midpoints(Sampler *s, char kind);
+static void insert_midpoints(Sampler *s, char kind, int m);
+
+/* ____________________________________________________________________________
+    int sample_function(const Program *prog, const SampleWindow *window,
+                        int num_threads, SampleSet *samples)
+
+    Samples a program adaptively over the plotting window.
+
+    Sampling Strategy:
+    - Evaluate a uniform grid with SAMPLER_INITIAL_STEP spacing, blocks of
+      SAMPLER_CULL_BLOCK grid intervals that are provably outside the
+      window keep only their end points
+    - Classify intervals and bisect the marked ones, one pass per level
+    - Stop when nothing is marked or a sampling limit is reached
+    - Insert path breaks into intervals localized as jumps, only the
+      curves jumping there are broken
+   ____________________________________________________________________________
+*/
+int sample_function(const Program *prog, const SampleWindow *window,
+                    int num_threads, SampleSet *samples) {
+    Sampler s;
+    double step;
+    int n, i, k, pass, m, ns, count;
+    int ok = 1;
+
+    if (!samples) {
+        return 0;
+    }
+    memset(samples, 0, sizeof(*samples));
+
+    if (!prog || !window || window->max_x <= window->min_x ||
+        window->max_y <= window->min_y ||
+        window->width <= 0 || window->height <= 0) {
+        return 0;
+    }
+
+    ns = prog->num_outputs > 0 ? prog->num_outputs : 1;
+    samples->num_series = ns;
+
+    memset(&s, 0, sizeof(s));
+    s.prog = prog;
+    s.samples = samples;
+    s.num_series = ns;
+    s.min_x = window->min_x;
+    s.min_y = window->min_y;
+    s.max_y = window->max_y;
+    s.x_scale = window->width / (window->max_x - window->min_x);
+    s.y_scale = window->height / (window->max_y - window->min_y);
+    s.height = window->height;
+
+    /* Coarse uniform grid */
+    n = (int)(window->width / SAMPLER_INITIAL_STEP) + 1;
+    if (n < 2) {
+        n = 2;
+    }
+    if (!reserve_samples(samples, n) || !reserve_work(&s, n)) {
+        free_samples(samples);
+        free(s.marks);
+        free(s.mid_x);
+        free(s.mid_y);
+        free(s.mid_defined);
+        return 0;
+    }
+
+    /* Same sampling formula as evaluate_expression_range(), interiors
+       of hidden blocks are left out */
+    step = (window->max_x - window->min_x) / (n - 1);
+    count = 0;
+    for (i = 0; i < n - 1; i += SAMPLER_CULL_BLOCK) {
+        int end = (i + SAMPLER_CULL_BLOCK < n - 1) ? i + SAMPLER_CULL_BLOCK : n - 1;
+        int j;
+
+        if (block_hidden(&s, window->min_x + i * step,
+                         window->min_x + end * step)) {
+            samples->x[count++] = window->min_x + i * step;
+            continue;
+        }
+        for (j = i; j < end; j++) {
+            samples->x[count++] = window->min_x + j * step;
+        }
+    }
+    samples->x[count++] = window->min_x + (n - 1) * step;
+
+    if (!evaluate_expression_points_parallel(prog, samples->x, count,
+                                             samples->y, s.mid_defined,
+                                             num_threads)) {
+        free_samples(samples);
+        free(s.marks);
+        free(s.mid_x);
+        free(s.mid_y);
+        free(s.mid_defined);
+        return 0;
+    }
+    for (i = 0; i < count * ns; i++) {
+        if (!s.mid_defined[i]) {
+            samples->num_undefined++;
+        }
+    }
+    samples->count = count;
+    samples->num_evaluations = count;
+
+    /* Refinement passes */
+    for (pass = 0; ok && pass < SAMPLER_MAX_PASSES; pass++) {
+        mark_intervals(&s);
+
+        m = collect_midpoints(&s, INTERVAL_REFINE);
+        if (m == 0 || samples->count + m > SAMPLER_MAX_POINTS) {
+            break;
+        }
+
+        if (!evaluate_expression_points_parallel(prog, s.mid_x, m, s.mid_y,
+                                                 s.mid_defined, num_threads)) {
+            ok = 0;
+            break;
+        }
+        for (i = 0; i < m * ns; i++) {
+            if (!s.mid_defined[i]) {
+                samples->num_undefined++;
+            }
+        }
+        samples->num_evaluations += m;
+
+        if (!reserve_samples(samples, samples->count + m)) {
+            ok = 0;
+            break;
+        }
+        insert_midpoints(&s, INTERVAL_REFINE, m);
+
+        if (!reserve_work(&s, samples->count)) {
+            ok = 0;
+        }
+    }
+
+    /* Break the path inside jumps that survived bisection */
+    if (ok) {
+        for (i = 0; i < samples->count - 1; i++) {
+            s.marks[i] = (char)classify_all(&s, i);
+        }
+
+        m = collect_midpoints(&s, INTERVAL_BREAK);
+        if (m > 0 && ns > 1) {
+            /* Curves without a jump continue through the break */
+            if (evaluate_expression_points_parallel(prog, s.mid_x, m, s.mid_y,
+                                                    s.mid_defined, num_threads)) {
+                int j = 0;
+                for (i = 0; i < samples->count - 1; i++) {
+                    if (s.marks[i] != INTERVAL_BREAK) {
+                        continue;
+                    }
+                    for (k = 0; k < ns; k++) {
+                        if (classify_interval(&s, k, i) == INTERVAL_BREAK) {
+                            s.mid_y[j * ns + k] = 0.0 / 0.0;
+                        } else if (!s.mid_defined[j * ns + k]) {
+                            samples->num_undefined++;
+                        }
+                    }
+                    j++;
+                }
+                samples->num_evaluations += m;
+            } else {
+                ok = 0;
+            }
+        } else {
+            for (i = 0; i < m; i++) {
+                s.mid_y[i] = 0.0 / 0.0;
+            }
+        }
+        if (ok && m > 0) {
+            if (reserve_samples(samples, samples->count + m)) {
+                insert_midpoints(&s, INTERVAL_BREAK, m);
+            } else {
+                ok = 0;
+            }
+        }
+    }
+
+    free(s.marks);
+    free(s.mid_x);
+    free(s.mid_y);
+    free(s.mid_defined);
+
+    if (!ok) {
+        free_samples(samples);
+    }
+    return ok;
+}
+
+/* ____________________________________________________________________________
+    void free_samples(SampleSet *samples)
+
+    Releases both sample arrays and resets the set.
+   ____________________________________________________________________________
+*/
+void free_samples(SampleSet *samples) {
+    if (!samples) {
+        return;
+    }
+
+    free(samples->x);
+    free(samples->y);
+    memset(samples, 0, sizeof(*samples));
+}
+
+/* ____________________________________________________________________________
+    static int reserve_samples(SampleSet *samples, int capacity)
+
+    Grows the sample arrays to hold at least capacity samples.
+   ____________________________________________________________________________
+*/
+static int reserve_samples(SampleSet *samples, int capacity) {
+    int new_capacity;
+    double *new_x, *new_y;
+
+    if (capacity <= samples->capacity) {
+        return 1;
+    }
+
+    new_capacity = samples->capacity ? samples->capacity : 256;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+
+    new_x = realloc(samples->x, new_capacity * sizeof(double));
+    if (!new_x) {
+        return 0;
+    }
+    samples->x = new_x;
+
+    new_y = realloc(samples->y,
+                    (size_t)new_capacity * samples->num_series * sizeof(double));
+    if (!new_y) {
+        return 0;
+    }
+    samples->y = new_y;
+
+    samples->capacity = new_capacity;
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    static int reserve_work(Sampler *s, int capacity)
+
+    Grows the work arrays, one entry per sample is always enough since
+    there is one interval less than samples. Midpoint values and flags
+    have num_series entries per midpoint.
+   ____________________________________________________________________________
+*/
+static int reserve_work(Sampler *s, int capacity) {
+    char *new_marks, *new_defined;
+    double *new_x, *new_y;
+
+    if (capacity <= s->work_capacity) {
+        return 1;
+    }
+
+    new_marks = realloc(s->marks, capacity);
+    if (!new_marks) {
+        return 0;
+    }
+    s->marks = new_marks;
+
+    new_x = realloc(s->mid_x, capacity * sizeof(double));
+    if (!new_x) {
+        return 0;
+    }
+    s->mid_x = new_x;
+
+    new_y = realloc(s->mid_y,
+                    (size_t)capacity * s->num_series * sizeof(double));
+    if (!new_y) {
+        return 0;
+    }
+    s->mid_y = new_y;
+
+    new_defined = realloc(s->mid_defined, (size_t)capacity * s->num_series);
+    if (!new_defined) {
+        return 0;
+    }
+    s->mid_defined = new_defined;
+
+    s->work_capacity = capacity;
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    static double plot_y(const Sampler *s, double y)
+
+    Converts a value to the vertical plot coordinate, clamped to the band
+    of one plot height above and below the visible range.
+   ____________________________________________________________________________
+*/
+static double plot_y(const Sampler *s, double y) {
+    double py = (y - s->min_y) * s->y_scale;
+
+    if (py < -s->height) {
+        return -s->height;
+    }
+    if (py > 2 * s->height) {
+        return 2 * s->height;
+    }
+    return py;
+}
+
+/* ____________________________________________________________________________
+    static int outside_same_side(const Sampler *s, double py0, double py1)
+
+    Checks whether a segment lies completely below or above the plot.
+   ____________________________________________________________________________
+*/
+static int outside_same_side(const Sampler *s, double py0, double py1) {
+    return (py0 < 0 && py1 < 0) || (py0 > s->height && py1 > s->height);
+}
+
+/* ____________________________________________________________________________
+    static double interval_slope(const Sampler *s, int k, int i)
+
+    Returns the absolute slope of curve k over interval i in plot units,
+    or zero for intervals that do not exist or have an undefined end.
+   ____________________________________________________________________________
+*/
+static double interval_slope(const Sampler *s, int k, int i) {
+    const SampleSet *samples = s->samples;
+    double y0, y1, width;
+
+    if (i < 0 || i >= samples->count - 1) {
+        return 0;
+    }
+
+    y0 = samples->y[i * s->num_series + k];
+    y1 = samples->y[(i + 1) * s->num_series + k];
+    width = (samples->x[i + 1] - samples->x[i]) * s->x_scale;
+    if (y0 != y0 || y1 != y1 || width <= 0) {
+        return 0;
+    }
+
+    return fabs(plot_y(s, y1) - plot_y(s, y0)) / width;
+}
+
+/* ____________________________________________________________________________
+    static double neighbour_slope(const Sampler *s, int k, int i)
+
+    Returns the larger slope of curve k over the two intervals around
+    interval i.
+   ____________________________________________________________________________
+*/
+static double neighbour_slope(const Sampler *s, int k, int i) {
+    double left = interval_slope(s, k, i - 1);
+    double right = interval_slope(s, k, i + 1);
+
+    return left > right ? left : right;
+}
+
+/* ____________________________________________________________________________
+    static int enclosure(const Sampler *s, int k, int i, Interval *result)
+
+    Computes the enclosure of curve k over interval i.
+   ____________________________________________________________________________
+*/
+static int enclosure(const Sampler *s, int k, int i, Interval *result) {
+    Interval values[MAX_PROGRAM_OUTPUTS];
+
+    if (!evaluate_interval(s->prog, s->samples->x[i], s->samples->x[i + 1],
+                           values)) {
+        return 0;
+    }
+
+    *result = values[k];
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    static int hidden(const Sampler *s, const Interval *value)
+
+    Checks whether an enclosure has no value inside the window.
+   ____________________________________________________________________________
+*/
+static int hidden(const Sampler *s, const Interval *value) {
+    return value->empty || value->hi < s->min_y || value->lo > s->max_y;
+}
+
+/* ____________________________________________________________________________
+    static int block_hidden(const Sampler *s, double a, double b)
+
+    Checks whether no curve has a visible value for x in [a, b].
+   ____________________________________________________________________________
+*/
+static int block_hidden(const Sampler *s, double a, double b) {
+    Interval values[MAX_PROGRAM_OUTPUTS];
+    int k;
+
+    if (!evaluate_interval(s->prog, a, b, values)) {
+        return 0;
+    }
+
+    for (k = 0; k < s->num_series; k++) {
+        if (!hidden(s, &values[k])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    static int classify_interval(const Sampler *s, int k, int i)
+
+    Decides whether curve k needs the interval between samples i and
+    i + 1 refined.
+
+    Classification Rules:
+    - Both ends undefined or invisible: keep
+    - Exactly one end defined: bisect down to SAMPLER_MIN_BISECT, unless
+      the whole interval is provably invisible
+    - Large vertical gap: bisect down to SAMPLER_GAP_STEP
+    - Below SAMPLER_GAP_STEP: bisect jumps down to SAMPLER_MIN_BISECT and
+      break the path there, unless interval arithmetic proves the curve
+      continuous over the interval
+   ____________________________________________________________________________
+*/
+static int classify_interval(const Sampler *s, int k, int i) {
+    const SampleSet *samples = s->samples;
+    double x0 = samples->x[i], x1 = samples->x[i + 1];
+    double y0 = samples->y[i * s->num_series + k];
+    double y1 = samples->y[(i + 1) * s->num_series + k];
+    double mid = x0 + (x1 - x0) / 2;
+    double width = (x1 - x0) * s->x_scale;
+    int defined0 = (y0 == y0), defined1 = (y1 == y1);
+    int divisible = width > SAMPLER_MIN_BISECT && mid > x0 && mid < x1;
+    double py0, py1;
+    Interval value;
+
+    if (!defined0 && !defined1) {
+        return INTERVAL_KEEP;
+    }
+
+    /* Domain boundary */
+    if (defined0 != defined1) {
+        if (!divisible || (enclosure(s, k, i, &value) && hidden(s, &value))) {
+            return INTERVAL_KEEP;
+        }
+        return INTERVAL_REFINE;
+    }
+
+    py0 = plot_y(s, y0);
+    py1 = plot_y(s, y1);
+    if (outside_same_side(s, py0, py1)) {
+        return INTERVAL_KEEP;
+    }
+
+    if (fabs(py1 - py0) <= SAMPLER_MAX_GAP) {
+        return INTERVAL_KEEP;
+    }
+
+    /* Steep part, one sample per plot unit is enough for straight ones */
+    if (width > SAMPLER_GAP_STEP) {
+        return INTERVAL_REFINE;
+    }
+
+    /* Below that only jumps are localized, their slope exceeds the slope
+       of both neighbouring intervals many times */
+    if (interval_slope(s, k, i) <=
+        SAMPLER_JUMP_RATIO * neighbour_slope(s, k, i)) {
+        return INTERVAL_KEEP;
+    }
+
+    /* Steep but continuous, nothing to localize */
+    if (enclosure(s, k, i, &value) && value.continuous) {
+        return INTERVAL_KEEP;
+    }
+    return divisible ? INTERVAL_REFINE : INTERVAL_BREAK;
+}
+
+/* ____________________________________________________________________________
+    static int classify_all(const Sampler *s, int i)
+
+    Combines the classifications of interval i for all curves. Refinement
+    takes precedence, a break is only inserted once no curve needs the
+    interval refined.
+   ____________________________________________________________________________
+*/
+static int classify_all(const Sampler *s, int i) {
+    int result = INTERVAL_KEEP;
+    int k;
+
+    for (k = 0; k < s->num_series; k++) {
+        int kind = classify_interval(s, k, i);
+        if (kind == INTERVAL_REFINE) {
+            return INTERVAL_REFINE;
+        }
+        if (kind == INTERVAL_BREAK) {
+            result = INTERVAL_BREAK;
+        }
+    }
+
+    return result;
+}
+
+/* ____________________________________________________________________________
+    static void mark_intervals(Sampler *s)
+
+    Classifies all intervals and adds the curvature marks of all curves.
+   ____________________________________________________________________________
+*/
+static void mark_intervals(Sampler *s) {
+    int i, k;
+
+    for (i = 0; i < s->samples->count - 1; i++) {
+        s->marks[i] = (char)classify_all(s, i);
+    }
+    for (k = 0; k < s->num_series; k++) {
+        mark_curvature(s, k);
+    }
+}
+
+/* ____________________________________________________________________________
+    static void mark_curvature(const Sampler *s, int k)
+
+    Marks both intervals around every sample of curve k that lies further
+    than SAMPLER_TOLERANCE from the segment joining its neighbours.
+   ____________________________________________________________________________
+*/
+static void mark_curvature(const Sampler *s, int k) {
+    const SampleSet *samples = s->samples;
+    int ns = s->num_series;
+    int i;
+
+    for (i = 1; i < samples->count - 1; i++) {
+        double y0 = samples->y[(i - 1) * ns + k], y1 = samples->y[i * ns + k];
+        double y2 = samples->y[(i + 1) * ns + k];
+        double px0, px1, px2, py0, py1, py2, dx, dy, length, distance;
+
+        if (y0 != y0 || y1 != y1 || y2 != y2) {
+            continue;
+        }
+
+        py0 = plot_y(s, y0);
+        py1 = plot_y(s, y1);
+        py2 = plot_y(s, y2);
+        if (outside_same_side(s, py0, py1) && outside_same_side(s, py1, py2)) {
+            continue;
+        }
+
+        px0 = (samples->x[i - 1] - s->min_x) * s->x_scale;
+        px1 = (samples->x[i] - s->min_x) * s->x_scale;
+        px2 = (samples->x[i + 1] - s->min_x) * s->x_scale;
+
+        /* Distance of the middle sample from the chord of its neighbours */
+        dx = px2 - px0;
+        dy = py2 - py0;
+        length = sqrt(dx * dx + dy * dy);
+        if (length <= 0) {
+            continue;
+        }
+        distance = fabs(dx * (py1 - py0) - dy * (px1 - px0)) / length;
+        if (distance <= SAMPLER_TOLERANCE) {
+            continue;
+        }
+
+        if (s->marks[i - 1] == INTERVAL_KEEP && px1 - px0 > SAMPLER_MIN_STEP) {
+            s->marks[i - 1] = INTERVAL_REFINE;
+        }
+        if (s->marks[i] == INTERVAL_KEEP && px2 - px1 > SAMPLER_MIN_STEP) {
+            s->marks[i] = INTERVAL_REFINE;
+        }
+    }
+}
+
+/* ____________________________________________________________________________
+    static int collect_midpoints(Sampler *s, char kind)
+
+    Stores the midpoints of all intervals of the given kind in increasing
+    order and returns their number.
+   ____________________________________________________________________________
+*/
+static int collect_midpoints(Sampler *s, char kind) {
+    const SampleSet *samples = s->samples;
+    int i, m = 0;
+
+    for (i = 0; i < samples->count - 1; i++) {
+        if (s->marks[i] == kind) {
+            double x0 = samples->x[i], x1 = samples->x[i + 1];
+            s->mid_x[m++] = x0 + (x1 - x0) / 2;
+        }
+    }
+
+    return m;
+}
+
+/* ____________________________________________________________________________
+    static void insert_midpoints(Sampler *s, char kind, int m)
+
+    Merges m collected midpoints into the sample arrays.
+
+    Merge Strategy:
+    - Walk from the end, so samples are moved in place at most once
+    - The arrays must already have room for count + m samples
+   ____________________________________________________________________________
+*/
+static void insert_midpoints(Sampler *s, char kind, int m) {
+    SampleSet *samples = s->samples;
+    size_t row = s->num_series * sizeof(double);
+    int ns = s->num_series;
+    int i = samples->count - 1;
+    int j = samples->count + m - 1;
+    int k = m - 1;
+
+    for (; i >= 0; i--) {
+        samples->x[j] = samples->x[i];
+        memmove(samples->y + j * ns, samples->y + i * ns, row);
+        j--;
+
+        if (i > 0 && s->marks[i - 1] == kind) {
+            samples->x[j] = s->mid_x[k];
+            memcpy(samples->y + j * ns, s->mid_y + k * ns, row);
+            j--;
+            k--;
+        }
+    }
+
+    samples->count += m;
+}
@@ -0,0 +1,129 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header sampler.h
+
+    Adaptive sampling of compiled expressions for plotting.
+    Instead of evaluating the function on a fixed dense grid, the sampler
+    starts from a coarse grid and repeatedly bisects only the intervals
+    where a straight segment would not represent the curve on the page.
+
+    Key Features:
+    - Refinement measured in plot units (points of the output page)
+    - Subdivision where the curve bends or neighbouring samples are far
+      apart vertically
+    - Bisection of domain boundaries and discontinuities (tan, ln near 0)
+    - Explicit path breaks at localized jumps
+    - Batched evaluation of every refinement pass
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "parser.h"  /* Compiled program representation */
+
+/*
+  Sampling limits
+  Distances are given in plot units, i.e. in the same units as the width
+  and height of the plotted area.
+*/
+#define SAMPLER_INITIAL_STEP  4.0     /* Spacing of the initial grid */
+#define SAMPLER_MIN_STEP      0.25    /* Finest spacing for curved parts */
+#define SAMPLER_GAP_STEP      1.0     /* Finest spacing for steep parts */
+#define SAMPLER_MIN_BISECT    1e-6    /* Finest spacing for discontinuities */
+#define SAMPLER_TOLERANCE     0.25    /* Allowed deviation from a segment */
+#define SAMPLER_MAX_GAP       2.0     /* Allowed vertical step per segment */
+#define SAMPLER_JUMP_RATIO    4.0     /* Slope ratio treated as a jump */
+#define SAMPLER_MAX_PASSES    40      /* Maximum number of refinement passes */
+#define SAMPLER_MAX_POINTS    65536   /* Maximum number of samples */
+#define SAMPLER_CULL_BLOCK    8       /* Grid intervals tested at once */
+
+/*
+  Plotting window
+  Visible part of the plane and its size on the page.
+
+  Members:
+  min_x, max_x - Sampled range of x
+  min_y, max_y - Visible range of y, parts outside are not refined
+  width        - Width of the plot in plot units
+  height       - Height of the plot in plot units
+*/
+typedef struct {
+    double min_x, max_x;     /* Sampled range */
+    double min_y, max_y;     /* Visible range */
+    int width, height;       /* Plot size */
+} SampleWindow;
+
+/*
+  Set of samples
+  Samples ordered by increasing x. Programs compiled from several
+  expressions have one value per expression at every sample.
+
+  Members:
+  x               - Sample coordinates
+  y               - Sample values, NaN for undefined samples and breaks;
+                    value k of sample i is y[i * num_series + k]
+  num_series      - Number of values per sample
+  count           - Number of samples
+  capacity        - Allocated number of samples
+  num_undefined   - Number of evaluated values that were undefined
+  num_evaluations - Number of evaluated samples
+*/
+typedef struct {
+    double *x;             /* Increasing x coordinates */
+    double *y;             /* Function values */
+    int num_series;        /* Values per sample */
+    int count;             /* Number of samples */
+    int capacity;          /* Allocated samples */
+    int num_undefined;     /* Undefined evaluated samples */
+    int num_evaluations;   /* Evaluated samples */
+} SampleSet;
+
+/*
+  Samples a compiled expression adaptively over a window
+
+  Parameters:
+  prog        - Pointer to program produced by compile_expression()
+  window      - Plotting window
+  num_threads - Maximum number of evaluation threads, 1 for serial
+  samples     - Output sample set, zero-initialized by the function
+
+  Returns:
+  int - 1 on success
+        0 on invalid parameters or memory allocation failure
+
+  Refinement Rules:
+  - Blocks of SAMPLER_CULL_BLOCK grid intervals whose enclosures lie
+    completely outside the window are not sampled inside
+  - An interval with one defined and one undefined end is bisected
+    until the domain boundary is found within SAMPLER_MIN_BISECT
+  - A visible interval whose ends differ by more than SAMPLER_MAX_GAP
+    vertically is bisected down to SAMPLER_GAP_STEP
+  - Below that, an interval much steeper than both its neighbours
+    (SAMPLER_JUMP_RATIO) is a jump, it is bisected down to
+    SAMPLER_MIN_BISECT and a NaN break is inserted there, unless the
+    interval arithmetic shows the curve is continuous over it
+  - Intervals next to a sample further than SAMPLER_TOLERANCE from the
+    segment joining its neighbours are bisected down to SAMPLER_MIN_STEP
+  - With several expressions an interval is bisected when any of them
+    needs it, breaks are inserted only into the curves that jump
+
+  Memory Management:
+  - The sample arrays must be released with free_samples()
+*/
+int sample_function(const Program *prog, const SampleWindow *window,
+                    int num_threads, SampleSet *samples);
+
+/*
+  Releases the arrays of a sample set
+  Safe to call on zero-initialized sets.
+*/
+void free_samples(SampleSet *samples);
+
+#endif /* SAMPLER_H */
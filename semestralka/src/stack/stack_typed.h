@@ -0,0 +1,177 @@
+/* ____________________________________________________________________________
+    Mathematical Expression Parser
+    Version 1.0
+    Header stack_typed.h
+
+    Stacks of one item type generated by a macro, the typed counterpart
+    of the generic stack in stack.h.
+
+    Key Features:
+    - Items are stored in a typed array and passed by value, no memcpy()
+      of a run-time item size
+    - All functions are static and inlined, so the compiler can keep the
+      top of the stack in registers
+    - Caller-provided storage and growth like the generic stack
+
+    Usage:
+    - STACK_DEFINE(double, dstack) defines struct dstack together with
+      dstack_init(), dstack_push(), dstack_pop() and the other functions
+    - Items of a size known only at run time use stack.h
+
+    Dialect: ANSI C (GNU C inline functions where available)
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+____________________________________________________________________________ */
+
+#ifndef STACK_TYPED_H
+#define STACK_TYPED_H
+
+#include <stddef.h>  /* Definitions for size_t and NULL */
+#include <stdlib.h>  /* General utilities and memory management */
+#include <string.h>  /* String manipulation functions */
+
+/* 
+    Storage class of the generated functions
+    ANSI C has no inline keyword, GCC and Clang accept __inline__ even
+    with -ansi; other compilers get plain static functions.
+*/
+#if defined(__GNUC__)
+#define STACK_INLINE static __inline__
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define STACK_INLINE static inline
+#else
+#define STACK_INLINE static
+#endif
+
+/* ____________________________________________________________________________
+    Macro: STACK_DEFINE
+
+    Defines struct name holding items of the given type and its functions.
+    They mean and return the same as their generic counterparts, items
+    are passed by value instead of by pointer.
+
+    Generated Functions:
+    - name_init(s, capacity):             allocates room for capacity items
+    - name_init_buffer(s, buf, capacity): uses storage of the caller,
+                                          which is never freed
+    - name_reserve(s, capacity):          grows the stack, never shrinks it
+    - name_clear(s), name_count(s):       empties / counts the stack
+    - name_push(s, value):                1 on success, 0 if full
+    - name_pop(s, &value), name_head(s, &value): 1 on success, 0 if empty
+    - name_deinit(s):                     releases owned storage
+
+    Usage Requirements:
+    - Use once per name and translation unit
+    - The type must be assignable with =
+____________________________________________________________________________ */
+#define STACK_DEFINE(type, name)                                                    \
+    struct name {                                                                   \
+        size_t capacity;    /* Maximum number of items */                           \
+        size_t sp;          /* Number of items on the stack */                      \
+        type *items;        /* Array of items */                                    \
+        int external;       /* Nonzero if the array belongs to the caller */        \
+    };                                                                              \
+                                                                                    \
+    STACK_INLINE int name##_init(struct name *s, size_t capacity) {                 \
+        if (!s || capacity == 0) {                                                  \
+            return 0;                                                               \
+        }                                                                           \
+        s->items = (type *)malloc(capacity * sizeof(type));                         \
+        if (!s->items) {                                                            \
+            return 0;                                                               \
+        }                                                                           \
+        s->capacity = capacity;                                                     \
+        s->sp = 0;                                                                  \
+        s->external = 0;                                                            \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_init_buffer(struct name *s, type *buffer,               \
+                                        size_t capacity) {                          \
+        if (!s || !buffer || capacity == 0) {                                       \
+            return 0;                                                               \
+        }                                                                           \
+        s->items = buffer;                                                          \
+        s->capacity = capacity;                                                     \
+        s->sp = 0;                                                                  \
+        s->external = 1;                                                            \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE void name##_deinit(struct name *s) {                               \
+        if (!s) {                                                                   \
+            return;                                                                 \
+        }                                                                           \
+        if (!s->external) {                                                         \
+            free(s->items);                                                         \
+        }                                                                           \
+        s->items = NULL;                                                            \
+        s->capacity = 0;                                                            \
+        s->sp = 0;                                                                  \
+        s->external = 0;                                                            \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_reserve(struct name *s, size_t capacity) {              \
+        type *items;                                                                \
+        if (!s || !s->items) {                                                      \
+            return 0;                                                               \
+        }                                                                           \
+        if (capacity <= s->capacity) {                                              \
+            return 1;                                                               \
+        }                                                                           \
+        if (s->external) {                                                          \
+            items = (type *)malloc(capacity * sizeof(type));                        \
+            if (items) {                                                            \
+                memcpy(items, s->items, s->sp * sizeof(type));                      \
+            }                                                                       \
+        }                                                                           \
+        else {                                                                      \
+            items = (type *)realloc(s->items, capacity * sizeof(type));             \
+        }                                                                           \
+        if (!items) {                                                               \
+            return 0;                                                               \
+        }                                                                           \
+        s->items = items;                                                           \
+        s->capacity = capacity;                                                     \
+        s->external = 0;                                                            \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE void name##_clear(struct name *s) {                                \
+        s->sp = 0;                                                                  \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE size_t name##_count(const struct name *s) {                        \
+        return s->sp;                                                               \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_push(struct name *s, type value) {                      \
+        if (s->sp == s->capacity) {                                                 \
+            return 0;                                                               \
+        }                                                                           \
+        s->items[s->sp++] = value;                                                  \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_pop(struct name *s, type *value) {                      \
+        if (s->sp == 0) {                                                           \
+            return 0;                                                               \
+        }                                                                           \
+        s->sp--;                                                                    \
+        if (value) {                                                                \
+            *value = s->items[s->sp];                                               \
+        }                                                                           \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_head(const struct name *s, type *value) {               \
+        if (s->sp == 0 || !value) {                                                 \
+            return 0;                                                               \
+        }                                                                           \
+        *value = s->items[s->sp - 1];                                               \
+        return 1;                                                                   \
+    }
+
+#endif /* STACK_TYPED_H */
@@ -0,0 +1,302 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module stream.c
+
+    Streaming plot pipeline.
+
+    Implementation Details:
+    - A ring of STREAM_RING_SIZE chunks is allocated once, every chunk
+      holds the x coordinates and values of STREAM_CHUNK_SIZE samples
+    - The producer owns the chunks between head and tail, the consumer
+      the filled ones; only the indices are guarded by the mutex, the
+      chunks themselves are filled and drawn outside of it
+    - Chunks are drawn in the order they were produced, so the curves
+      see the samples in increasing x
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#include <pthread.h>    /* Producer thread and ring synchronization */
+#include "stream.h"
+#include "evaluator.h"  /* Batched evaluation of samples */
+
+/*
+  Chunk of samples
+  One slot of the ring buffer.
+*/
+typedef struct {
+    double *x;             /* Sample coordinates */
+    double *y;             /* Values, num_series per sample */
+    char *defined;         /* Definition flags of the values */
+    int count;             /* Number of samples */
+} StreamChunk;
+
+/*
+  Pipeline context
+  Ring buffer and the state shared by the producer and the consumer.
+*/
+typedef struct {
+    const Program *prog;       /* Evaluated program */
+    double min_x, max_x;       /* Sampled range */
+    int num_points;            /* Total number of samples */
+    int num_series;            /* Values per sample */
+    int num_threads;           /* Evaluation threads per chunk */
+    int next_sample;           /* First sample of the next chunk */
+    int num_undefined;         /* Undefined values produced so far */
+    StreamChunk ring[STREAM_RING_SIZE];
+    int head;                  /* Next chunk to be filled */
+    int tail;                  /* Next chunk to be drawn */
+    int filled;                /* Chunks waiting to be drawn */
+    int finished;              /* Producer has stopped */
+    int failed;                /* Evaluation failed */
+    pthread_mutex_t lock;      /* Guards head, tail, filled, finished */
+    pthread_cond_t not_empty;  /* Signalled when a chunk is filled */
+    pthread_cond_t not_full;   /* Signalled when a chunk is drawn */
+} Pipeline;
+
+/* Internal function prototypes */
+static int allocate_ring(Pipeline *p);
+static void free_ring(Pipeline *p);
+static int fill_chunk(Pipeline *p, StreamChunk *chunk);
+static void *producer(void *arg);
+static void consume(Pipeline *p, PsStream *stream);
+
+/* ____________________________________________________________________________
+    int stream_plot(const Program *prog, const GraphParams *params,
+                    const char *output_file, int num_points,
+                    int num_threads, int *num_undefined)
+
+    Plots a program through the producer/consumer pipeline.
+
+    Processing Steps:
+    - Open the graph, so an unwritable file fails before any evaluation
+    - Start the producer thread filling the ring
+    - Draw the chunks in the calling thread as they arrive
+    - Join the producer and finish the graph
+   ____________________________________________________________________________
+*/
+int stream_plot(const Program *prog, const GraphParams *params,
+                const char *output_file, int num_points, int num_threads,
+                int *num_undefined) {
+    Pipeline p;
+    PsStream *stream;
+    pthread_t thread;
+    int result;
+
+    if (num_undefined) {
+        *num_undefined = 0;
+    }
+    if (!prog || !params || num_points < 2 ||
+        params->num_series != (prog->num_outputs > 0 ? prog->num_outputs : 1)) {
+        return ERROR_INVALID_PARAMS;
+    }
+
+    memset(&p, 0, sizeof(p));
+    p.prog = prog;
+    p.min_x = params->min_x;
+    p.max_x = params->max_x;
+    p.num_points = num_points;
+    p.num_series = params->num_series;
+    p.num_threads = num_threads;
+
+    if (!allocate_ring(&p)) {
+        free_ring(&p);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    result = ps_stream_open(&stream, params, output_file);
+    if (result != 0) {
+        free_ring(&p);
+        return result;
+    }
+
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.not_empty, NULL);
+    pthread_cond_init(&p.not_full, NULL);
+
+    if (pthread_create(&thread, NULL, producer, &p) == 0) {
+        consume(&p, stream);
+        pthread_join(thread, NULL);
+    } else {
+        /* No producer thread, fill and draw one chunk at a time */
+        while (fill_chunk(&p, &p.ring[0])) {
+            ps_stream_points(stream, p.ring[0].x, p.ring[0].y,
+                             p.ring[0].count);
+        }
+    }
+
+    pthread_cond_destroy(&p.not_full);
+    pthread_cond_destroy(&p.not_empty);
+    pthread_mutex_destroy(&p.lock);
+
+    result = ps_stream_close(stream);
+    if (p.failed) {
+        result = ERROR_MEMORY_ALLOCATION;
+    }
+    if (num_undefined) {
+        *num_undefined = p.num_undefined;
+    }
+
+    free_ring(&p);
+    return result;
+}
+
+/* ____________________________________________________________________________
+    static int allocate_ring(Pipeline *p)
+
+    Allocates the arrays of all chunks.
+   ____________________________________________________________________________
+*/
+static int allocate_ring(Pipeline *p) {
+    size_t values = (size_t)STREAM_CHUNK_SIZE * p->num_series;
+    int i;
+
+    for (i = 0; i < STREAM_RING_SIZE; i++) {
+        StreamChunk *chunk = &p->ring[i];
+
+        chunk->x = malloc(STREAM_CHUNK_SIZE * sizeof(double));
+        chunk->y = malloc(values * sizeof(double));
+        chunk->defined = malloc(values);
+        if (!chunk->x || !chunk->y || !chunk->defined) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    static void free_ring(Pipeline *p)
+
+    Releases the arrays of all chunks, also partially allocated ones.
+   ____________________________________________________________________________
+*/
+static void free_ring(Pipeline *p) {
+    int i;
+
+    for (i = 0; i < STREAM_RING_SIZE; i++) {
+        free(p->ring[i].x);
+        free(p->ring[i].y);
+        free(p->ring[i].defined);
+    }
+}
+
+/* ____________________________________________________________________________
+    static int fill_chunk(Pipeline *p, StreamChunk *chunk)
+
+    Evaluates the next chunk of samples.
+
+    Returns:
+    int - 1 if the chunk was filled
+          0 when all samples were produced or evaluation failed
+   ____________________________________________________________________________
+*/
+static int fill_chunk(Pipeline *p, StreamChunk *chunk) {
+    int first = p->next_sample;
+    int count = p->num_points - first;
+    int i;
+
+    if (count <= 0 || p->failed) {
+        return 0;
+    }
+    if (count > STREAM_CHUNK_SIZE) {
+        count = STREAM_CHUNK_SIZE;
+    }
+
+    for (i = 0; i < count; i++) {
+        chunk->x[i] = p->min_x + (p->max_x - p->min_x) *
+                      ((double)(first + i) / (p->num_points - 1));
+    }
+
+    if (!evaluate_expression_points_parallel(p->prog, chunk->x, count,
+                                             chunk->y, chunk->defined,
+                                             p->num_threads)) {
+        p->failed = 1;
+        return 0;
+    }
+    for (i = 0; i < count * p->num_series; i++) {
+        if (!chunk->defined[i]) {
+            p->num_undefined++;
+        }
+    }
+
+    chunk->count = count;
+    p->next_sample = first + count;
+    return 1;
+}
+
+/* ____________________________________________________________________________
+    static void *producer(void *arg)
+
+    Thread entry point, fills chunks until all samples are produced.
+    Waits while every chunk of the ring is waiting to be drawn.
+   ____________________________________________________________________________
+*/
+static void *producer(void *arg) {
+    Pipeline *p = arg;
+
+    for (;;) {
+        StreamChunk *chunk;
+
+        pthread_mutex_lock(&p->lock);
+        while (p->filled == STREAM_RING_SIZE) {
+            pthread_cond_wait(&p->not_full, &p->lock);
+        }
+        chunk = &p->ring[p->head];
+        pthread_mutex_unlock(&p->lock);
+
+        if (!fill_chunk(p, chunk)) {
+            break;
+        }
+
+        pthread_mutex_lock(&p->lock);
+        p->head = (p->head + 1) % STREAM_RING_SIZE;
+        p->filled++;
+        pthread_cond_signal(&p->not_empty);
+        pthread_mutex_unlock(&p->lock);
+    }
+
+    pthread_mutex_lock(&p->lock);
+    p->finished = 1;
+    pthread_cond_signal(&p->not_empty);
+    pthread_mutex_unlock(&p->lock);
+
+    return NULL;
+}
+
+/* ____________________________________________________________________________
+    static void consume(Pipeline *p, PsStream *stream)
+
+    Draws filled chunks until the producer has stopped and the ring is
+    empty.
+   ____________________________________________________________________________
+*/
+static void consume(Pipeline *p, PsStream *stream) {
+    for (;;) {
+        const StreamChunk *chunk;
+
+        pthread_mutex_lock(&p->lock);
+        while (p->filled == 0 && !p->finished) {
+            pthread_cond_wait(&p->not_empty, &p->lock);
+        }
+        if (p->filled == 0) {
+            pthread_mutex_unlock(&p->lock);
+            break;
+        }
+        chunk = &p->ring[p->tail];
+        pthread_mutex_unlock(&p->lock);
+
+        ps_stream_points(stream, chunk->x, chunk->y, chunk->count);
+
+        pthread_mutex_lock(&p->lock);
+        p->tail = (p->tail + 1) % STREAM_RING_SIZE;
+        p->filled--;
+        pthread_cond_signal(&p->not_full);
+        pthread_mutex_unlock(&p->lock);
+    }
+}
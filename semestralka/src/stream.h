@@ -0,0 +1,62 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header stream.h
+
+    Streaming plot pipeline for very dense uniform sampling.
+    Samples are evaluated chunk by chunk by a producer thread and passed
+    through a bounded ring buffer to the PostScript writer, which runs in
+    the calling thread. The full array of samples is never allocated.
+
+    Key Features:
+    - Constant memory regardless of the number of samples
+    - Evaluation overlaps with number formatting and disk writes
+    - Producer blocks when the ring is full, consumer when it is empty
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "parser.h"      /* Compiled program representation */
+#include "postscript.h"  /* Graph layout and streamed output */
+
+/* Samples per chunk and number of chunks in the ring */
+#define STREAM_CHUNK_SIZE 8192
+#define STREAM_RING_SIZE  4
+
+/*
+  Plots a program on a uniform grid through the streaming pipeline
+
+  Parameters:
+  prog          - Program produced by compile_expression() or
+                  compile_expressions()
+  params        - Graph layout, one series per program output; the
+                  point arrays are not used
+  output_file   - Path of the PostScript file
+  num_points    - Number of samples over [params->min_x, params->max_x],
+                  both ends included, at least 2
+  num_threads   - Maximum number of threads evaluating one chunk
+  num_undefined - Receives the number of undefined values, may be NULL
+
+  Returns:
+  int - 0 on success
+        ERROR_INVALID_PARAMS, ERROR_FILE_OPERATION or
+        ERROR_MEMORY_ALLOCATION of postscript.h on failure
+
+  Notes:
+  - Sample i lies at min_x + (max_x - min_x) * i / (num_points - 1),
+    the spacing generate_postscript_graph() assumes for uniform data
+  - The producer thread falls back to the calling thread, alternating
+    with the writer, when it cannot be started
+*/
+int stream_plot(const Program *prog, const GraphParams *params,
+                const char *output_file, int num_points, int num_threads,
+                int *num_undefined);
+
+#endif /* STREAM_H */
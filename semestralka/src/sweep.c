@@ -0,0 +1,151 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Module sweep.c
+
+    Parameter sweeps written as multi-page PostScript documents.
+
+    Implementation Details:
+    - The samples of x are computed once, with the formula of the
+      streaming pipeline, so a frame equals a streamed plot
+    - The invariant program fills the input columns once, its values are
+      kept as computed, infinities included
+    - Every frame only sets the swept variable in a copy of the frame
+      program and evaluates it into the same arrays, the page is
+      written before the next frame overwrites them
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#include "sweep.h"
+#include "evaluator.h"  /* Evaluation with input columns */
+
+/* ____________________________________________________________________________
+    int sweep_plot(const Program *invariant, const Program *frame,
+                   const SweepRange *sweep, const GraphParams *params,
+                   const char *output_file, int num_points,
+                   int num_threads, int *num_undefined)
+
+    Plots every frame of a sweep as one page.
+
+    Processing Steps:
+    - Sample x and evaluate the invariant program for all samples
+    - Open the document, so an unwritable file fails before the frames
+      are evaluated
+    - For every frame set the swept variable, evaluate the frame
+      program and write the page
+   ____________________________________________________________________________
+*/
+int sweep_plot(const Program *invariant, const Program *frame,
+               const SweepRange *sweep, const GraphParams *params,
+               const char *output_file, int num_points, int num_threads,
+               int *num_undefined) {
+    GraphSeries series[MAX_PROGRAM_OUTPUTS];
+    GraphParams page;
+    Program current;
+    PsDocument *doc;
+    double *x, *inputs = NULL, *values;
+    char *defined;
+    char caption[MAX_FUNCTION_NAME_LEN + 64];
+    int num_series, num_inputs, result, f, i, k;
+
+    if (num_undefined) {
+        *num_undefined = 0;
+    }
+    if (!invariant || !frame || !sweep || !params || num_points < 2 ||
+        sweep->num_frames < 1 || sweep->slot <= VAR_X ||
+        sweep->slot >= MAX_VARIABLES) {
+        return ERROR_INVALID_PARAMS;
+    }
+    num_series = frame->num_outputs > 0 ? frame->num_outputs : 1;
+    num_inputs = frame->num_inputs;
+    if (params->num_series != num_series || num_series > MAX_PROGRAM_OUTPUTS ||
+        num_inputs != (invariant->code ? invariant->num_outputs : 0)) {
+        return ERROR_INVALID_PARAMS;
+    }
+
+    x = malloc((size_t)num_points * sizeof(double));
+    values = malloc((size_t)num_points * num_series * sizeof(double));
+    defined = malloc((size_t)num_points * num_series);
+    if (num_inputs > 0) {
+        inputs = malloc((size_t)num_points * num_inputs * sizeof(double));
+    }
+    if (!x || !values || !defined || (num_inputs > 0 && !inputs)) {
+        free(x);
+        free(values);
+        free(defined);
+        free(inputs);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    for (i = 0; i < num_points; i++) {
+        x[i] = params->min_x + (params->max_x - params->min_x) *
+               ((double)i / (num_points - 1));
+    }
+
+    result = 0;
+    if (num_inputs > 0 &&
+        !evaluate_expression_points_raw(invariant, x, num_points, inputs,
+                                        num_threads)) {
+        result = ERROR_MEMORY_ALLOCATION;
+    }
+    if (result == 0) {
+        result = ps_document_open(&doc, params, output_file);
+    }
+    if (result != 0) {
+        free(x);
+        free(values);
+        free(defined);
+        free(inputs);
+        return result;
+    }
+
+    page = *params;
+    for (k = 0; k < num_series; k++) {
+        series[k] = params->series[k];
+        series[k].points = values + k;
+        series[k].stride = num_series;
+    }
+    page.series = series;
+    page.x_coords = x;
+    page.num_points = num_points;
+
+    current = *frame;
+    for (f = 0; f < sweep->num_frames && result == 0; f++) {
+        double value = (sweep->num_frames > 1) ?
+                       sweep->from + (sweep->to - sweep->from) *
+                       ((double)f / (sweep->num_frames - 1)) : sweep->from;
+
+        current.variables[sweep->slot] = value;
+        if (!evaluate_expression_points_inputs(&current, x, num_points,
+                                               inputs, values, defined,
+                                               num_threads)) {
+            result = ERROR_MEMORY_ALLOCATION;
+            break;
+        }
+        if (num_undefined) {
+            for (i = 0; i < num_points * num_series; i++) {
+                if (!defined[i]) {
+                    (*num_undefined)++;
+                }
+            }
+        }
+
+        sprintf(caption, "%s = %g", variable_name(sweep->slot), value);
+        result = ps_document_page(doc, &page, caption);
+    }
+
+    if (ps_document_close(doc) != 0 && result == 0) {
+        result = ERROR_FILE_OPERATION;
+    }
+
+    free(x);
+    free(values);
+    free(defined);
+    free(inputs);
+    return result;
+}
@@ -0,0 +1,79 @@
+/*
+    Mathematical Expression Parser
+    Version 1.0
+    Header sweep.h
+
+    Parameter sweeps written as multi-page PostScript documents.
+    One variable of the expressions takes a sequence of values, every
+    value is one page (frame) of the document. The samples of x are the
+    same on every page, so everything that does not depend on the swept
+    variable is evaluated only once for all frames.
+
+    Key Features:
+    - Programs split by compile_sweep() into an invariant and a frame
+      part; the invariant part runs once, the frame part once per frame
+    - One process and one file for the whole sweep
+    - Every page is captioned with the value of the swept variable
+
+    Dialect: ANSI C
+    Compiler: Any ANSI C-compatible compiler
+
+    Copyright (c) Jiří Joska, 2026
+    Provided "AS IS" with NO WARRANTY OF ANY KIND
+*/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "parser.h"      /* Compiled program representation */
+#include "postscript.h"  /* Graph layout and multi-page output */
+
+/*
+  Swept variable
+
+  Members:
+  slot       - Variable slot of the swept variable, not VAR_X
+  from, to   - Values of the first and the last frame
+  num_frames - Number of frames, the values are evenly spaced; a single
+               frame takes the value from
+*/
+typedef struct {
+    int slot;           /* Swept variable */
+    double from, to;    /* Values of the first and last frame */
+    int num_frames;     /* Number of frames */
+} SweepRange;
+
+/*
+  Plots a sweep into a multi-page document
+
+  Parameters:
+  invariant     - Invariant program of compile_sweep(), may be empty
+  frame         - Frame program of compile_sweep(); its variables hold
+                  the values of the fixed variables
+  sweep         - Swept variable and its values
+  params        - Graph layout, one series per frame program output;
+                  the point arrays are not used
+  output_file   - Path of the PostScript file
+  num_points    - Number of samples over [params->min_x, params->max_x],
+                  both ends included, at least 2
+  num_threads   - Maximum number of threads evaluating one frame
+  num_undefined - Receives the number of undefined values of all frames,
+                  may be NULL
+
+  Returns:
+  int - 0 on success
+        ERROR_INVALID_PARAMS, ERROR_FILE_OPERATION or
+        ERROR_MEMORY_ALLOCATION of postscript.h on failure
+
+  Notes:
+  - Frame f is identical to a plot of num_points uniform samples with
+    the swept variable set to its value, see stream_plot()
+  - Memory use is num_points times the number of outputs of both
+    programs, independent of the number of frames
+*/
+int sweep_plot(const Program *invariant, const Program *frame,
+               const SweepRange *sweep, const GraphParams *params,
+               const char *output_file, int num_points, int num_threads,
+               int *num_undefined);
+
+#endif /* SWEEP_H */
@@ -1,28 +1,48 @@
 #include "operators.h"
 
 #include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+/* SSE2 zpracuje dvojici čísel typu double (tedy calc_num_type) jednou instrukcí. */
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CALC_SSE2 1
+#else
+#define CALC_SSE2 0
+#endif
 
 /** @brief Pole dostupných operací a konstanta, která udržuje jejich počet. */
 const struct calc_oper_type OPERATORS[] = {
-    { '+', sum },
-    { '-', sub },
-    { '*', mul },
-    { '/', divide }
+    { "+",    CALC_OPER_BINARY, sum,    NULL,        sum_vector },
+    { "-",    CALC_OPER_BINARY, sub,    NULL,        sub_vector },
+    { "*",    CALC_OPER_BINARY, mul,    NULL,        mul_vector },
+    { "/",    CALC_OPER_BINARY, divide, NULL,        divide_vector },
+    { "pow",  CALC_OPER_BINARY, power,  NULL,        NULL },
+    { "sqrt", CALC_OPER_UNARY,  NULL,   square_root, NULL },
+    { "dup",  CALC_OPER_DUP,    NULL,   NULL,        NULL },
+    { "swap", CALC_OPER_SWAP,   NULL,   NULL,        NULL }
 };
 const size_t OPERATORS_COUNT = sizeof(OPERATORS) / sizeof(*OPERATORS);
 
-calc_handler_type get_operator_handler(char operator) {
+const struct calc_oper_type *find_operator(const char *name, size_t length) {
     size_t i;
 
     for (i = 0; i < OPERATORS_COUNT; ++i) {
-        if (OPERATORS[i].operator == operator) {
-            return OPERATORS[i].handler;
+        if (strncmp(OPERATORS[i].name, name, length) == 0 && OPERATORS[i].name[length] == '\0') {
+            return &OPERATORS[i];
         }
     }
 
     return NULL;
 }
 
+calc_handler_type get_operator_handler(char operator) {
+    const struct calc_oper_type *oper = find_operator(&operator, 1);
+
+    return oper ? oper->handler : NULL;
+}
+
 calc_num_type sum(calc_num_type a, calc_num_type b) {
     return a + b;
 }
@@ -38,3 +58,44 @@ calc_num_type mul(calc_num_type a, calc_num_type b) {
 calc_num_type divide(calc_num_type a , calc_num_type b) {
     return a / b;
 }
+
+calc_num_type power(calc_num_type a, calc_num_type b) {
+    return pow(a, b);
+}
+
+calc_num_type square_root(calc_num_type a) {
+    return sqrt(a);
+}
+
+/**
+ * @brief Makro vygeneruje operaci nad poli. Hlavní cyklus zpracuje dvojice čísel instrukcí SSE2 `intrinsic`
+ *        (nezarovnané načtení i uložení, pole tedy nemusí být zarovnaná), zbytek a překlad bez SSE2 obslouží
+ *        skalární cyklus s operátorem `operator`.
+ */
+#if CALC_SSE2
+#define CALC_VECTOR_OPERATION(name, operator, intrinsic)                                \
+    void name(calc_num_type *a, const calc_num_type *b, size_t count) {                 \
+        size_t i = 0;                                                                   \
+                                                                                        \
+        for (; i + 2 <= count; i += 2) {                                                \
+            _mm_storeu_pd(a + i, intrinsic(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));  \
+        }                                                                               \
+        for (; i < count; ++i) {                                                        \
+            a[i] = a[i] operator b[i];                                                  \
+        }                                                                               \
+    }
+#else
+#define CALC_VECTOR_OPERATION(name, operator, intrinsic)                                \
+    void name(calc_num_type *a, const calc_num_type *b, size_t count) {                 \
+        size_t i;                                                                       \
+                                                                                        \
+        for (i = 0; i < count; ++i) {                                                   \
+            a[i] = a[i] operator b[i];                                                  \
+        }                                                                               \
+    }
+#endif
+
+CALC_VECTOR_OPERATION(sum_vector, +, _mm_add_pd)
+CALC_VECTOR_OPERATION(sub_vector, -, _mm_sub_pd)
+CALC_VECTOR_OPERATION(mul_vector, *, _mm_mul_pd)
+CALC_VECTOR_OPERATION(divide_vector, /, _mm_div_pd)
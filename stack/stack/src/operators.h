@@ -8,27 +8,60 @@
 #ifndef OPERATORS_H
 #define OPERATORS_H
 
+#include <stddef.h>
+
 /**
- * \brief Definice datového typu, se kterým funkce pracují. Pokud chcete vidět, jak se toto dělá
- *        lépe a radostněji, tak přijďte na předposlední cvičení.
+ * \brief Definice datového typu, se kterým funkce pracují. Čísla s desetinnou částí a exponentem přečte tokenizér
+ *        (viz `tokenizer.h`), proto je typem `double`.
  */
-typedef int calc_num_type;
+typedef double calc_num_type;
 
 /** \brief Definice datového typu ukazatele na funkci vykonávající aritmetickou operaci. */
 typedef calc_num_type (*calc_handler_type)(calc_num_type, calc_num_type);
 
+/** \brief Definice datového typu ukazatele na funkci s jedním operandem. */
+typedef calc_num_type (*calc_unary_handler_type)(calc_num_type);
+
+/**
+ * \brief Definice datového typu ukazatele na funkci, která provede operaci dvou operandů na celých polích:
+ *        `a[i] = operace(a[i], b[i])` pro `i` od 0 do `count - 1`.
+ */
+typedef void (*calc_vector_handler_type)(calc_num_type *a, const calc_num_type *b, size_t count);
+
+/** \brief Druh operace, tedy co operace se zásobníkem udělá. */
+enum calc_oper_kind {
+    CALC_OPER_BINARY,               /*!< Odebere dva operandy a vloží výsledek `handler`. */
+    CALC_OPER_UNARY,                /*!< Odebere jeden operand a vloží výsledek `unary_handler`. */
+    CALC_OPER_DUP,                  /*!< Zdvojí vrchol zásobníku. */
+    CALC_OPER_SWAP                  /*!< Prohodí dva prvky na vrcholu zásobníku. */
+};
+
 /** \brief Struktura, která obaluje operátor a k němu přidruženou obslužnou funkci. */
 struct calc_oper_type {
-    char operator;                  /*!< Znak, kterým je operace popsána. */
-    calc_handler_type handler;     /*!< Přidružená aritmetická operace. */
+    const char *name;                       /*!< Zápis operace ve výrazu, znak (`+`) nebo slovo (`sqrt`). */
+    enum calc_oper_kind kind;               /*!< Druh operace. */
+    calc_handler_type handler;              /*!< Přidružená aritmetická operace dvou operandů, jinak `NULL`. */
+    calc_unary_handler_type unary_handler;  /*!< Přidružená operace jednoho operandu, jinak `NULL`. */
+    calc_vector_handler_type vector_handler;/*!< Operace dvou operandů nad poli, pokud existuje, jinak `NULL`. */
 };
 
+/**
+ * \brief Funkce vyhledá operaci podle jejího zápisu. Zápis nemusí být ukončený nulovým znakem, takže jej lze
+ *        hledat přímo ve zpracovávaném výrazu.
+ *
+ * \param name Začátek zápisu operace.
+ * \param length Délka zápisu operace.
+ * \return const struct calc_oper_type* Popis operace z pole OPERATORS, nebo `NULL`, pokud operace neexistuje.
+ */
+const struct calc_oper_type *find_operator(const char *name, size_t length);
+
 /**
  * \brief Funkce vrátí ukazatel na obslužnou funkci podle zadaného operátoru. Operátory a k nim
  *        přidružené funkce musejí být uvedeny v poli OPERATORS, které je definováno v souboru .c.
  * 
  * \param operator Operátor, ke kterému je hledána jeho obslužná funkce.
- * \return calc_handler_type Ukazatel na obslužnou funkci, nebo konstanta NULL pokud operátor nebyl nalezen v poli OPERATORS.
+ * \return calc_handler_type Ukazatel na obslužnou funkci, nebo konstanta NULL pokud operátor nebyl nalezen v poli OPERATORS
+ *         nebo nemá dva operandy.
  */
 calc_handler_type get_operator_handler(char operator);
 
@@ -65,4 +98,56 @@ calc_num_type mul(calc_num_type a, calc_num_type b);
  */
 calc_num_type divide(calc_num_type a, calc_num_type b);
 
+/**
+ * \brief Funkce vrátí mocninu zadaných parametrů.
+ * \param a Základ.
+ * \param b Exponent.
+ * \return calc_num_type Mocnina.
+ */
+calc_num_type power(calc_num_type a, calc_num_type b);
+
+/**
+ * \brief Funkce vrátí druhou odmocninu zadaného parametru.
+ * \param a Odmocněnec.
+ * \return calc_num_type Druhá odmocnina, pro záporný parametr NaN.
+ */
+calc_num_type square_root(calc_num_type a);
+
+/*
+ * Operace nad poli, tzn. po složkách. Pod překladačem s SSE2 (např. GCC na x86-64) zpracují dvě čísla jednou
+ * instrukcí, jinak jde o obyčejné cykly. Výsledky jsou v obou případech shodné s funkcemi `sum`, `sub`, `mul`
+ * a `divide`.
+ */
+/**
+ * \brief Funkce sečte pole po složkách, `a[i] += b[i]`.
+ * \param a Sčítance, do kterých se uloží součty.
+ * \param b Sčítance.
+ * \param count Délka polí.
+ */
+void sum_vector(calc_num_type *a, const calc_num_type *b, size_t count);
+
+/**
+ * \brief Funkce odečte pole po složkách, `a[i] -= b[i]`.
+ * \param a Menšence, do kterých se uloží rozdíly.
+ * \param b Menšitele.
+ * \param count Délka polí.
+ */
+void sub_vector(calc_num_type *a, const calc_num_type *b, size_t count);
+
+/**
+ * \brief Funkce vynásobí pole po složkách, `a[i] *= b[i]`.
+ * \param a Činitele, do kterých se uloží součiny.
+ * \param b Činitele.
+ * \param count Délka polí.
+ */
+void mul_vector(calc_num_type *a, const calc_num_type *b, size_t count);
+
+/**
+ * \brief Funkce vydělí pole po složkách, `a[i] /= b[i]`.
+ * \param a Dělence, do kterých se uloží podíly.
+ * \param b Dělitelé.
+ * \param count Délka polí.
+ */
+void divide_vector(calc_num_type *a, const calc_num_type *b, size_t count);
+
 #endif
\ No newline at end of file
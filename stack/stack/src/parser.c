@@ -13,10 +13,29 @@
 
 #include "stack/stack.h"
 #include "operators.h"
+#include "tokenizer.h"
+#include "program.h"
 
 /** @brief Maximální velikost zásobníku a maximální délka vstupu. */
 #define MAX_INPUT_LEN 256
 
+/** @brief Počet operandů, které se vejdou do vloženého bufferu kontextu. Výrazy do `2 * RPN_INLINE_CAPACITY - 1`
+ *         znaků se vyhodnotí bez jediné alokace na haldě. */
+#define RPN_INLINE_CAPACITY 64
+
+/**
+ * @brief Kontext vyhodnocování RPN výrazů, který se používá opakovaně. Zásobník začíná ve vloženém bufferu
+ *        `inline_items` a na haldu se přesune, až když přijde delší výraz. Mezi výrazy se zásobník jen vyprázdní,
+ *        takže jednou dosažená kapacita zůstává k dispozici.
+ *
+ * Kontext není sdílený, každé vlákno si vytvoří vlastní (např. jako lokální proměnnou) a vlákna se pak nepotkají
+ * ani v alokátoru.
+ */
+struct rpn_context {
+    struct num_stack s;                                     /*!< Zásobník operandů. */
+    calc_num_type inline_items[RPN_INLINE_CAPACITY];        /*!< Vložený buffer pro krátké výrazy. */
+};
+
 /**
  * @brief Funkce slouží k vyhodnocení výrazu zapsaného v reverzní polské notaci (RPN).
  * @param input Zpracovávaný výraz.
@@ -194,30 +213,269 @@ int evaluate_rpn_expression_3(const char *input, calc_num_type *result) {
 }
 
 /**
- * @brief Hlavní přístupový bod aplikace pro zpracování postfixových výrazů.
- * @return int Funkce vždy vrací hodnotu `EXIT_SUCCESS`.
+ * @brief Funkce připraví kontext k vyhodnocování, zásobník bude používat vložený buffer. Inicializace nic nealokuje.
+ * @param ctx Ukazatel na inicializovaný kontext.
+ * @return int 1, pokud inicializace proběhla v pořádku, jinak 0.
+ */
+int rpn_context_init(struct rpn_context *ctx) {
+    if (!ctx) {
+        return 0;
+    }
+
+    return num_stack_init_buffer(&ctx->s, ctx->inline_items, RPN_INLINE_CAPACITY);
+}
+
+/**
+ * @brief Funkce uvolní paměť, kterou si kontext alokoval pro dlouhé výrazy.
+ * @param ctx Ukazatel na kontext.
+ */
+void rpn_context_deinit(struct rpn_context *ctx) {
+    if (ctx) {
+        num_stack_deinit(&ctx->s);
+    }
+}
+
+/**
+ * @brief Funkce slouží k vyhodnocení výrazu zapsaného v reverzní polské notaci (RPN) v daném kontextu. Na rozdíl
+ *        od předchozích variant si zásobník nealokuje a po vyhodnocení jej neuvolňuje, pouze ho vyprázdní.
+ *        Jediná alokace nastane, když je výraz delší než dosavadní kapacita zásobníku.
+ *
+ *        Výraz čte tokenizér (viz `tokenizer.h`), operandy tedy mohou být víceciferná a desetinná čísla oddělená
+ *        bílými znaky a operace i slova jako `sqrt` nebo `swap`.
+ * @param ctx Kontext inicializovaný funkcí `rpn_context_init`.
+ * @param input Zpracovávaný výraz.
+ * @param result Ukazatel na paměť, kam bude zkopírován výsledek výrazu.
+ * @return int 1, pokud zpracování proběhlo v pořádku, jinak 0. Kontext zůstává použitelný v obou případech.
+ */
+int evaluate_rpn_expression_ctx(struct rpn_context *ctx, const char *input, calc_num_type *result) {
+    size_t input_length;
+    calc_num_type a, b;
+    struct tokenizer t;
+    struct token token;
+
+    if (!ctx || !input || !result) {
+        return 0;
+    }
+
+    input_length = strlen(input);
+    if (input_length == 0) {
+        return 0;
+    }
+
+    /*
+     * Zásobník prodlužují jen čísla a `dup`, každý o jeden prvek. Dvě čísla za sebou musí oddělit mezera nebo
+     * mít alespoň dva znaky a `dup` má tři, na jeden prvek tedy připadají alespoň dva znaky vstupu (poslední
+     * prvek jen jeden).
+     */
+    num_stack_clear(&ctx->s);
+    if (!num_stack_reserve(&ctx->s, (input_length + 1) / 2)) {
+        return 0;
+    }
+
+    tokenizer_init(&t, input);
+    while (tokenizer_next(&t, &token) != TOKEN_END) {
+        if (token.type == TOKEN_NUMBER) {
+            num_stack_push(&ctx->s, token.value);
+            continue;
+        }
+        if (token.type != TOKEN_OPERATOR) {   /* Nic se neuvolňuje, takže chyba znamená prostě návrat. */
+            return 0;
+        }
+
+        switch (token.oper->kind) {
+            case CALC_OPER_BINARY:
+                if (!num_stack_pop(&ctx->s, &b) || !num_stack_pop(&ctx->s, &a)) {
+                    return 0;
+                }
+                num_stack_push(&ctx->s, token.oper->handler(a, b));
+                break;
+
+            case CALC_OPER_UNARY:
+                if (!num_stack_pop(&ctx->s, &a)) {
+                    return 0;
+                }
+                num_stack_push(&ctx->s, token.oper->unary_handler(a));
+                break;
+
+            case CALC_OPER_DUP:
+                if (!num_stack_head(&ctx->s, &a)) {
+                    return 0;
+                }
+                num_stack_push(&ctx->s, a);
+                break;
+
+            case CALC_OPER_SWAP:
+                if (!num_stack_pop(&ctx->s, &b) || !num_stack_pop(&ctx->s, &a)) {
+                    return 0;
+                }
+                num_stack_push(&ctx->s, b);
+                num_stack_push(&ctx->s, a);
+                break;
+        }
+    }
+
+    if (num_stack_count(&ctx->s) != 1) {
+        return 0;
+    }
+
+    return num_stack_pop(&ctx->s, result);
+}
+
+/**
+ * @brief Funkce přeloží výraz funkcí `rpn_compile`, vykoná jej a vypíše výsledek.
+ * @param input Zpracovávaný výraz.
+ * @return int `EXIT_SUCCESS`, pokud byl výraz vyhodnocen, jinak `EXIT_FAILURE`.
+ */
+int run_expression(const char *input) {
+    struct rpn_program prog = DEFAULT_RPN_PROGRAM;
+    struct num_stack s = {0, 0, NULL, 0};
+    calc_num_type result;
+    int ok;
+
+    if (!rpn_compile(input, &prog)) {
+        printf("syntax error\n");
+        return EXIT_FAILURE;
+    }
+
+    ok = num_stack_init(&s, prog.max_depth) && rpn_execute(&prog, &s, &result);
+    if (ok) {
+        printf("%.15g\n", result);
+    }
+    else printf("out of memory\n");
+
+    num_stack_deinit(&s);
+    rpn_program_free(&prog);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Funkce přeloží výraz s proměnnými, ze standardního vstupu načte řádky jejich hodnot a vypíše výsledek
+ *        pro každý řádek. Řádek obsahuje hodnoty proměnných v pořadí jejich jmen oddělené bílými znaky. Všechny
+ *        řádky se vyhodnotí najednou funkcí `rpn_execute_batch`.
+ * @param input Zpracovávaný výraz.
+ * @param names Jména proměnných.
+ * @param num_names Počet proměnných.
+ * @return int `EXIT_SUCCESS`, pokud byly vyhodnoceny všechny řádky, jinak `EXIT_FAILURE`.
  */
-int main() {
+int run_batch(const char *input, const char *const *names, size_t num_names) {
+    struct rpn_program prog = DEFAULT_RPN_PROGRAM;
+    calc_num_type **columns, *results = NULL;
+    char line[MAX_INPUT_LEN], *cursor, *end;
+    size_t rows = 0, capacity = 0, k;
+    int ok = 1;
+
+    if (!rpn_compile_variables(input, names, num_names, &prog)) {
+        printf("syntax error\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Hodnoty se ukládají po sloupcích, jeden sloupec pro každou proměnnou. */
+    columns = calloc(num_names ? num_names : 1, sizeof(calc_num_type *));
+    if (!columns) {
+        rpn_program_free(&prog);
+        printf("out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    while (ok && fgets(line, MAX_INPUT_LEN, stdin)) {
+        if (rows == capacity) {
+            capacity = capacity ? 2 * capacity : RPN_BATCH_LANES;
+            for (k = 0; ok && k < num_names; ++k) {
+                calc_num_type *column = realloc(columns[k], capacity * sizeof(calc_num_type));
+                if (column) {
+                    columns[k] = column;
+                }
+                else ok = 0;
+            }
+            if (!ok) {
+                printf("out of memory\n");
+                break;
+            }
+        }
+
+        cursor = line;
+        for (k = 0; k < num_names; ++k) {
+            columns[k][rows] = strtod(cursor, &end);
+            if (end == cursor) {
+                break;
+            }
+            cursor = end;
+        }
+        cursor += strspn(cursor, " \t\r\n");
+        if (k < num_names || *cursor != '\000') {
+            printf("row %lu: expected %lu values\n", (unsigned long)(rows + 1), (unsigned long)num_names);
+            ok = 0;
+            break;
+        }
+        ++rows;
+    }
+
+    if (ok && rows > 0) {
+        results = malloc(rows * sizeof(calc_num_type));
+        ok = results && rpn_execute_batch(&prog, (const calc_num_type *const *)columns, rows, results);
+        if (!ok) {
+            printf("out of memory\n");
+        }
+    }
+
+    for (k = 0; ok && k < rows; ++k) {
+        printf("%.15g\n", results[k]);
+    }
+
+    for (k = 0; k < num_names; ++k) {
+        free(columns[k]);
+    }
+    free(columns);
+    free(results);
+    rpn_program_free(&prog);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Hlavní přístupový bod aplikace pro zpracování postfixových výrazů. Bez argumentů čte výrazy ze
+ *        standardního vstupu, jinak vyhodnotí výraz zadaný prvním argumentem, např. `parser "1 2 +"`. Volání
+ *        `parser --batch "x y * 2 +" x y` vyhodnotí výraz pro každý řádek hodnot `x` a `y` ze standardního
+ *        vstupu.
+ * @param argc Počet argumentů.
+ * @param argv Argumenty příkazové řádky.
+ * @return int `EXIT_SUCCESS`, nebo `EXIT_FAILURE`, pokud výraz z argumentů nešel vyhodnotit.
+ */
+int main(int argc, char *argv[]) {
     char input[MAX_INPUT_LEN];
     calc_num_type result;
+    struct rpn_context ctx;
+
+    if (argc > 2 && strcmp(argv[1], "--batch") == 0) {
+        return run_batch(argv[2], (const char *const *)(argv + 3), (size_t)(argc - 3));
+    }
+    if (argc > 1) {
+        return run_expression(argv[1]);
+    }
+
+    /* Jeden kontext pro všechny zadané výrazy, výrazy do 2 * RPN_INLINE_CAPACITY - 1 znaků vystačí s vloženým
+       bufferem. */
+    rpn_context_init(&ctx);
 
     printf("Enter \"quit\" to exit this amazing calculator.\n\n");
 
     for (;;) {
         printf("> ");
-        fgets(input, MAX_INPUT_LEN, stdin);
+        if (!fgets(input, MAX_INPUT_LEN, stdin)) {
+            break;
+        }
         input[strcspn(input, "\r\n")] = '\000';
 
         if (strcmp(input, "quit") == 0) {
             break;
         }
 
-        if (evaluate_rpn_expression_2(input, &result)) {
-            printf("%d\n", result);
+        if (evaluate_rpn_expression_ctx(&ctx, input, &result)) {
+            printf("%.15g\n", result);
         }
         else printf("syntax error\n");
     }
 
+    rpn_context_deinit(&ctx);
     printf("You are leaving an awesome calculator. Be back soon!\n");
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,377 @@
+/**
+ * @file program.c
+ * @author Jiří Joska (github.com/toyotomicz)
+ * @brief Zdrojový kód překladu výrazů v reverzní polské notaci a interpretu přeložených programů.
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "program.h"
+#include "tokenizer.h"
+
+/**
+ * @brief Přepínač interpretu. Adresy návěští (`&&label`) a skok `goto *address` jsou rozšířením GNU C, klíčové
+ *        slovo `__extension__` potlačí varování, která k nim hlásí přepínač `-pedantic`.
+ */
+#if defined(__GNUC__) && !defined(RPN_NO_COMPUTED_GOTO)
+#define RPN_THREADED 1
+#else
+#define RPN_THREADED 0
+#endif
+
+/**
+ * @brief Interpret přeložených programů. Zásobníkem je obyčejné pole, ukazatel `top` ukazuje na první volné
+ *        místo. Překlad ověřil hloubku zásobníku, proto interpret nic nekontroluje.
+ * @param prog Vykonávaný program, nebo `NULL`, pokud se jen zjišťují adresy návěští.
+ * @param stack Pole alespoň `prog->max_depth` prvků.
+ * @param variables Hodnoty vstupních proměnných.
+ * @param result Ukazatel na paměť, kam bude zkopírován výsledek výrazu.
+ * @param labels Je-li nenulový, funkce do něj uloží tabulku adres návěští indexovanou instrukcemi a skončí.
+ * @return int 1 po vykonání programu, jinak 0.
+ */
+static int run(const struct rpn_program *prog, calc_num_type *stack, const calc_num_type *variables,
+               calc_num_type *result, const void *const **labels) {
+    const struct rpn_instruction *ip;
+    calc_num_type *top = stack;
+    calc_num_type temp;
+
+#if RPN_THREADED
+    /* Pořadí odpovídá výčtu rpn_opcode. */
+    static const void *const addresses[] = {
+        __extension__ &&op_push,
+        __extension__ &&op_load,
+        __extension__ &&op_binary,
+        __extension__ &&op_unary,
+        __extension__ &&op_dup,
+        __extension__ &&op_swap,
+        __extension__ &&op_end
+    };
+
+    #define DISPATCH()  __extension__ ({ goto *ip->address; })
+    #define TARGET(op, label) label:
+
+    if (labels) {
+        *labels = addresses;
+        return 0;
+    }
+#else
+    #define DISPATCH()  goto dispatch
+    #define TARGET(op, label) case op:
+
+    if (labels) {
+        *labels = NULL;
+        return 0;
+    }
+#endif
+
+    ip = prog->code;
+
+#if RPN_THREADED
+    DISPATCH();
+#else
+  dispatch:
+    switch (ip->opcode) {
+#endif
+    TARGET(RPN_OP_PUSH, op_push)
+        *top++ = ip->value;
+        ++ip;
+        DISPATCH();
+
+    TARGET(RPN_OP_LOAD, op_load)
+        *top++ = variables[ip->index];
+        ++ip;
+        DISPATCH();
+
+    TARGET(RPN_OP_BINARY, op_binary)
+        top[-2] = ip->handler(top[-2], top[-1]);
+        --top;
+        ++ip;
+        DISPATCH();
+
+    TARGET(RPN_OP_UNARY, op_unary)
+        top[-1] = ip->unary_handler(top[-1]);
+        ++ip;
+        DISPATCH();
+
+    TARGET(RPN_OP_DUP, op_dup)
+        top[0] = top[-1];
+        ++top;
+        ++ip;
+        DISPATCH();
+
+    TARGET(RPN_OP_SWAP, op_swap)
+        temp = top[-1];
+        top[-1] = top[-2];
+        top[-2] = temp;
+        ++ip;
+        DISPATCH();
+
+    TARGET(RPN_OP_END, op_end)
+        *result = top[-1];
+        return 1;
+#if !RPN_THREADED
+    }
+
+    return 0;
+#endif
+
+    #undef DISPATCH
+    #undef TARGET
+}
+
+int rpn_compile(const char *input, struct rpn_program *prog) {
+    return rpn_compile_variables(input, NULL, 0, prog);
+}
+
+int rpn_compile_variables(const char *input, const char *const *names, size_t num_names,
+                          struct rpn_program *prog) {
+    struct tokenizer t;
+    struct token token;
+    const void *const *labels;
+    size_t count = 0, depth = 0;
+    struct rpn_instruction *ins;
+
+    if (!input || !prog) {
+        return 0;
+    }
+
+    prog->code = NULL;
+    prog->length = 0;
+    prog->max_depth = 0;
+    prog->num_variables = num_names;
+
+    /* První průchod jen spočítá tokeny a najde chyby zápisu, program se pak alokuje na míru. */
+    tokenizer_init(&t, input);
+    while (tokenizer_next(&t, &token) != TOKEN_END) {
+        if (token.type == TOKEN_ERROR) {
+            return 0;
+        }
+        ++count;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    prog->code = malloc((count + 1) * sizeof(struct rpn_instruction));
+    if (!prog->code) {
+        return 0;
+    }
+
+    run(NULL, NULL, NULL, NULL, &labels);
+
+    /* Druhý průchod vytvoří instrukce a sleduje hloubku zásobníku. */
+    ins = prog->code;
+    tokenizer_init(&t, input);
+    while (tokenizer_next(&t, &token) != TOKEN_END) {
+        size_t needed = 0;
+
+        ins->value = 0;
+        ins->index = 0;
+        ins->handler = NULL;
+        ins->unary_handler = NULL;
+        ins->vector_handler = NULL;
+
+        if (token.type == TOKEN_NUMBER) {
+            ins->opcode = RPN_OP_PUSH;
+            ins->value = token.value;
+        }
+        else if (token.type == TOKEN_NAME) {
+            /* Proměnných bývá málo, stačí je projít postupně. */
+            for (ins->index = 0; ins->index < num_names; ++ins->index) {
+                if (strncmp(names[ins->index], token.start, token.length) == 0 &&
+                    names[ins->index][token.length] == '\000') {
+                    break;
+                }
+            }
+            if (ins->index == num_names) {
+                rpn_program_free(prog);
+                return 0;
+            }
+            ins->opcode = RPN_OP_LOAD;
+        }
+        else {
+            switch (token.oper->kind) {
+                case CALC_OPER_BINARY:
+                    ins->opcode = RPN_OP_BINARY;
+                    ins->handler = token.oper->handler;
+                    ins->vector_handler = token.oper->vector_handler;
+                    needed = 2;
+                    break;
+
+                case CALC_OPER_UNARY:
+                    ins->opcode = RPN_OP_UNARY;
+                    ins->unary_handler = token.oper->unary_handler;
+                    needed = 1;
+                    break;
+
+                case CALC_OPER_DUP:
+                    ins->opcode = RPN_OP_DUP;
+                    needed = 1;
+                    break;
+
+                case CALC_OPER_SWAP:
+                    ins->opcode = RPN_OP_SWAP;
+                    needed = 2;
+                    break;
+            }
+        }
+
+        if (depth < needed) {
+            rpn_program_free(prog);
+            return 0;
+        }
+
+        switch (ins->opcode) {
+            case RPN_OP_PUSH:
+            case RPN_OP_LOAD:
+            case RPN_OP_DUP:
+                ++depth;
+                break;
+
+            case RPN_OP_BINARY:
+                --depth;
+                break;
+
+            default:
+                break;
+        }
+        if (depth > prog->max_depth) {
+            prog->max_depth = depth;
+        }
+
+        ins->address = labels ? labels[ins->opcode] : NULL;
+        ++ins;
+    }
+
+    if (depth != 1) {
+        rpn_program_free(prog);
+        return 0;
+    }
+
+    ins->opcode = RPN_OP_END;
+    ins->address = labels ? labels[RPN_OP_END] : NULL;
+    ins->value = 0;
+    ins->index = 0;
+    ins->handler = NULL;
+    ins->unary_handler = NULL;
+    ins->vector_handler = NULL;
+
+    prog->length = count + 1;
+    return 1;
+}
+
+int rpn_execute(const struct rpn_program *prog, struct num_stack *stack, calc_num_type *result) {
+    return rpn_execute_variables(prog, stack, NULL, result);
+}
+
+int rpn_execute_variables(const struct rpn_program *prog, struct num_stack *stack,
+                          const calc_num_type *variables, calc_num_type *result) {
+    if (!prog || !prog->code || !stack || !result || (prog->num_variables > 0 && !variables)) {
+        return 0;
+    }
+
+    if (!num_stack_reserve(stack, prog->max_depth)) {
+        return 0;
+    }
+
+    return run(prog, stack->items, variables, result, NULL);
+}
+
+int rpn_execute_batch(const struct rpn_program *prog, const calc_num_type *const *columns, size_t rows,
+                      calc_num_type *results) {
+    const struct rpn_instruction *ip;
+    calc_num_type *workspace, **slots, *a, *b;
+    size_t start, lanes, depth, i;
+
+    if (!prog || !prog->code || !results || (prog->num_variables > 0 && !columns)) {
+        return 0;
+    }
+
+    /* Každé místo zásobníku je blok RPN_BATCH_LANES čísel, zásobník sám je pole ukazatelů na bloky. */
+    workspace = malloc(prog->max_depth * RPN_BATCH_LANES * sizeof(calc_num_type));
+    slots = malloc(prog->max_depth * sizeof(calc_num_type *));
+    if (!workspace || !slots) {
+        free(workspace);
+        free(slots);
+        return 0;
+    }
+    for (i = 0; i < prog->max_depth; ++i) {
+        slots[i] = workspace + i * RPN_BATCH_LANES;
+    }
+
+    for (start = 0; start < rows; start += lanes) {
+        lanes = (rows - start < RPN_BATCH_LANES) ? rows - start : RPN_BATCH_LANES;
+        depth = 0;
+
+        for (ip = prog->code; ip->opcode != RPN_OP_END; ++ip) {
+            switch (ip->opcode) {
+                case RPN_OP_PUSH:
+                    a = slots[depth++];
+                    for (i = 0; i < lanes; ++i) {
+                        a[i] = ip->value;
+                    }
+                    break;
+
+                case RPN_OP_LOAD:
+                    memcpy(slots[depth++], columns[ip->index] + start, lanes * sizeof(calc_num_type));
+                    break;
+
+                case RPN_OP_BINARY:
+                    a = slots[depth - 2];
+                    b = slots[depth - 1];
+                    if (ip->vector_handler) {
+                        ip->vector_handler(a, b, lanes);
+                    }
+                    else {
+                        for (i = 0; i < lanes; ++i) {
+                            a[i] = ip->handler(a[i], b[i]);
+                        }
+                    }
+                    --depth;
+                    break;
+
+                case RPN_OP_UNARY:
+                    a = slots[depth - 1];
+                    for (i = 0; i < lanes; ++i) {
+                        a[i] = ip->unary_handler(a[i]);
+                    }
+                    break;
+
+                case RPN_OP_DUP:
+                    memcpy(slots[depth], slots[depth - 1], lanes * sizeof(calc_num_type));
+                    ++depth;
+                    break;
+
+                case RPN_OP_SWAP:   /* Stačí prohodit ukazatele na bloky. */
+                    a = slots[depth - 1];
+                    slots[depth - 1] = slots[depth - 2];
+                    slots[depth - 2] = a;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        memcpy(results + start, slots[0], lanes * sizeof(calc_num_type));
+    }
+
+    free(workspace);
+    free(slots);
+    return 1;
+}
+
+void rpn_program_free(struct rpn_program *prog) {
+    if (!prog) {
+        return;
+    }
+
+    free(prog->code);
+    prog->code = NULL;
+    prog->length = 0;
+    prog->max_depth = 0;
+    prog->num_variables = 0;
+}
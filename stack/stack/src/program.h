@@ -0,0 +1,132 @@
+/**
+ * \file program.h
+ * \author Jiří Joska (github.com/toyotomicz)
+ * \brief Hlavičkový soubor s překladem výrazů v reverzní polské notaci do předpřipravených programů.
+ *
+ * Výraz, který se vyhodnocuje mnohokrát, stačí jednou přeložit funkcí `rpn_compile`. Překlad výraz rozdělí na
+ * tokeny, vyhledá obslužné funkce operací a zkontroluje, že operace budou mít vždy dost operandů. Program je pak
+ * pole instrukcí s čísly a ukazateli na obslužné funkce a `rpn_execute` jej vykoná bez tokenizace, hledání
+ * v poli OPERATORS a kontrol zásobníku.
+ *
+ * Pod GCC a Clangem interpret skáče přímo na adresy návěští uložené v instrukcích (tzv. direct threading
+ * s rozšířením „computed goto“), jinde a s makrem `RPN_NO_COMPUTED_GOTO` používá příkaz `switch`.
+ *
+ * Výraz může číst pojmenované vstupní proměnné (`rpn_compile_variables`). Funkce `rpn_execute_batch` pak
+ * vyhodnotí jeden program pro mnoho řádků hodnot proměnných najednou: zpracovává bloky `RPN_BATCH_LANES` řádků
+ * a každou instrukci provede na celém bloku, takže sčítání, odčítání, násobení a dělení použijí operace nad poli
+ * z `operators.h` (s SSE2).
+ *
+ * \version 1.0
+ * \date 2026-10-16
+ */
+
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include <stddef.h>
+
+#include "operators.h"
+#include "stack/stack_typed.h"
+
+/** \brief Typový zásobník operandů, push a pop se přeloží na přímý přístup do pole. */
+STACK_DEFINE(calc_num_type, num_stack)
+
+/** \brief Počet řádků, které dávkové vyhodnocení zpracuje jedním průchodem programu. */
+#define RPN_BATCH_LANES 256
+
+/** \brief Instrukce programu. Pořadí musí odpovídat tabulce návěští v `program.c`. */
+enum rpn_opcode {
+    RPN_OP_PUSH,                    /*!< Vloží `value`. */
+    RPN_OP_LOAD,                    /*!< Vloží hodnotu vstupní proměnné číslo `index`. */
+    RPN_OP_BINARY,                  /*!< Nahradí dva operandy výsledkem `handler`. */
+    RPN_OP_UNARY,                   /*!< Nahradí operand výsledkem `unary_handler`. */
+    RPN_OP_DUP,                     /*!< Zdvojí vrchol zásobníku. */
+    RPN_OP_SWAP,                    /*!< Prohodí dva prvky na vrcholu zásobníku. */
+    RPN_OP_END                      /*!< Vrátí vrchol zásobníku jako výsledek. */
+};
+
+/** \brief Jedna instrukce s předpřipraveným operandem. */
+struct rpn_instruction {
+    const void *address;                    /*!< Návěští instrukce v interpretu, bez computed goto `NULL`. */
+    enum rpn_opcode opcode;                 /*!< Instrukce. */
+    calc_num_type value;                    /*!< Vkládané číslo. */
+    size_t index;                           /*!< Číslo čtené proměnné. */
+    calc_handler_type handler;              /*!< Operace dvou operandů. */
+    calc_unary_handler_type unary_handler;  /*!< Operace jednoho operandu. */
+    calc_vector_handler_type vector_handler;/*!< Operace dvou operandů nad poli, nebo `NULL`. */
+};
+
+/** \brief Přeložený výraz. */
+struct rpn_program {
+    struct rpn_instruction *code;   /*!< Instrukce zakončené `RPN_OP_END`. */
+    size_t length;                  /*!< Počet instrukcí včetně `RPN_OP_END`. */
+    size_t max_depth;               /*!< Největší počet prvků na zásobníku během výpočtu. */
+    size_t num_variables;           /*!< Počet vstupních proměnných, se kterým byl program přeložen. */
+};
+
+/** \brief Inicializátor prázdného programu. */
+#define DEFAULT_RPN_PROGRAM {NULL, 0, 0, 0}
+
+/**
+ * \brief Funkce přeloží výraz do programu. Zápis výrazu popisuje `tokenizer.h`.
+ * \param input Překládaný výraz.
+ * \param prog Ukazatel na program, do kterého bude výsledek uložen. Předchozí obsah se neuvolňuje.
+ * \return int 1, pokud je výraz správně zapsaný a program byl vytvořen, jinak 0 (program pak zůstane prázdný).
+ */
+int rpn_compile(const char *input, struct rpn_program *prog);
+
+/**
+ * \brief Funkce přeloží výraz se vstupními proměnnými. Slovo výrazu, které není operací, musí být jménem
+ *        některé z proměnných, např. `x y * 2 +` se jmény `{"x", "y"}`.
+ * \param input Překládaný výraz.
+ * \param names Jména proměnných, proměnná `k` je při výpočtu `variables[k]`, resp. `columns[k]`.
+ * \param num_names Počet proměnných.
+ * \param prog Ukazatel na program, do kterého bude výsledek uložen. Předchozí obsah se neuvolňuje.
+ * \return int 1, pokud je výraz správně zapsaný a program byl vytvořen, jinak 0 (program pak zůstane prázdný).
+ */
+int rpn_compile_variables(const char *input, const char *const *names, size_t num_names,
+                          struct rpn_program *prog);
+
+/**
+ * \brief Funkce vykoná přeložený program.
+ * \param prog Program vytvořený funkcí `rpn_compile`.
+ * \param stack Zásobník, na kterém výpočet probíhá. Jeho kapacita se zvětší na `prog->max_depth`, pokud je
+ *        menší, a jeho obsah se přepíše. Jeden zásobník lze použít pro libovolně mnoho výpočtů.
+ * \param result Ukazatel na paměť, kam bude zkopírován výsledek výrazu.
+ * \return int 1, pokud výpočet proběhl, 0 pro prázdný program nebo při chybě alokace zásobníku.
+ */
+int rpn_execute(const struct rpn_program *prog, struct num_stack *stack, calc_num_type *result);
+
+/**
+ * \brief Funkce vykoná přeložený program s danými hodnotami vstupních proměnných.
+ * \param prog Program vytvořený funkcí `rpn_compile_variables`.
+ * \param stack Zásobník, na kterém výpočet probíhá (viz `rpn_execute`).
+ * \param variables Hodnoty `prog->num_variables` proměnných, bez proměnných může být `NULL`.
+ * \param result Ukazatel na paměť, kam bude zkopírován výsledek výrazu.
+ * \return int 1, pokud výpočet proběhl, jinak 0.
+ */
+int rpn_execute_variables(const struct rpn_program *prog, struct num_stack *stack,
+                          const calc_num_type *variables, calc_num_type *result);
+
+/**
+ * \brief Funkce vyhodnotí program pro `rows` řádků hodnot proměnných. Hodnoty se předávají po sloupcích, tedy
+ *        jedno pole pro každou proměnnou, což je i pořadí, ve kterém výpočet po blocích řádků probíhá. Výsledky
+ *        jsou shodné s voláním `rpn_execute_variables` pro každý řádek.
+ * \param prog Program vytvořený funkcí `rpn_compile_variables`.
+ * \param columns Pole `prog->num_variables` ukazatelů na sloupce, hodnota proměnné `k` v řádku `i` je
+ *        `columns[k][i]`; bez proměnných může být `NULL`.
+ * \param rows Počet řádků.
+ * \param results Pole `rows` výsledků.
+ * \return int 1, pokud výpočet proběhl, 0 pro prázdný program nebo při chybě alokace. Pracovní paměť má
+ *         `prog->max_depth * RPN_BATCH_LANES` čísel a je alokována jednou na volání.
+ */
+int rpn_execute_batch(const struct rpn_program *prog, const calc_num_type *const *columns, size_t rows,
+                      calc_num_type *results);
+
+/**
+ * \brief Funkce uvolní instrukce programu, program pak zůstane prázdný.
+ * \param prog Ukazatel na uvolňovaný program.
+ */
+void rpn_program_free(struct rpn_program *prog);
+
+#endif
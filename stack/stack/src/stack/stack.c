@@ -11,7 +11,7 @@ struct stack *stack_alloc(const size_t capacity, const size_t item_size) {
         return NULL;
     }
 
-    new_stack == malloc(sizeof(struct stack));
+    new_stack = malloc(sizeof(struct stack));
     if (!new_stack) {
         return NULL;
     }
@@ -32,6 +32,7 @@ int stack_init(struct stack *s, const size_t capacity, const size_t item_size) {
     s->capacity = capacity;
     s->item_size = item_size;
     s->sp = 0;
+    s->external = 0;
 
     s->items = malloc(capacity * item_size);
     if (!s->items) {
@@ -41,18 +42,72 @@ int stack_init(struct stack *s, const size_t capacity, const size_t item_size) {
     return 1;
 }
 
+int stack_init_buffer(struct stack *s, void *buffer, const size_t capacity, const size_t item_size) {
+    if (!s || !buffer || capacity == 0 || item_size == 0) {
+        return 0;
+    }
+
+    s->capacity = capacity;
+    s->item_size = item_size;
+    s->sp = 0;
+    s->items = buffer;
+    s->external = 1;
+
+    return 1;
+}
+
+int stack_reserve(struct stack *s, const size_t capacity) {
+    void *items;
+
+    if (!s || !s->items) {
+        return 0;
+    }
+
+    if (capacity <= s->capacity) {
+        return 1;
+    }
+
+    /* Cizí buffer nelze předat funkci realloc, obsah se musí zkopírovat. */
+    if (s->external) {
+        items = malloc(capacity * s->item_size);
+        if (items) {
+            memcpy(items, s->items, s->sp * s->item_size);
+        }
+    }
+    else {
+        items = realloc(s->items, capacity * s->item_size);
+    }
+
+    if (!items) {
+        return 0;
+    }
+
+    s->items = items;
+    s->capacity = capacity;
+    s->external = 0;
+    return 1;
+}
+
+void stack_clear(struct stack *s) {
+    if (s) {
+        s->sp = 0;
+    }
+}
+
 void stack_deinit(struct stack *s) {
     if (!s) {
         return;
     }
 
-    if(!s->items) {
+    if (!s->external) {
         free(s->items);
     }
 
     s->capacity = 0;
     s->item_size = 0;
     s->sp = 0;
+    s->items = NULL;
+    s->external = 0;
 }
 
 void stack_dealloc(struct stack **s) {
@@ -67,9 +122,7 @@ void stack_dealloc(struct stack **s) {
 }
 
 int stack_push(struct stack *s, const void *item) {
-    size_t i;
-
-    if (s->sp == s->capacity || s->items || !item) {
+    if (!s || !s->items || !item || s->sp == s->capacity) {
         return 0;
     }
 
@@ -81,7 +134,7 @@ int stack_push(struct stack *s, const void *item) {
 }
 
 int stack_pop(struct stack *s, void *item) {
-    if (!s) {
+    if (stack_item_count(s) == 0) {
         return 0;
     }
 
@@ -107,4 +160,6 @@ size_t stack_item_count(const struct stack *s) {
     if (!s) {
         return 0;
     }
+
+    return s->sp;
 }
\ No newline at end of file
@@ -17,9 +17,10 @@ struct stack {
     size_t item_size;
     size_t sp;
     void *items;
+    int external;   /*!< Nenulové, pokud `items` ukazuje do paměti, kterou zásobník nevlastní (viz `stack_init_buffer`). */
 };
 
-#define DEFAULT_STACK {0, 0, 0, NULL}
+#define DEFAULT_STACK {0, 0, 0, NULL, 0}
 
 /**
  * \brief Funkce dynamicky alokuje instanci struktury `stack`, kterou inicializuje pomocí funkce `stack_init`.
@@ -38,6 +39,33 @@ struct stack *stack_alloc(const size_t capacity, const size_t item_size);
  */
 int stack_init(struct stack *s, const size_t capacity, const size_t item_size);
 
+/**
+ * \brief Funkce inicializuje instanci struktury `stack` nad pamětí volajícího (např. polem na zásobníku volání),
+ *        inicializace tedy nic nealokuje. Buffer zásobník nevlastní a funkce `stack_deinit` jej neuvolní.
+ * \param s Ukazatel na inicializovanou instanci struktury `stack`.
+ * \param buffer Paměť pro alespoň `capacity` prvků, musí být platná po celou dobu používání zásobníku.
+ * \param capacity Počet prvků, které se do bufferu vejdou.
+ * \param item_size Velikost jednoho prvku zásobníku.
+ * \return int 1, pokud inicializace zásobníku proběhla v pořádku, jinak 0.
+ */
+int stack_init_buffer(struct stack *s, void *buffer, const size_t capacity, const size_t item_size);
+
+/**
+ * \brief Funkce zajistí, že se do zásobníku vejde alespoň `capacity` prvků. Menší požadavek nic nedělá, kapacita
+ *        se nikdy nezmenšuje. Při zvětšení zásobníku s cizím bufferem se prvky zkopírují do nově alokované paměti,
+ *        kterou už zásobník vlastní.
+ * \param s Ukazatel na inicializovanou instanci struktury `stack`.
+ * \param capacity Požadovaný počet prvků.
+ * \return int 1, pokud má zásobník požadovanou kapacitu, 0 při chybě alokace (zásobník zůstane beze změny).
+ */
+int stack_reserve(struct stack *s, const size_t capacity);
+
+/**
+ * \brief Funkce odebere ze zásobníku všechny prvky, paměť zásobníku ale ponechá pro další použití.
+ * \param s Ukazatel na instanci struktury `stack`.
+ */
+void stack_clear(struct stack *s);
+
 /**
  * \brief Funkce provede korektní uvolnění členů instance struktury `stack`.
  * \param s Ukazatel na instanci struktury `stack` jejichž členy budou korektně uvolněny.
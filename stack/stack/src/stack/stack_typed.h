@@ -0,0 +1,163 @@
+/**
+ * \file stack_typed.h
+ * \author Jiří Joska (github.com/toyotomicz)
+ * \brief Hlavičkový soubor s makry, která generují zásobníky pro konkrétní datový typ.
+ *
+ * Zásobník ze `stack.h` ukládá prvky libovolné velikosti, a proto každý prvek kopíruje funkcí `memcpy` podle
+ * velikosti známé až za běhu. Makro `STACK_DEFINE(type, name)` vygeneruje strukturu `struct name` s polem prvků
+ * typu `type` a k ní funkce `name_push`, `name_pop` apod., které pracují s hodnotami. Všechny funkce jsou
+ * statické a vkládané (inline), překladač je tedy může rozvinout do místa volání a vrchol zásobníku držet
+ * v registrech. Pro prvky, jejichž typ není v době překladu známý, zůstává obecný zásobník ze `stack.h`.
+ *
+ * Použití:
+ * \code
+ * STACK_DEFINE(int, istack)
+ *
+ * struct istack s;
+ * istack_init(&s, 16);
+ * istack_push(&s, 42);
+ * \endcode
+ *
+ * \version 1.0
+ * \date 2026-10-16
+ */
+
+#ifndef STACK_TYPED_H
+#define STACK_TYPED_H
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief Specifikátor generovaných funkcí. Norma ANSI C klíčové slovo `inline` nezná, GCC a Clang ale i v režimu
+ *        `-ansi` přijímají `__inline__`. Ostatní překladače dostanou obyčejné statické funkce.
+ */
+#if defined(__GNUC__)
+#define STACK_INLINE static __inline__
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define STACK_INLINE static inline
+#else
+#define STACK_INLINE static
+#endif
+
+/**
+ * \brief Makro vygeneruje zásobník prvků typu `type` se jménem `name`. Funkce mají stejný význam a návratové
+ *        hodnoty jako jejich protějšky ze `stack.h`, jen prvky předávají hodnotou místo ukazatelem:
+ *        - `name_init(s, capacity)` alokuje pole pro `capacity` prvků,
+ *        - `name_init_buffer(s, buffer, capacity)` použije pole volajícího, které zásobník neuvolní,
+ *        - `name_reserve(s, capacity)` zvětší kapacitu, `name_clear(s)` zásobník vyprázdní,
+ *        - `name_push(s, value)`, `name_pop(s, &value)` a `name_head(s, &value)`,
+ *        - `name_count(s)` vrátí počet prvků, `name_deinit(s)` uvolní vlastněnou paměť.
+ *
+ *        Makro se v jednom překladovém souboru smí pro dané `name` použít jen jednou. Typ musí jít přiřadit
+ *        operátorem `=`.
+ */
+#define STACK_DEFINE(type, name)                                                    \
+    struct name {                                                                   \
+        size_t capacity;    /*!< Maximální počet prvků. */                          \
+        size_t sp;          /*!< Počet prvků na zásobníku. */                       \
+        type *items;        /*!< Pole prvků. */                                     \
+        int external;       /*!< Nenulové, pokud pole nepatří zásobníku. */         \
+    };                                                                              \
+                                                                                    \
+    STACK_INLINE int name##_init(struct name *s, size_t capacity) {                 \
+        if (!s || capacity == 0) {                                                  \
+            return 0;                                                               \
+        }                                                                           \
+        s->items = (type *)malloc(capacity * sizeof(type));                         \
+        if (!s->items) {                                                            \
+            return 0;                                                               \
+        }                                                                           \
+        s->capacity = capacity;                                                     \
+        s->sp = 0;                                                                  \
+        s->external = 0;                                                            \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_init_buffer(struct name *s, type *buffer,               \
+                                        size_t capacity) {                          \
+        if (!s || !buffer || capacity == 0) {                                       \
+            return 0;                                                               \
+        }                                                                           \
+        s->items = buffer;                                                          \
+        s->capacity = capacity;                                                     \
+        s->sp = 0;                                                                  \
+        s->external = 1;                                                            \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE void name##_deinit(struct name *s) {                               \
+        if (!s) {                                                                   \
+            return;                                                                 \
+        }                                                                           \
+        if (!s->external) {                                                         \
+            free(s->items);                                                         \
+        }                                                                           \
+        s->items = NULL;                                                            \
+        s->capacity = 0;                                                            \
+        s->sp = 0;                                                                  \
+        s->external = 0;                                                            \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_reserve(struct name *s, size_t capacity) {              \
+        type *items;                                                                \
+        if (!s || !s->items) {                                                      \
+            return 0;                                                               \
+        }                                                                           \
+        if (capacity <= s->capacity) {                                              \
+            return 1;                                                               \
+        }                                                                           \
+        if (s->external) {                                                          \
+            items = (type *)malloc(capacity * sizeof(type));                        \
+            if (items) {                                                            \
+                memcpy(items, s->items, s->sp * sizeof(type));                      \
+            }                                                                       \
+        }                                                                           \
+        else {                                                                      \
+            items = (type *)realloc(s->items, capacity * sizeof(type));             \
+        }                                                                           \
+        if (!items) {                                                               \
+            return 0;                                                               \
+        }                                                                           \
+        s->items = items;                                                           \
+        s->capacity = capacity;                                                     \
+        s->external = 0;                                                            \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE void name##_clear(struct name *s) {                                \
+        s->sp = 0;                                                                  \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE size_t name##_count(const struct name *s) {                        \
+        return s->sp;                                                               \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_push(struct name *s, type value) {                      \
+        if (s->sp == s->capacity) {                                                 \
+            return 0;                                                               \
+        }                                                                           \
+        s->items[s->sp++] = value;                                                  \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_pop(struct name *s, type *value) {                      \
+        if (s->sp == 0) {                                                           \
+            return 0;                                                               \
+        }                                                                           \
+        s->sp--;                                                                    \
+        if (value) {                                                                \
+            *value = s->items[s->sp];                                               \
+        }                                                                           \
+        return 1;                                                                   \
+    }                                                                               \
+                                                                                    \
+    STACK_INLINE int name##_head(const struct name *s, type *value) {               \
+        if (s->sp == 0 || !value) {                                                 \
+            return 0;                                                               \
+        }                                                                           \
+        *value = s->items[s->sp - 1];                                               \
+        return 1;                                                                   \
+    }
+
+#endif
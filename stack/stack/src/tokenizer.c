@@ -0,0 +1,146 @@
+/**
+ * @file tokenizer.c
+ * @author Jiří Joska (github.com/toyotomicz)
+ * @brief Zdrojový kód lexikálního analyzátoru (tokenizéru) výrazů v reverzní polské notaci.
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+#include <stdlib.h>
+
+#include "tokenizer.h"
+
+/** @brief Nejdelší celé číslo, které se dá převést sčítáním číslic bez zaokrouhlení (2^53 má 16 číslic). */
+#define EXACT_DIGITS 15
+
+/** @brief Bílé znaky oddělující tokeny. Funkce `isspace` závisí na locale, a proto se nepoužívá. */
+#define IS_SPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r' || (c) == '\v' || (c) == '\f')
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+#define IS_LETTER(c) (((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z'))
+
+/**
+ * @brief Za číslem a slovem musí následovat bílý znak, konec výrazu nebo operátor ze symbolu. Jinak by se
+ *        např. `1.2.3` nebo `2sqrt` tiše rozdělilo na dva tokeny.
+ */
+#define IS_DELIMITER(c) ((c) == '\000' || IS_SPACE(c) || (c) == '+' || (c) == '-' || (c) == '*' || (c) == '/')
+
+/**
+ * @brief Funkce přečte číslo začínající na pozici `start`.
+ * @param start Začátek čísla, může začínat znaménkem.
+ * @param end Ukazatel, kam bude uložen první znak za číslem.
+ * @param value Ukazatel, kam bude uložena hodnota čísla.
+ * @return int 1, pokud je číslo zapsáno správně, jinak 0.
+ */
+static int scan_number(const char *start, const char **end, calc_num_type *value) {
+    const char *p = start;
+    size_t digits = 0;
+    int fraction = 0, exponent = 0;
+    double integer = 0;
+
+    if (*p == '+' || *p == '-') {
+        ++p;
+    }
+
+    for (; IS_DIGIT(*p); ++p, ++digits) {
+        integer = integer * 10 + (*p - '0');
+    }
+
+    if (*p == '.') {
+        fraction = 1;
+        for (++p; IS_DIGIT(*p); ++p) {
+            ++digits;
+        }
+    }
+
+    if (digits == 0) {
+        return 0;
+    }
+
+    if (*p == 'e' || *p == 'E') {
+        exponent = 1;
+        ++p;
+        if (*p == '+' || *p == '-') {
+            ++p;
+        }
+        if (!IS_DIGIT(*p)) {
+            return 0;
+        }
+        while (IS_DIGIT(*p)) {
+            ++p;
+        }
+    }
+
+    if (!IS_DELIMITER(*p)) {
+        return 0;
+    }
+    *end = p;
+
+    /* Krátká celá čísla jsou převedena přesně už při čtení, ostatní převede knihovna. */
+    if (!fraction && !exponent && digits <= EXACT_DIGITS) {
+        *value = (*start == '-') ? -integer : integer;
+    }
+    else {
+        *value = strtod(start, NULL);
+    }
+
+    return 1;
+}
+
+void tokenizer_init(struct tokenizer *t, const char *input) {
+    t->input = input;
+    t->cursor = input;
+}
+
+enum token_type tokenizer_next(struct tokenizer *t, struct token *token) {
+    const char *p = t->cursor;
+    const char *end = p;
+    int sign;
+
+    while (IS_SPACE(*p)) {
+        ++p;
+    }
+
+    token->start = p;
+    token->length = 0;
+    token->value = 0;
+    token->oper = NULL;
+    token->type = TOKEN_ERROR;
+
+    /* Znaménko na začátku tokenu, za kterým následuje číslice. */
+    sign = (*p == '-' || *p == '+') && (p == t->input || IS_SPACE(p[-1])) &&
+           (IS_DIGIT(p[1]) || (p[1] == '.' && IS_DIGIT(p[2])));
+
+    if (*p == '\000') {
+        token->type = TOKEN_END;
+    }
+    else if (IS_DIGIT(*p) || *p == '.' || sign) {
+        if (scan_number(p, &end, &token->value)) {
+            token->type = TOKEN_NUMBER;
+        }
+    }
+    else if (IS_LETTER(*p)) {
+        for (end = p; IS_LETTER(*end); ++end) {
+            /* Slovo končí prvním znakem, který není písmeno. */
+        }
+        if (IS_DELIMITER(*end)) {
+            token->oper = find_operator(p, (size_t)(end - p));
+            token->type = token->oper ? TOKEN_OPERATOR : TOKEN_NAME;
+        }
+    }
+    else {
+        end = p + 1;
+        token->oper = find_operator(p, 1);
+        if (token->oper) {
+            token->type = TOKEN_OPERATOR;
+        }
+    }
+
+    /* Na chybě se tokenizér zastaví, další volání ji ohlásí znovu. */
+    if (token->type == TOKEN_ERROR || token->type == TOKEN_END) {
+        end = p;
+    }
+
+    token->length = (size_t)(end - p);
+    t->cursor = end;
+    return token->type;
+}
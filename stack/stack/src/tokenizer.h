@@ -0,0 +1,67 @@
+/**
+ * \file tokenizer.h
+ * \author Jiří Joska (github.com/toyotomicz)
+ * \brief Hlavičkový soubor lexikálního analyzátoru (tokenizéru) výrazů v reverzní polské notaci.
+ *
+ * Tokenizér čte výraz v jednom průchodu zleva doprava a nic nealokuje. Token jen ukazuje do vstupního řetězce,
+ * který proto musí existovat po celou dobu zpracování.
+ *
+ * Zápis výrazu:
+ * - čísla jako `42`, `-7`, `3.25`, `.5` nebo `6.02e23`; znaménko patří k číslu, jen pokud mu předchází bílý
+ *   znak nebo začátek výrazu (`5 -3 +` je 2, kdežto `5 3-` je rozdíl),
+ * - operátory `+`, `-`, `*`, `/` a slova `pow`, `sqrt`, `dup`, `swap` (viz pole OPERATORS),
+ * - ostatní slova jsou jména (např. vstupních proměnných, viz `program.h`),
+ * - čísla a slova se oddělují bílými znaky, operátor ze symbolu oddělovat není potřeba (`1 2+`).
+ *
+ * \version 1.0
+ * \date 2026-10-16
+ */
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <stddef.h>
+
+#include "operators.h"
+
+/** \brief Druhy tokenů. */
+enum token_type {
+    TOKEN_END,                      /*!< Konec výrazu. */
+    TOKEN_NUMBER,                   /*!< Číselný literál, hodnota je ve `value`. */
+    TOKEN_OPERATOR,                 /*!< Operace, její popis je v `oper`. */
+    TOKEN_NAME,                     /*!< Slovo, které není operací, je dáno `start` a `length`. */
+    TOKEN_ERROR                     /*!< Nepovolený znak nebo chybně zapsané číslo či slovo. */
+};
+
+/** \brief Jeden token výrazu. */
+struct token {
+    enum token_type type;                   /*!< Druh tokenu. */
+    calc_num_type value;                    /*!< Hodnota čísla. */
+    const struct calc_oper_type *oper;      /*!< Operace. */
+    const char *start;                      /*!< Začátek tokenu ve vstupu. */
+    size_t length;                          /*!< Délka tokenu ve vstupu. */
+};
+
+/** \brief Stav tokenizéru, tedy pozice ve zpracovávaném výrazu. */
+struct tokenizer {
+    const char *input;              /*!< Začátek výrazu. */
+    const char *cursor;             /*!< První dosud nepřečtený znak. */
+};
+
+/**
+ * \brief Funkce připraví tokenizér ke čtení výrazu `input` od začátku.
+ * \param t Ukazatel na inicializovaný tokenizér.
+ * \param input Výraz ukončený nulovým znakem.
+ */
+void tokenizer_init(struct tokenizer *t, const char *input);
+
+/**
+ * \brief Funkce přečte další token výrazu. Po tokenu `TOKEN_END` nebo `TOKEN_ERROR` už další volání vrací
+ *        stále tentýž druh tokenu.
+ * \param t Ukazatel na tokenizér.
+ * \param token Ukazatel na strukturu, kam bude token uložen.
+ * \return enum token_type Druh přečteného tokenu.
+ */
+enum token_type tokenizer_next(struct tokenizer *t, struct token *token);
+
+#endif